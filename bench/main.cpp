@@ -0,0 +1,733 @@
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <Accumulator.hpp>
+#include <Batch.hpp>
+#include <BigInteger.hpp>
+#include <Decimal.hpp>
+#include <Expression.hpp>
+#include <FixedBigInteger.hpp>
+#include <FixedInteger.hpp>
+#include <ModContext.hpp>
+#include <NumberTheory.hpp>
+#include <Serialization.hpp>
+
+// Performance suite of the library. Every benchmark takes the operand length in decimal digits,
+// sizes go from a single digit to ten million digits in powers of ten.
+// Results of two commits are compared by writing JSON with
+// --benchmark_out=result.json --benchmark_out_format=json and running compare.py of Google Benchmark.
+
+namespace {
+using apmath::BigInteger;
+using namespace apmath::literals;
+
+constexpr int64_t MinDigits = 1;
+constexpr int64_t MaxDigits = 10000000;
+constexpr int64_t BatchSize = 1000;
+
+std::string randomDigits(std::size_t count, std::uint64_t seed) {
+    std::mt19937_64 generator(seed);
+    std::string digits(count, '0');
+    for (auto& digit: digits) {
+        digit = static_cast<char>('0' + generator() % 10);
+    }
+    digits[0] = static_cast<char>('1' + generator() % 9);
+    return digits;
+}
+
+// Parsing ten million digits takes a while, so operands are built once per size and seed
+const BigInteger& randomNumber(std::size_t digits, std::uint64_t seed = 1) {
+    static std::map<std::pair<std::size_t, std::uint64_t>, BigInteger> cache;
+    auto key = std::make_pair(digits, seed);
+    auto found = cache.find(key);
+    if (found == cache.end()) {
+        found = cache.emplace(key, BigInteger(randomDigits(digits, seed))).first;
+    }
+    return found->second;
+}
+
+// 99...9, every addition of one carries through all limbs, like ManyNines of the unit tests
+const BigInteger& manyNines(std::size_t digits) {
+    static std::map<std::size_t, BigInteger> cache;
+    auto found = cache.find(digits);
+    if (found == cache.end()) {
+        found = cache.emplace(digits, BigInteger(std::string(digits, '9'))).first;
+    }
+    return found->second;
+}
+
+std::size_t digitsOf(const benchmark::State& state) {
+    return static_cast<std::size_t>(state.range(0));
+}
+
+void setDigitsProcessed(benchmark::State& state) {
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void parse(benchmark::State& state) {
+    std::string digits = randomDigits(digitsOf(state), 1);
+    for (auto _: state) {
+        BigInteger value(digits);
+        benchmark::DoNotOptimize(value);
+    }
+    setDigitsProcessed(state);
+}
+
+void toString(benchmark::State& state) {
+    const BigInteger& value = randomNumber(digitsOf(state));
+    for (auto _: state) {
+        std::string digits = value.toString();
+        benchmark::DoNotOptimize(digits);
+    }
+    setDigitsProcessed(state);
+}
+
+void streamInput(benchmark::State& state) {
+    std::string digits = randomDigits(digitsOf(state), 1);
+    for (auto _: state) {
+        std::istringstream in(digits);
+        BigInteger value;
+        in >> value;
+        benchmark::DoNotOptimize(value);
+    }
+    setDigitsProcessed(state);
+}
+
+void streamOutput(benchmark::State& state) {
+    const BigInteger& value = randomNumber(digitsOf(state));
+    for (auto _: state) {
+        std::ostringstream out;
+        out << value;
+        benchmark::DoNotOptimize(out);
+    }
+    setDigitsProcessed(state);
+}
+
+void toChars(benchmark::State& state) {
+    const BigInteger& value = randomNumber(digitsOf(state));
+    std::vector<char> buffer(value.decimalLengthBound());
+    for (auto _: state) {
+        std::to_chars_result result = apmath::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+        benchmark::DoNotOptimize(result);
+    }
+    setDigitsProcessed(state);
+}
+
+void serialize(benchmark::State& state) {
+    const BigInteger& value = randomNumber(digitsOf(state));
+    std::vector<std::uint8_t> bytes;
+    for (auto _: state) {
+        bytes.clear();
+        apmath::serialize(value, bytes);
+        benchmark::DoNotOptimize(bytes.data());
+    }
+    setDigitsProcessed(state);
+}
+
+void deserialize(benchmark::State& state) {
+    std::vector<std::uint8_t> bytes;
+    apmath::serialize(randomNumber(digitsOf(state)), bytes);
+    BigInteger value;
+    for (auto _: state) {
+        apmath::deserialize(bytes.data(), bytes.size(), value);
+        benchmark::DoNotOptimize(value);
+    }
+    setDigitsProcessed(state);
+}
+
+// With SharedLimbs copies share the limbs and the first write to a copy pays for copying them
+void copy(benchmark::State& state) {
+    const BigInteger& a = randomNumber(digitsOf(state), 1);
+    for (auto _: state) {
+        BigInteger copy = a;
+        benchmark::DoNotOptimize(copy);
+    }
+}
+
+void copyAndIncrement(benchmark::State& state) {
+    const BigInteger& a = randomNumber(digitsOf(state), 1);
+    for (auto _: state) {
+        BigInteger copy = a;
+        ++copy;
+        benchmark::DoNotOptimize(copy);
+    }
+}
+
+void add(benchmark::State& state) {
+    const BigInteger& a = randomNumber(digitsOf(state), 1);
+    const BigInteger& b = randomNumber(digitsOf(state), 2);
+    for (auto _: state) {
+        BigInteger sum = a + b;
+        benchmark::DoNotOptimize(sum);
+    }
+    setDigitsProcessed(state);
+}
+
+// The sum is updated in place, so no limbs are allocated
+void addInPlace(benchmark::State& state) {
+    BigInteger sum = randomNumber(digitsOf(state), 1);
+    const BigInteger& b = randomNumber(digitsOf(state), 2);
+    for (auto _: state) {
+        sum += b;
+        sum -= b;
+        benchmark::DoNotOptimize(sum);
+    }
+    setDigitsProcessed(state);
+}
+
+// Multiply-accumulate of a product of two operands into a reserved accumulator,
+// in place and with a temporary product
+void addMultiply(benchmark::State& state) {
+    const BigInteger& a = randomNumber(digitsOf(state), 1);
+    const BigInteger& b = randomNumber(digitsOf(state), 2);
+    BigInteger sum = 0;
+    sum.reserve(8 * a.bitLength());
+    for (auto _: state) {
+        sum.addMultiply(a, b);
+        sum.subtractMultiply(a, b);
+        benchmark::DoNotOptimize(sum);
+    }
+    setDigitsProcessed(state);
+}
+
+void addProduct(benchmark::State& state) {
+    const BigInteger& a = randomNumber(digitsOf(state), 1);
+    const BigInteger& b = randomNumber(digitsOf(state), 2);
+    BigInteger sum = 0;
+    sum.reserve(8 * a.bitLength());
+    for (auto _: state) {
+        sum += a * b;
+        sum -= a * b;
+        benchmark::DoNotOptimize(sum);
+    }
+    setDigitsProcessed(state);
+}
+
+// 99...9 + 1 and back, carries and borrows run through all limbs
+void addCarryChain(benchmark::State& state) {
+    BigInteger value = manyNines(digitsOf(state));
+    BigInteger one(1);
+    for (auto _: state) {
+        value += one;
+        value -= one;
+        benchmark::DoNotOptimize(value);
+    }
+    setDigitsProcessed(state);
+}
+
+void subtract(benchmark::State& state) {
+    const BigInteger& a = randomNumber(digitsOf(state), 1);
+    const BigInteger& b = randomNumber(digitsOf(state), 2);
+    for (auto _: state) {
+        BigInteger difference = a - b;
+        benchmark::DoNotOptimize(difference);
+    }
+    setDigitsProcessed(state);
+}
+
+// Operands of different signs and close magnitudes: addition turns into subtraction
+// with a result much shorter than the operands
+void addMixedSigns(benchmark::State& state) {
+    const BigInteger& a = manyNines(digitsOf(state));
+    BigInteger b = -(a - 1);
+    for (auto _: state) {
+        BigInteger sum = a + b;
+        benchmark::DoNotOptimize(sum);
+    }
+    setDigitsProcessed(state);
+}
+
+// Equal values differ nowhere, so every limb is compared
+void compare(benchmark::State& state) {
+    const BigInteger& a = randomNumber(digitsOf(state));
+    BigInteger b = a;
+    for (auto _: state) {
+        benchmark::DoNotOptimize(a < b);
+    }
+    setDigitsProcessed(state);
+}
+
+void hash(benchmark::State& state) {
+    const BigInteger& a = randomNumber(digitsOf(state));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(a.hash());
+    }
+    setDigitsProcessed(state);
+}
+
+void increment(benchmark::State& state) {
+    BigInteger value = randomNumber(digitsOf(state));
+    for (auto _: state) {
+        ++value;
+        benchmark::DoNotOptimize(value);
+    }
+}
+
+void incrementCarryChain(benchmark::State& state) {
+    BigInteger value = manyNines(digitsOf(state));
+    for (auto _: state) {
+        ++value;
+        --value;
+        benchmark::DoNotOptimize(value);
+    }
+    setDigitsProcessed(state);
+}
+
+void addNative(benchmark::State& state) {
+    BigInteger value = randomNumber(digitsOf(state));
+    for (auto _: state) {
+        value += INT64_MAX;
+        value -= INT64_MAX;
+        benchmark::DoNotOptimize(value);
+    }
+}
+
+void multiplyNative(benchmark::State& state) {
+    const BigInteger& value = randomNumber(digitsOf(state));
+    for (auto _: state) {
+        BigInteger product = value * -1000000007;
+        benchmark::DoNotOptimize(product);
+    }
+    setDigitsProcessed(state);
+}
+
+void multiply(benchmark::State& state) {
+    const BigInteger& a = randomNumber(digitsOf(state), 1);
+    const BigInteger& b = randomNumber(digitsOf(state), 2);
+    for (auto _: state) {
+        BigInteger product = a * b;
+        benchmark::DoNotOptimize(product);
+    }
+    setDigitsProcessed(state);
+}
+
+void square(benchmark::State& state) {
+    const BigInteger& a = randomNumber(digitsOf(state));
+    for (auto _: state) {
+        BigInteger product = a * a;
+        benchmark::DoNotOptimize(product);
+    }
+    setDigitsProcessed(state);
+}
+
+// A dividend of twice the digits of the divisor, the quotient is as long as the divisor
+void divide(benchmark::State& state) {
+    const BigInteger& a = randomNumber(2 * digitsOf(state), 1);
+    const BigInteger& b = randomNumber(digitsOf(state), 2);
+    for (auto _: state) {
+        BigInteger quotient = a / b;
+        benchmark::DoNotOptimize(quotient);
+    }
+    setDigitsProcessed(state);
+}
+
+void modulo(benchmark::State& state) {
+    const BigInteger& a = randomNumber(2 * digitsOf(state), 1);
+    const BigInteger& b = randomNumber(digitsOf(state), 2);
+    for (auto _: state) {
+        BigInteger remainder = a % b;
+        benchmark::DoNotOptimize(remainder);
+    }
+    setDigitsProcessed(state);
+}
+
+void bitwiseAnd(benchmark::State& state) {
+    const BigInteger& a = randomNumber(digitsOf(state), 1);
+    const BigInteger& b = randomNumber(digitsOf(state), 2);
+    for (auto _: state) {
+        BigInteger result = a & b;
+        benchmark::DoNotOptimize(result);
+    }
+    setDigitsProcessed(state);
+}
+
+// The negative operand is complemented on the fly and so is the negative result
+void bitwiseMixedSigns(benchmark::State& state) {
+    const BigInteger& a = randomNumber(digitsOf(state), 1);
+    BigInteger b = -randomNumber(digitsOf(state), 2);
+    for (auto _: state) {
+        BigInteger result = a ^ b;
+        benchmark::DoNotOptimize(result);
+    }
+    setDigitsProcessed(state);
+}
+
+void shiftRight(benchmark::State& state) {
+    const BigInteger& a = randomNumber(digitsOf(state));
+    for (auto _: state) {
+        BigInteger result = a >> 77;
+        benchmark::DoNotOptimize(result);
+    }
+    setDigitsProcessed(state);
+}
+
+void lazySum(benchmark::State& state) {
+    const BigInteger& a = randomNumber(digitsOf(state), 1);
+    const BigInteger& b = randomNumber(digitsOf(state), 2);
+    const BigInteger& c = randomNumber(digitsOf(state), 3);
+    const BigInteger& d = randomNumber(digitsOf(state), 4);
+    for (auto _: state) {
+        BigInteger sum = apmath::lazy(a) + b - c + d;
+        benchmark::DoNotOptimize(sum);
+    }
+    setDigitsProcessed(state);
+}
+
+// An 80-digit constant parsed at runtime against the same one parsed at compile time
+void constantFromString(benchmark::State& state) {
+    for (auto _: state) {
+        BigInteger value("12345678901234567890123456789012345678901234567890123456789012345678901234567890");
+        benchmark::DoNotOptimize(value);
+    }
+}
+
+void constantFromLiteral(benchmark::State& state) {
+    for (auto _: state) {
+        BigInteger value = 12345678901234567890123456789012345678901234567890123456789012345678901234567890_big;
+        benchmark::DoNotOptimize(value);
+    }
+}
+
+void fixedMultiply(benchmark::State& state) {
+    apmath::FixedBigInteger<512> a(randomDigits(75, 1));
+    apmath::FixedBigInteger<512> b(randomDigits(75, 2));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(a);
+        apmath::FixedBigInteger<512> product = a * b;
+        benchmark::DoNotOptimize(product);
+    }
+}
+
+// 256-bit operands in the fixed-width type against the same values in BigInteger
+void uint256Add(benchmark::State& state) {
+    apmath::uint256 a = BigInteger(randomDigits(76, 1));
+    apmath::uint256 b = BigInteger(randomDigits(76, 2));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(a);
+        apmath::uint256 sum = a + b;
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+void uint256Multiply(benchmark::State& state) {
+    apmath::uint256 a = BigInteger(randomDigits(76, 1));
+    apmath::uint256 b = BigInteger(randomDigits(76, 2));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(a);
+        apmath::uint256 product = a * b;
+        benchmark::DoNotOptimize(product);
+    }
+}
+
+void bigInteger256Add(benchmark::State& state) {
+    BigInteger a(randomDigits(76, 1));
+    BigInteger b(randomDigits(76, 2));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(a);
+        BigInteger sum = a + b;
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+void bigInteger256Multiply(benchmark::State& state) {
+    BigInteger a(randomDigits(76, 1));
+    BigInteger b(randomDigits(76, 2));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(a);
+        BigInteger product = a * b;
+        benchmark::DoNotOptimize(product);
+    }
+}
+
+// Modular exponentiation with an exponent as long as the odd modulus, like RSA signature verification
+// with the private exponent, against square-and-multiply with BigInteger division
+void powmod(benchmark::State& state) {
+    BigInteger modulus = randomNumber(digitsOf(state), 1) * 2 + 1;
+    const BigInteger& base = randomNumber(digitsOf(state), 2);
+    const BigInteger& exponent = randomNumber(digitsOf(state), 3);
+    for (auto _: state) {
+        apmath::ModContext context(modulus);
+        BigInteger power = context.powmod(base, exponent);
+        benchmark::DoNotOptimize(power);
+    }
+}
+
+void powmodDivision(benchmark::State& state) {
+    BigInteger modulus = randomNumber(digitsOf(state), 1) * 2 + 1;
+    const BigInteger& base = randomNumber(digitsOf(state), 2);
+    const BigInteger& exponent = randomNumber(digitsOf(state), 3);
+    for (auto _: state) {
+        BigInteger power = 1;
+        BigInteger square = base % modulus;
+        for (BigInteger e = exponent; e != 0; e /= 2) {
+            if (e % 2 != 0) {
+                power = power * square % modulus;
+            }
+            square = square * square % modulus;
+        }
+        benchmark::DoNotOptimize(power);
+    }
+}
+
+// Lehmer's gcd against the Euclidean algorithm with a division per step
+void gcd(benchmark::State& state) {
+    const BigInteger& a = randomNumber(digitsOf(state), 1);
+    const BigInteger& b = randomNumber(digitsOf(state), 2);
+    for (auto _: state) {
+        BigInteger divisor = apmath::gcd(a, b);
+        benchmark::DoNotOptimize(divisor);
+    }
+}
+
+void gcdEuclid(benchmark::State& state) {
+    const BigInteger& a = randomNumber(digitsOf(state), 1);
+    const BigInteger& b = randomNumber(digitsOf(state), 2);
+    for (auto _: state) {
+        BigInteger x = a;
+        BigInteger y = b;
+        while (y != 0) {
+            x %= y;
+            std::swap(x, y);
+        }
+        benchmark::DoNotOptimize(x);
+    }
+}
+
+void isqrt(benchmark::State& state) {
+    const BigInteger& a = randomNumber(digitsOf(state), 1);
+    for (auto _: state) {
+        BigInteger root = apmath::isqrt(a);
+        benchmark::DoNotOptimize(root);
+    }
+}
+
+// Baillie-PSW test of a prime, the worst case which runs every step
+void isProbablePrime(benchmark::State& state) {
+    BigInteger prime = randomNumber(digitsOf(state), 1) | 1;
+    while (!apmath::isProbablePrime(prime)) {
+        prime += 2;
+    }
+    for (auto _: state) {
+        bool result = apmath::isProbablePrime(prime);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+// Batches of BatchSize operands with mixed signs
+std::vector<BigInteger> batchOperands(std::size_t digits, std::uint64_t seed) {
+    std::vector<BigInteger> operands;
+    for (std::uint64_t i = 0; i < BatchSize; ++i) {
+        operands.push_back(BigInteger(randomDigits(digits, seed * BatchSize + i)));
+        if (i % 2 == 1) {
+            operands.back() = -operands.back();
+        }
+    }
+    return operands;
+}
+
+void batchMultiply(benchmark::State& state) {
+    std::vector<BigInteger> a = batchOperands(digitsOf(state), 1);
+    std::vector<BigInteger> b = batchOperands(digitsOf(state), 2);
+    std::vector<BigInteger> products(a.size());
+    for (auto _: state) {
+        apmath::batch::multiply(a, b, products);
+        benchmark::DoNotOptimize(products.data());
+    }
+    state.SetItemsProcessed(state.iterations() * BatchSize);
+}
+
+void batchSum(benchmark::State& state) {
+    std::vector<BigInteger> values = batchOperands(digitsOf(state), 1);
+    for (auto _: state) {
+        BigInteger sum = apmath::batch::sum(values);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * BatchSize);
+}
+
+// Running sum of the batch with deferred carries, against repeated operator+=
+void accumulator(benchmark::State& state) {
+    std::vector<BigInteger> values = batchOperands(digitsOf(state), 1);
+    apmath::Accumulator sum;
+    for (auto _: state) {
+        for (const auto& value: values) {
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    benchmark::DoNotOptimize(sum.value());
+    state.SetItemsProcessed(state.iterations() * BatchSize);
+}
+
+void sumByAddition(benchmark::State& state) {
+    std::vector<BigInteger> values = batchOperands(digitsOf(state), 1);
+    BigInteger sum;
+    for (auto _: state) {
+        for (const auto& value: values) {
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * BatchSize);
+}
+
+void batchDot(benchmark::State& state) {
+    std::vector<BigInteger> a = batchOperands(digitsOf(state), 1);
+    std::vector<BigInteger> b = batchOperands(digitsOf(state), 2);
+    for (auto _: state) {
+        BigInteger dot = apmath::batch::dot(a, b);
+        benchmark::DoNotOptimize(dot);
+    }
+    state.SetItemsProcessed(state.iterations() * BatchSize);
+}
+
+// Lookups of BatchSize IDs of 30 digits, the length of the keys of a typical ID map
+void unorderedMapFind(benchmark::State& state) {
+    std::vector<BigInteger> keys = batchOperands(30, 1);
+    std::unordered_map<BigInteger, std::size_t> ids;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        ids[keys[i]] = i;
+    }
+    for (auto _: state) {
+        for (const auto& key: keys) {
+            benchmark::DoNotOptimize(ids.find(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * BatchSize);
+}
+
+// Daily interest on BatchSize balances in cents at a rate with 6 decimals, rounded to cents with banker's rounding
+void decimalInterest(benchmark::State& state) {
+    std::vector<apmath::Decimal> balances;
+    for (const auto& cents: batchOperands(digitsOf(state), 1)) {
+        balances.emplace_back(cents, 2);
+    }
+    const apmath::Decimal rate("0.000137");
+    for (auto _: state) {
+        for (auto& balance: balances) {
+            balance += (balance * rate).rescale(2);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * BatchSize);
+}
+
+// The same interest computed on integer cents by moving the decimal point in text, rounding down
+void decimalInterestByString(benchmark::State& state) {
+    std::vector<BigInteger> balances = batchOperands(digitsOf(state), 1);
+    const BigInteger rate(137);
+    for (auto _: state) {
+        for (auto& balance: balances) {
+            std::string interest = (balance * rate).toString();
+            interest.resize(interest.size() > 6 ? interest.size() - 6 : 0);
+            balance += BigInteger(interest.empty() ? std::string_view("0") : std::string_view(interest));
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * BatchSize);
+}
+
+// Maps a snapshot of the batch and converts every view to BigInteger, the file stays in the page cache
+void snapshotLoad(benchmark::State& state) {
+    std::string path = (std::filesystem::temp_directory_path() / "big-number-bench.snapshot").string();
+    {
+        apmath::SnapshotWriter writer(path);
+        for (const auto& value: batchOperands(digitsOf(state), 1)) {
+            writer.write(value);
+        }
+    }
+    std::vector<BigInteger> values(BatchSize);
+    for (auto _: state) {
+        apmath::SnapshotFile snapshot(path);
+        std::size_t i = 0;
+        for (apmath::BigIntegerView view: snapshot) {
+            values[i++] = view.toBigInteger();
+        }
+        benchmark::DoNotOptimize(values.data());
+    }
+    std::filesystem::remove(path);
+    state.SetItemsProcessed(state.iterations() * BatchSize);
+}
+
+// Product of 1..n, the argument is n
+void factorial(benchmark::State& state) {
+    std::vector<BigInteger> factors;
+    for (int64_t i = 1; i <= state.range(0); ++i) {
+        factors.push_back(i);
+    }
+    for (auto _: state) {
+        BigInteger product = apmath::batch::product(factors);
+        benchmark::DoNotOptimize(product);
+    }
+}
+}
+
+#define APMATH_BENCHMARK_DIGITS(name) \
+    BENCHMARK(name)->RangeMultiplier(10)->Range(MinDigits, MaxDigits)->Unit(benchmark::kMicrosecond)
+
+APMATH_BENCHMARK_DIGITS(parse);
+APMATH_BENCHMARK_DIGITS(toString);
+APMATH_BENCHMARK_DIGITS(streamInput);
+APMATH_BENCHMARK_DIGITS(streamOutput);
+APMATH_BENCHMARK_DIGITS(toChars);
+APMATH_BENCHMARK_DIGITS(serialize);
+APMATH_BENCHMARK_DIGITS(deserialize);
+APMATH_BENCHMARK_DIGITS(copy);
+APMATH_BENCHMARK_DIGITS(copyAndIncrement);
+APMATH_BENCHMARK_DIGITS(add);
+APMATH_BENCHMARK_DIGITS(addInPlace);
+APMATH_BENCHMARK_DIGITS(addMultiply);
+APMATH_BENCHMARK_DIGITS(addProduct);
+APMATH_BENCHMARK_DIGITS(addCarryChain);
+APMATH_BENCHMARK_DIGITS(subtract);
+APMATH_BENCHMARK_DIGITS(addMixedSigns);
+APMATH_BENCHMARK_DIGITS(compare);
+APMATH_BENCHMARK_DIGITS(hash);
+APMATH_BENCHMARK_DIGITS(increment);
+APMATH_BENCHMARK_DIGITS(incrementCarryChain);
+APMATH_BENCHMARK_DIGITS(addNative);
+APMATH_BENCHMARK_DIGITS(multiplyNative);
+APMATH_BENCHMARK_DIGITS(multiply);
+APMATH_BENCHMARK_DIGITS(square);
+APMATH_BENCHMARK_DIGITS(divide);
+APMATH_BENCHMARK_DIGITS(modulo);
+APMATH_BENCHMARK_DIGITS(bitwiseAnd);
+APMATH_BENCHMARK_DIGITS(bitwiseMixedSigns);
+APMATH_BENCHMARK_DIGITS(shiftRight);
+APMATH_BENCHMARK_DIGITS(lazySum);
+BENCHMARK(constantFromString);
+BENCHMARK(constantFromLiteral);
+BENCHMARK(fixedMultiply);
+BENCHMARK(uint256Add);
+BENCHMARK(uint256Multiply);
+BENCHMARK(bigInteger256Add);
+BENCHMARK(bigInteger256Multiply);
+// Moduli of 512, 1024, 2048 and 4096 bits
+BENCHMARK(powmod)->Arg(155)->Arg(309)->Arg(617)->Arg(1233)->Unit(benchmark::kMicrosecond);
+BENCHMARK(powmodDivision)->Arg(155)->Arg(309)->Arg(617)->Arg(1233)->Unit(benchmark::kMicrosecond);
+BENCHMARK(gcd)->RangeMultiplier(10)->Range(MinDigits, 100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(gcdEuclid)->RangeMultiplier(10)->Range(MinDigits, 100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(isqrt)->RangeMultiplier(10)->Range(MinDigits, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(isProbablePrime)->Arg(155)->Arg(309)->Arg(617)->Arg(1233)->Unit(benchmark::kMicrosecond);
+// Batches hold a thousand operands, so they stop at ten thousand digits each
+BENCHMARK(batchMultiply)->RangeMultiplier(10)->Range(MinDigits, 10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(batchSum)->RangeMultiplier(10)->Range(MinDigits, 10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(batchDot)->RangeMultiplier(10)->Range(MinDigits, 10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(accumulator)->RangeMultiplier(10)->Range(MinDigits, 10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(sumByAddition)->RangeMultiplier(10)->Range(MinDigits, 10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(unorderedMapFind);
+BENCHMARK(decimalInterest)->RangeMultiplier(10)->Range(MinDigits, 1000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(decimalInterestByString)->RangeMultiplier(10)->Range(MinDigits, 1000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(snapshotLoad)->RangeMultiplier(10)->Range(MinDigits, 10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(factorial)->RangeMultiplier(10)->Range(10, 1000000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
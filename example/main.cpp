@@ -1,11 +1,451 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include <BigInteger.hpp>
+#include <Tuning.hpp>
+
+// Streaming mode evaluates one expression per line of the input and prints one result line per input line.
+// Lines are read in batches, the lines of a batch between two assignments don't depend on each other
+// and are evaluated in parallel, each thread on its own stack of numbers which keep their limbs from line to line.
+
+namespace {
+using apmath::BigInteger;
+
+// Lines read before they are evaluated, when the input doesn't end or pause earlier
+constexpr std::size_t BatchLines = 4096;
+// Lines a thread takes at once
+constexpr std::size_t LinesPerTask = 64;
+// Limit of nested parentheses and unary signs, deeper lines would overflow the stack of the evaluator
+constexpr std::size_t MaxNesting = 1000;
+
+enum class Syntax {
+    Infix,  // 2 * (a + 3)
+    Rpn     // 2 a 3 + *
+};
+
+// Values of the names assigned by lines like "a = 2 * 3", read by the following lines
+using Registers = std::map<std::string, BigInteger, std::less<>>;
+
+struct Result {
+    std::string text;
+    bool error = false;
+};
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+bool isNameStart(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+bool isNameChar(char c) {
+    return isNameStart(c) || isDigit(c);
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && isSpace(text.front())) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && isSpace(text.back())) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// Splits "name = expression" into the name and the expression, the name is empty for other lines
+std::pair<std::string_view, std::string_view> splitAssignment(std::string_view line) {
+    std::string_view text = trim(line);
+    std::size_t length = 0;
+    if (text.empty() || !isNameStart(text[0])) {
+        return {std::string_view(), line};
+    }
+    while (length < text.size() && isNameChar(text[length])) {
+        ++length;
+    }
+    std::string_view rest = trim(text.substr(length));
+    if (rest.empty() || rest[0] != '=') {
+        return {std::string_view(), line};
+    }
+    return {text.substr(0, length), rest.substr(1)};
+}
+
+class Evaluator {
+public:
+    Evaluator(const Registers& registers, Syntax syntax)
+        : mRegisters(registers),
+          mSyntax(syntax)
+    {}
+
+    /**
+     * @brief evaluate - value of the expression, valid until the next call
+     * @throw std::invalid_argument for malformed expressions and unknown names,
+     * std::domain_error on division by zero
+     */
+    const BigInteger& evaluate(std::string_view expression) {
+        mText = expression;
+        mPosition = 0;
+        mDepth = 0;
+        mNesting = 0;
+        if (mSyntax == Syntax::Infix) {
+            parseSum();
+            skipSpaces();
+            if (mPosition < mText.size()) {
+                fail();
+            }
+        }
+        else {
+            parseRpn();
+        }
+        return mStack[0];
+    }
+
+    /**
+     * @brief format - result line of the input line, an empty line for blank ones
+     */
+    Result format(std::string_view line) {
+        Result result;
+        if (trim(line).empty()) {
+            return result;
+        }
+        try {
+            append(result.text, evaluate(line));
+        }
+        catch (std::exception& e) {
+            result.text = std::string("error: ") + e.what();
+            result.error = true;
+        }
+        return result;
+    }
+
+    static void append(std::string& text, const BigInteger& value) {
+        std::size_t size = text.size();
+        text.resize(size + value.decimalLengthBound());
+        auto result = apmath::to_chars(&text[size], &text[0] + text.size(), value);
+        text.resize(static_cast<std::size_t>(result.ptr - text.data()));
+    }
+
+private:
+    const Registers& mRegisters;
+    Syntax mSyntax;
+    // Numbers of the stack are reused by the following lines, so their limbs are allocated once
+    std::vector<BigInteger> mStack;
+    std::size_t mDepth = 0;
+    std::string_view mText;
+    std::size_t mPosition = 0;
+    std::size_t mNesting = 0;
+
+    [[noreturn]] void fail() const {
+        if (mPosition >= mText.size()) {
+            throw std::invalid_argument("unexpected end of line");
+        }
+        throw std::invalid_argument("unexpected '" + std::string(1, mText[mPosition]) + "' at column "
+                                    + std::to_string(mPosition + 1));
+    }
+
+    void skipSpaces() {
+        while (mPosition < mText.size() && isSpace(mText[mPosition])) {
+            ++mPosition;
+        }
+    }
+
+    char peek() {
+        skipSpaces();
+        return mPosition < mText.size() ? mText[mPosition] : '\0';
+    }
+
+    BigInteger& push() {
+        if (mDepth == mStack.size()) {
+            mStack.emplace_back();
+        }
+        return mStack[mDepth++];
+    }
+
+    void pushNumber() {
+        const char* first = mText.data() + mPosition;
+        auto result = apmath::from_chars(first, mText.data() + mText.size(), push());
+        mPosition += static_cast<std::size_t>(result.ptr - first);
+    }
+
+    void pushRegister() {
+        std::size_t start = mPosition;
+        while (mPosition < mText.size() && isNameChar(mText[mPosition])) {
+            ++mPosition;
+        }
+        std::string_view name = mText.substr(start, mPosition - start);
+        auto found = mRegisters.find(name);
+        if (found == mRegisters.end()) {
+            throw std::invalid_argument("unknown name '" + std::string(name) + "'");
+        }
+        push() = found->second;
+    }
+
+    // Replaces the two topmost numbers with the result of the operator
+    void apply(char operation) {
+        BigInteger& lhs = mStack[mDepth - 2];
+        const BigInteger& rhs = mStack[mDepth - 1];
+        switch (operation) {
+        case '+':
+            lhs += rhs;
+            break;
+        case '-':
+            lhs -= rhs;
+            break;
+        case '*':
+            lhs *= rhs;
+            break;
+        case '/':
+            lhs /= rhs;
+            break;
+        default:
+            lhs %= rhs;
+            break;
+        }
+        --mDepth;
+    }
+
+    void parseSum() {
+        parseProduct();
+        for (char operation = peek(); operation == '+' || operation == '-'; operation = peek()) {
+            ++mPosition;
+            parseProduct();
+            apply(operation);
+        }
+    }
+
+    void parseProduct() {
+        parseUnary();
+        for (char operation = peek(); operation == '*' || operation == '/' || operation == '%'; operation = peek()) {
+            ++mPosition;
+            parseUnary();
+            apply(operation);
+        }
+    }
+
+    void parseUnary() {
+        char c = peek();
+        if (c == '-' || c == '+' || c == '(') {
+            if (++mNesting > MaxNesting) {
+                throw std::invalid_argument("nesting deeper than " + std::to_string(MaxNesting));
+            }
+            ++mPosition;
+            if (c == '(') {
+                parseSum();
+                if (peek() != ')') {
+                    fail();
+                }
+                ++mPosition;
+            }
+            else {
+                parseUnary();
+                if (c == '-') {
+                    mStack[mDepth - 1] *= -1;
+                }
+            }
+            --mNesting;
+        }
+        else if (isDigit(c)) {
+            pushNumber();
+        }
+        else if (isNameStart(c)) {
+            pushRegister();
+        }
+        else {
+            fail();
+        }
+    }
+
+    void parseRpn() {
+        for (char c = peek(); c != '\0'; c = peek()) {
+            bool signedNumber = (c == '-' || c == '+') && mPosition + 1 < mText.size()
+                                && isDigit(mText[mPosition + 1]);
+            if (isDigit(c) || signedNumber) {
+                pushNumber();
+            }
+            else if (isNameStart(c)) {
+                pushRegister();
+            }
+            else if (std::strchr("+-*/%", c) != nullptr) {
+                if (mDepth < 2) {
+                    throw std::invalid_argument("operator '" + std::string(1, c) + "' at column "
+                                                + std::to_string(mPosition + 1) + " needs two operands");
+                }
+                ++mPosition;
+                apply(c);
+                continue;
+            }
+            else {
+                fail();
+            }
+            // Tokens are separated by spaces
+            if (mPosition < mText.size() && !isSpace(mText[mPosition])) {
+                fail();
+            }
+        }
+        if (mDepth != 1) {
+            throw std::invalid_argument(mDepth == 0 ? "empty expression"
+                                                    : std::to_string(mDepth) + " values left on the stack");
+        }
+    }
+};
+
+// Reads up to BatchLines lines into lines, reusing their strings, and returns their count.
+// Reading stops early when the input has nothing buffered, so interactive input is answered at once.
+std::size_t readBatch(std::istream& in, std::vector<std::string>& lines, bool stopWhenIdle) {
+    std::size_t count = 0;
+    while (count < BatchLines) {
+        if (count == lines.size()) {
+            lines.emplace_back();
+        }
+        if (!std::getline(in, lines[count])) {
+            break;
+        }
+        ++count;
+        if (stopWhenIdle && in.rdbuf()->in_avail() <= 0) {
+            break;
+        }
+    }
+    return count;
+}
+
+// Evaluates lines [begin, end) on up to threadCount() threads, each with its own evaluator,
+// the threads take LinesPerTask lines at a time until none are left
+void evaluateLines(const std::vector<std::string>& lines, std::vector<Result>& results, std::size_t begin,
+                   std::size_t end, const Registers& registers, Syntax syntax) {
+    std::size_t tasks = (end - begin + LinesPerTask - 1) / LinesPerTask;
+    std::size_t threads = std::min(tasks, apmath::threadCount());
+    std::atomic<std::size_t> nextTask(0);
+    auto work = [&]() {
+        Evaluator evaluator(registers, syntax);
+        for (std::size_t task = nextTask++; task < tasks; task = nextTask++) {
+            std::size_t first = begin + task * LinesPerTask;
+            std::size_t last = std::min(end, first + LinesPerTask);
+            for (std::size_t i = first; i < last; ++i) {
+                results[i] = evaluator.format(lines[i]);
+            }
+        }
+    };
+    std::vector<std::future<void>> helpers;
+    for (std::size_t i = 1; i < threads; ++i) {
+        helpers.push_back(std::async(std::launch::async, work));
+    }
+    work();
+    for (std::future<void>& helper : helpers) {
+        helper.get();
+    }
+}
+
+int runStream(std::istream& in, Syntax syntax, bool stopWhenIdle) {
+    Registers registers;
+    std::vector<std::string> lines;
+    std::vector<Result> results;
+    std::string output;
+    bool failed = false;
+
+    for (std::size_t count = readBatch(in, lines, stopWhenIdle); count > 0;
+         count = readBatch(in, lines, stopWhenIdle)) {
+        results.assign(count, Result());
+        std::size_t begin = 0;
+        while (begin < count) {
+            std::size_t end = begin;
+            while (end < count && splitAssignment(lines[end]).first.empty()) {
+                ++end;
+            }
+            evaluateLines(lines, results, begin, end, registers, syntax);
+            if (end < count) {
+                // Assignments change the registers, so they're evaluated alone
+                auto assignment = splitAssignment(lines[end]);
+                Evaluator evaluator(registers, syntax);
+                try {
+                    const BigInteger& value = evaluator.evaluate(assignment.second);
+                    auto found = registers.find(assignment.first);
+                    if (found == registers.end()) {
+                        found = registers.emplace(std::string(assignment.first), BigInteger()).first;
+                    }
+                    found->second = value;
+                    Evaluator::append(results[end].text, value);
+                }
+                catch (std::exception& e) {
+                    results[end].text = std::string("error: ") + e.what();
+                    results[end].error = true;
+                }
+            }
+            begin = end + 1;
+        }
+
+        output.clear();
+        for (const Result& result : results) {
+            output += result.text;
+            output += '\n';
+            failed = failed || result.error;
+        }
+        std::cout.write(output.data(), static_cast<std::streamsize>(output.size()));
+        std::cout.flush();
+    }
+    return failed ? -1 : 0;
+}
+
+void printUsage() {
+    std::cout << "Wrong arguments! Usage: big-number-example operand_1 operand_2" << std::endl
+              << "       big-number-example --stream [--rpn] [--threads count] [file]" << std::endl;
+}
+}
 
 int main(int argc, char *argv[])
 {
+    if (argc >= 2 && std::strcmp(argv[1], "--stream") == 0) {
+        Syntax syntax = Syntax::Infix;
+        const char* path = nullptr;
+        try {
+            for (int i = 2; i < argc; ++i) {
+                if (std::strcmp(argv[i], "--rpn") == 0) {
+                    syntax = Syntax::Rpn;
+                }
+                else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+                    apmath::setThreadCount(std::stoul(argv[++i]));
+                }
+                else if (path == nullptr && (argv[i][0] != '-' || std::strcmp(argv[i], "-") == 0)) {
+                    path = argv[i];
+                }
+                else {
+                    printUsage();
+                    return -1;
+                }
+            }
+        }
+        catch (std::exception&) {
+            printUsage();
+            return -1;
+        }
+
+        std::ios_base::sync_with_stdio(false);
+        if (path == nullptr || std::strcmp(path, "-") == 0) {
+            return runStream(std::cin, syntax, true);
+        }
+        std::ifstream file(path);
+        if (!file) {
+            std::cout << "Can't open " << path << std::endl;
+            return -1;
+        }
+        return runStream(file, syntax, false);
+    }
+
     if (argc != 3) {
-        std::cout << "Wrong arguments! Usage: big-number-example operand_1 operand_2" << std::endl;
+        printUsage();
         return -1;
     }
 
@@ -0,0 +1,32 @@
+#include "Accumulator.hpp"
+
+namespace apmath {
+
+Accumulator& Accumulator::merge(const Accumulator& other) {
+    mSum.merge(other.mSum);
+    mLongSum += other.mLongSum;
+    return *this;
+}
+
+BigInteger Accumulator::value() const {
+    BigInteger result;
+    assignTo(result);
+    return result;
+}
+
+void Accumulator::assignTo(BigInteger& target) const {
+    mSum.store(target);
+    target += mLongSum;
+}
+
+void Accumulator::reserve(std::size_t bits) {
+    mSum.reserve(ColumnTermLimbs);
+    mLongSum.reserve(bits);
+}
+
+void Accumulator::clear() {
+    mSum.clear();
+    mLongSum = 0;
+}
+
+} // namespace apmath
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "BigInteger.hpp"
+#include "ColumnSum.hpp"
+#include "NativeIntegers.hpp"
+
+namespace apmath {
+
+/**
+ * @brief Accumulator - running sum of a long stream of numbers with deferred carries.
+ *
+ * Short terms are kept in carry-save form: every limb has a double-width column, so a term adds its limbs
+ * to the columns without carry propagation and the spare high half absorbs the carries of 2^(LimbBits - 2) terms.
+ * Carries run through the columns only then and when the sum is read. Terms longer than ColumnTermBits
+ * go to a binary sum instead, their carry chains cost less than the double-width columns.
+ * The sums grow once to the longest term, so adding doesn't reallocate.
+ * Accumulators of different threads are combined by merge().
+ */
+class Accumulator {
+public:
+    /**
+     * @brief ColumnTermBits - longest terms added to the columns
+     */
+    static constexpr std::size_t ColumnTermBits = 256;
+
+    Accumulator& operator+=(const BigInteger& value) {
+        add(value, false);
+        return *this;
+    }
+    Accumulator& operator-=(const BigInteger& value) {
+        add(value, true);
+        return *this;
+    }
+
+    /**
+     * @brief operator+= - adds a native integer without creating a temporary BigInteger
+     */
+    template <typename T, detail::EnableIfIntegral<T> = 0>
+    Accumulator& operator+=(T value) {
+        auto native = static_cast<detail::NativeType<T>>(value);
+        addNative(detail::isNegative(native), detail::magnitudeOf(native));
+        return *this;
+    }
+    template <typename T, detail::EnableIfIntegral<T> = 0>
+    Accumulator& operator-=(T value) {
+        auto native = static_cast<detail::NativeType<T>>(value);
+        addNative(!detail::isNegative(native), detail::magnitudeOf(native));
+        return *this;
+    }
+
+    /**
+     * @brief merge - adds the sum of another accumulator, for example of another thread
+     */
+    Accumulator& merge(const Accumulator& other);
+    /**
+     * @brief value - the sum, carries are propagated into the result
+     */
+    BigInteger value() const;
+    /**
+     * @brief assignTo - assigns the sum to target reusing its limbs
+     */
+    void assignTo(BigInteger& target) const;
+    /**
+     * @brief reserve - makes room for terms of up to bits bits
+     */
+    void reserve(std::size_t bits);
+    /**
+     * @brief clear - sets the sum to zero, the room of the columns stays
+     */
+    void clear();
+
+private:
+    detail::ColumnSum mSum;
+    BigInteger mLongSum;
+
+    static constexpr std::size_t ColumnTermLimbs = ColumnTermBits / APMATH_LIMB_BITS;
+    static constexpr std::size_t NativeLimbs = sizeof(std::uint64_t) / sizeof(Limb);
+
+    void add(const BigInteger& value, bool subtract) {
+        const detail::LimbStorage& limbs = detail::LimbAccess::limbs(value);
+        if (limbs.size() > ColumnTermLimbs) {
+            if (subtract) {
+                mLongSum -= value;
+            }
+            else {
+                mLongSum += value;
+            }
+            return;
+        }
+        mSum.add(limbs.data(), limbs.size(), detail::LimbAccess::isNegative(value) != subtract);
+    }
+
+    void addNative(bool negative, std::uint64_t magnitude) {
+#if APMATH_LIMB_BITS == 64
+        Limb limbs[NativeLimbs] = {magnitude};
+#else
+        Limb limbs[NativeLimbs] = {static_cast<Limb>(magnitude), static_cast<Limb>(magnitude >> detail::LimbBits)};
+#endif
+        mSum.add(limbs, NativeLimbs, negative);
+    }
+};
+
+} // namespace apmath
@@ -0,0 +1,231 @@
+#include "Batch.hpp"
+#include "ColumnSum.hpp"
+#include "LimbAccess.hpp"
+#include "LimbKernels.hpp"
+#include "Multiplication.hpp"
+#include "ThreadPool.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using apmath::BigInteger;
+using apmath::Limb;
+using apmath::batch::Span;
+using apmath::detail::ColumnSum;
+using apmath::detail::LimbAccess;
+using apmath::detail::LimbBits;
+using apmath::detail::SignedDoubleLimb;
+
+// Reductions split their ranges among threads down to this many operands or limbs of the product
+constexpr size_t ParallelReductionTerms = 4096;
+constexpr size_t ParallelProductLimbs = 2048;
+constexpr size_t ParallelMultiplyTerms = 1024;
+// Products of this many operands are accumulated one by one, longer ranges are split in halves
+constexpr size_t SerialProductTerms = 8;
+
+// Values of at most one limb are combined in a double-width signed integer,
+// which skips the general sign and length handling of BigInteger operators
+bool combineSmall(const BigInteger& a, const BigInteger& b, bool subtract, BigInteger& result) {
+    const apmath::detail::LimbStorage& lhs = LimbAccess::limbs(a);
+    const apmath::detail::LimbStorage& rhs = LimbAccess::limbs(b);
+    if (lhs.size() > 1 || rhs.size() > 1) {
+        return false;
+    }
+    SignedDoubleLimb x = lhs.empty() ? 0 : lhs[0];
+    SignedDoubleLimb y = rhs.empty() ? 0 : rhs[0];
+    SignedDoubleLimb sum = (LimbAccess::isNegative(a) ? -x : x) + (LimbAccess::isNegative(b) != subtract ? -y : y);
+    apmath::detail::DoubleLimb magnitude = static_cast<apmath::detail::DoubleLimb>(sum < 0 ? -sum : sum);
+    apmath::detail::LimbStorage& limbs = LimbAccess::limbs(result);
+    limbs.resize(2);
+    limbs[0] = static_cast<Limb>(magnitude);
+    limbs[1] = static_cast<Limb>(magnitude >> LimbBits);
+    LimbAccess::setNegative(result, sum < 0);
+    return true;
+}
+
+void checkSizes(size_t a, size_t b, size_t out) {
+    if (a != b || a != out) {
+        throw std::invalid_argument("BigInteger batch operands have different sizes");
+    }
+}
+
+BigInteger sumRange(Span<const BigInteger> values, size_t begin, size_t end) {
+    if (end - begin > ParallelReductionTerms) {
+        size_t middle = begin + (end - begin) / 2;
+        BigInteger low;
+        BigInteger high;
+        apmath::detail::parallelInvoke(true,
+                                       [&]() { low = sumRange(values, begin, middle); },
+                                       [&]() { high = sumRange(values, middle, end); });
+        return low += high;
+    }
+    ColumnSum columns;
+    for (size_t i = begin; i < end; ++i) {
+        const apmath::detail::LimbStorage& limbs = LimbAccess::limbs(values[i]);
+        columns.add(limbs.data(), limbs.size(), LimbAccess::isNegative(values[i]));
+    }
+    BigInteger result;
+    columns.store(result);
+    return result;
+}
+
+// Products of single limbs are accumulated directly, longer ones go through a reused buffer
+BigInteger dotRange(Span<const BigInteger> a, Span<const BigInteger> b, size_t begin, size_t end) {
+    if (end - begin > ParallelReductionTerms) {
+        size_t middle = begin + (end - begin) / 2;
+        BigInteger low;
+        BigInteger high;
+        apmath::detail::parallelInvoke(true,
+                                       [&]() { low = dotRange(a, b, begin, middle); },
+                                       [&]() { high = dotRange(a, b, middle, end); });
+        return low += high;
+    }
+    ColumnSum columns;
+    std::vector<Limb> product;
+    for (size_t i = begin; i < end; ++i) {
+        const apmath::detail::LimbStorage& lhs = LimbAccess::limbs(a[i]);
+        const apmath::detail::LimbStorage& rhs = LimbAccess::limbs(b[i]);
+        if (lhs.empty() || rhs.empty()) {
+            continue;
+        }
+        bool negative = LimbAccess::isNegative(a[i]) != LimbAccess::isNegative(b[i]);
+        if (lhs.size() == 1 && rhs.size() == 1) {
+            apmath::detail::DoubleLimb limbProduct = static_cast<apmath::detail::DoubleLimb>(lhs[0]) * rhs[0];
+            Limb limbs[2] = {static_cast<Limb>(limbProduct), static_cast<Limb>(limbProduct >> LimbBits)};
+            columns.add(limbs, 2, negative);
+        }
+        else {
+            product.resize(lhs.size() + rhs.size());
+            apmath::detail::multiplyLimbs(product.data(), lhs.data(), lhs.size(), rhs.data(), rhs.size());
+            columns.add(product.data(), product.size(), negative);
+        }
+    }
+    BigInteger result;
+    columns.store(result);
+    return result;
+}
+
+// Product tree: both halves have about the same length, so the top multiplications are balanced
+// and long enough for the fast algorithms. lengths holds prefix sums of operand lengths,
+// halves with long products run concurrently.
+BigInteger productRange(Span<const BigInteger> values, const std::vector<size_t>& lengths, size_t begin, size_t end) {
+    if (end - begin <= SerialProductTerms) {
+        BigInteger result = values[begin];
+        for (size_t i = begin + 1; i < end; ++i) {
+            result *= values[i];
+        }
+        return result;
+    }
+    size_t middle = begin + (end - begin) / 2;
+    BigInteger low;
+    BigInteger high;
+    apmath::detail::parallelInvoke(lengths[end] - lengths[begin] >= ParallelProductLimbs,
+                                   [&]() { low = productRange(values, lengths, begin, middle); },
+                                   [&]() { high = productRange(values, lengths, middle, end); });
+    return low *= high;
+}
+
+} // namespace
+
+namespace apmath {
+namespace batch {
+
+// Outputs are assigned, so their limbs are reused, then updated in place
+void add(Span<const BigInteger> a, Span<const BigInteger> b, Span<BigInteger> out) {
+    checkSizes(a.size(), b.size(), out.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+        BigInteger& result = out[i];
+        if (combineSmall(a[i], b[i], false, result)) {
+            continue;
+        }
+        if (&result == &b[i]) {
+            result += a[i];
+        }
+        else {
+            if (&result != &a[i]) {
+                result = a[i];
+            }
+            result += b[i];
+        }
+    }
+}
+
+void subtract(Span<const BigInteger> a, Span<const BigInteger> b, Span<BigInteger> out) {
+    checkSizes(a.size(), b.size(), out.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+        BigInteger& result = out[i];
+        if (combineSmall(a[i], b[i], true, result)) {
+            continue;
+        }
+        if (&result == &b[i] && &result != &a[i]) {
+            result -= a[i];
+            result = -result;
+        }
+        else {
+            if (&result != &a[i]) {
+                result = a[i];
+            }
+            result -= b[i];
+        }
+    }
+}
+
+// Products are independent, so long arrays are split among threads
+void multiply(Span<const BigInteger> a, Span<const BigInteger> b, Span<BigInteger> out) {
+    checkSizes(a.size(), b.size(), out.size());
+    detail::parallelFor(0, out.size(), ParallelMultiplyTerms, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            BigInteger& result = out[i];
+            if (&result == &b[i]) {
+                result *= a[i];
+            }
+            else {
+                if (&result != &a[i]) {
+                    result = a[i];
+                }
+                result *= b[i];
+            }
+        }
+    });
+}
+
+void compare(Span<const BigInteger> a, Span<const BigInteger> b, Span<int> out) {
+    checkSizes(a.size(), b.size(), out.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+        bool negative = LimbAccess::isNegative(a[i]);
+        if (negative != LimbAccess::isNegative(b[i])) {
+            out[i] = negative ? -1 : 1;
+            continue;
+        }
+        const detail::LimbStorage& lhs = LimbAccess::limbs(a[i]);
+        const detail::LimbStorage& rhs = LimbAccess::limbs(b[i]);
+        int result = detail::compareLimbs(lhs.data(), lhs.size(), rhs.data(), rhs.size());
+        result = (result > 0) - (result < 0);
+        out[i] = negative ? -result : result;
+    }
+}
+
+BigInteger sum(Span<const BigInteger> values) {
+    return sumRange(values, 0, values.size());
+}
+
+BigInteger dot(Span<const BigInteger> a, Span<const BigInteger> b) {
+    checkSizes(a.size(), b.size(), a.size());
+    return dotRange(a, b, 0, a.size());
+}
+
+BigInteger product(Span<const BigInteger> values) {
+    if (values.empty()) {
+        return BigInteger(1);
+    }
+    std::vector<size_t> lengths(values.size() + 1);
+    for (size_t i = 0; i < values.size(); ++i) {
+        lengths[i + 1] = lengths[i] + LimbAccess::limbs(values[i]).size();
+    }
+    return productRange(values, lengths, 0, values.size());
+}
+
+} // namespace batch
+} // namespace apmath
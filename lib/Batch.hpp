@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "BigInteger.hpp"
+
+/**
+ * Bulk arithmetic over arrays of BigInteger.
+ * The arrays hold whole BigInteger objects, there is no structure-of-arrays layout of the limbs.
+ * Elementwise operations loop over the elements, write into existing outputs and reuse their limbs,
+ * and add single-limb operands without the general BigInteger operators.
+ * Only the reductions sum and dot use a columnar layout: they accumulate the limbs of all operands
+ * in columns and propagate carries once at the end.
+ * Reductions of long arrays split them among threadCount() threads and combine the parts pairwise.
+ */
+namespace apmath {
+namespace batch {
+
+/**
+ * @brief Span - non-owning view of a contiguous array, constructible from
+ * pointer and size, C arrays and containers with data() and size() like std::vector
+ */
+template <typename T>
+class Span {
+public:
+    Span(T* data, std::size_t size)
+        : mData(data),
+          mSize(size)
+    {}
+
+    template <std::size_t N>
+    Span(T (&array)[N])
+        : Span(array, N)
+    {}
+
+    template <typename Container,
+              typename = typename std::enable_if<
+                  std::is_convertible<decltype(std::declval<Container&>().data()), T*>::value>::type>
+    Span(Container&& container)
+        : Span(container.data(), container.size())
+    {}
+
+    T* data() const { return mData; }
+    std::size_t size() const { return mSize; }
+    bool empty() const { return mSize == 0; }
+
+    T* begin() const { return mData; }
+    T* end() const { return mData + mSize; }
+
+    T& operator[](std::size_t i) const { return mData[i]; }
+
+private:
+    T* mData;
+    std::size_t mSize;
+};
+
+/**
+ * @brief add - computes out[i] = a[i] + b[i]
+ * @param out - results, may be the same array as a or b
+ * @throw std::invalid_argument if the arrays have different sizes
+ */
+void add(Span<const BigInteger> a, Span<const BigInteger> b, Span<BigInteger> out);
+/**
+ * @brief subtract - computes out[i] = a[i] - b[i]
+ * @param out - results, may be the same array as a or b
+ * @throw std::invalid_argument if the arrays have different sizes
+ */
+void subtract(Span<const BigInteger> a, Span<const BigInteger> b, Span<BigInteger> out);
+/**
+ * @brief multiply - computes out[i] = a[i] * b[i]
+ * @param out - results, may be the same array as a or b
+ * @throw std::invalid_argument if the arrays have different sizes
+ */
+void multiply(Span<const BigInteger> a, Span<const BigInteger> b, Span<BigInteger> out);
+/**
+ * @brief compare - computes out[i] = -1, 0 or 1 when a[i] is less, equal or greater than b[i]
+ * @throw std::invalid_argument if the arrays have different sizes
+ */
+void compare(Span<const BigInteger> a, Span<const BigInteger> b, Span<int> out);
+/**
+ * @brief sum - sum of all values, zero for an empty array
+ */
+BigInteger sum(Span<const BigInteger> values);
+/**
+ * @brief dot - sum of products a[i] * b[i]
+ * @throw std::invalid_argument if the arrays have different sizes
+ */
+BigInteger dot(Span<const BigInteger> a, Span<const BigInteger> b);
+/**
+ * @brief product - product of all values, one for an empty array.
+ * Operands are multiplied in a balanced tree, so long products like factorials
+ * end in a few large multiplications which run on several threads.
+ */
+BigInteger product(Span<const BigInteger> values);
+
+} // namespace batch
+} // namespace apmath
@@ -1,167 +1,746 @@
 #include "BigInteger.hpp"
+#include "Division.hpp"
+#include "LimbKernels.hpp"
+#include "Multiplication.hpp"
+#include "RadixConversion.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <ostream>
 #include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace apmath {
 
 namespace {
-// Add less absolute value to greater. Uses classical algorithm with carry digit.
-// Single digit addition performs as:
-// - converting lhs, rhs digits from char to int
-// - computing digit sum: lhsDigit + rhsDigit + carry
-// - updating carry digit
-// - converting digit sum from int to char
-void sumString(std::string& greater, const std::string& less) {
-    auto rhsCRIt = less.crbegin();
-    auto rhsCREnd = less.crend();
-    auto lhsREnd = greater.rend();
-
-    char carry = 0;
-    for (auto lhsRIt = greater.rbegin(); lhsRIt != lhsREnd; ++lhsRIt) {
-        bool lessEndReached {rhsCRIt == rhsCREnd};
-        auto digitSum = *lhsRIt - '0' + carry;
-
-        if (lessEndReached) {
-            if (carry == 0) break;
-        }
-        else {
-            digitSum += *rhsCRIt - '0';
-            ++rhsCRIt;
-        }
 
-        carry = digitSum / 10;
-        digitSum %= 10;
-        *lhsRIt = '0' + digitSum;
-    }
+constexpr size_t NativeLimbs = 64 / detail::LimbBits;
+// Streams convert and transfer digits in pieces of this many characters
+constexpr size_t StreamPieceDigits = 1 << 16;
+constexpr size_t StreamReadDigits = 4096;
+// Longest product buffer a thread keeps for the following addMultiply calls
+constexpr size_t MaxKeptProductLimbs = size_t(1) << 16;
 
-    if (carry) {
-        greater.insert(0, 1, '0' + carry);
-    }
+// Products of addMultiply too long for the stack are computed here, so accumulate loops don't allocate them
+thread_local std::vector<Limb> productBuffer;
+
+// Splits a native magnitude into limbs, returns their number without high zero limbs
+size_t splitMagnitude(Limb* limbs, std::uint64_t magnitude) {
+#if APMATH_LIMB_BITS == 64
+    limbs[0] = magnitude;
+    return magnitude != 0 ? 1 : 0;
+#else
+    limbs[0] = static_cast<Limb>(magnitude);
+    limbs[1] = static_cast<Limb>(magnitude >> detail::LimbBits);
+    return detail::significantLength(limbs, 2);
+#endif
 }
 
-// Subtract less absolute value from greater. Uses classical algorithm with borrow digit.
-// Single digit subtraction looks similar to single digit addition.
-void subtractString(std::string& greater, const std::string& less) {
-    auto rhsCRIt = less.crbegin();
-    auto rhsCREnd = less.crend();
-    auto lhsREnd = greater.rend();
+// Secrets of wyhash, odd constants with balanced bits
+constexpr std::uint64_t HashSecret[4] = {0xa0761d6478bd642full, 0xe7037ed1a0b428dbull,
+                                         0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull};
 
-    char borrow = 0;
-    for (auto lhsRIt = greater.rbegin(); lhsRIt != lhsREnd; ++lhsRIt) {
-        bool lessEndReached {rhsCRIt == rhsCREnd};
-        auto digitSub = *lhsRIt - '0' + borrow;
+// Folds the 128-bit product of a and b into 64 bits, one multiplication mixes every input bit
+std::uint64_t multiplyMix(std::uint64_t a, std::uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 Product;
+    Product product = static_cast<Product>(a) * b;
+    return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+#else
+    std::uint64_t aLow = a & 0xFFFFFFFF, aHigh = a >> 32, bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+    std::uint64_t low = aLow * bLow;
+    std::uint64_t middle1 = aHigh * bLow + (low >> 32);
+    std::uint64_t middle2 = aLow * bHigh + (middle1 & 0xFFFFFFFF);
+    std::uint64_t high = aHigh * bHigh + (middle1 >> 32) + (middle2 >> 32);
+    return ((middle2 << 32) | (low & 0xFFFFFFFF)) ^ high;
+#endif
+}
 
-        if (lessEndReached) {
-            if (borrow == 0) break;
-        }
-        else {
-            digitSub -= *rhsCRIt - '0';
-            ++rhsCRIt;
-        }
+// i-th 64-bit word of a magnitude
+std::uint64_t magnitudeWord(const Limb* limbs, size_t n, size_t i) {
+    std::uint64_t word = 0;
+    for (size_t j = 0; j < NativeLimbs && i * NativeLimbs + j < n; ++j) {
+        word |= static_cast<std::uint64_t>(limbs[i * NativeLimbs + j]) << (detail::LimbBits * j);
+    }
+    return word;
+}
 
-        if (digitSub < 0) {
-            digitSub += 10;
-            borrow = -1;
-        }
-        else {
-            borrow = 0;
-        }
-        *lhsRIt = '0' + digitSub;
+// Hashes pairs of words like wyhash, the word count and the sign seed the state
+size_t hashLimbs(const Limb* limbs, size_t n, bool negative) {
+    size_t words = (n + NativeLimbs - 1) / NativeLimbs;
+    std::uint64_t state = HashSecret[0] ^ (static_cast<std::uint64_t>(words) << 1 | (negative ? 1 : 0));
+    size_t i = 0;
+    for (; i + 2 <= words; i += 2) {
+        state = multiplyMix(magnitudeWord(limbs, n, i) ^ HashSecret[1], magnitudeWord(limbs, n, i + 1) ^ state);
     }
+    if (i < words) {
+        state = multiplyMix(magnitudeWord(limbs, n, i) ^ HashSecret[2], state ^ HashSecret[1]);
+    }
+    return static_cast<size_t>(multiplyMix(state ^ HashSecret[3], static_cast<std::uint64_t>(words) ^ HashSecret[1]));
 }
 
-size_t countLeadingZeros(const std::string& number) {
-    size_t count = 0;
-    for ( ; count < number.size() - 1; ++count) {
-        if (number.at(count) != '0') {
-            break;
+// Converts limbs between a signed magnitude and the infinite two's complement form in one pass:
+// -m is (m ^ ~0) + 1, the carry of the +1 runs through the low zero limbs and stops at the first nonzero one.
+// The mask and carry of nonnegative values are zero, so they pass unchanged.
+inline Limb twosComplement(Limb limb, Limb mask, Limb& carry) {
+    Limb result = (limb ^ mask) + carry;
+    carry = result < carry;
+    return result;
+}
+
+// Applies a bitwise operation to two signed magnitudes in place of the first one, returns the sign of the result.
+// The operands are converted into two's complement, combined and the result is converted back limb by limb,
+// negative results may need one limb more than the longer operand.
+template <typename Operation>
+bool applyBitwise(detail::LimbStorage& a, bool aNegative, const Limb* b, size_t bn, bool bNegative,
+                  Operation operation) {
+    size_t an = a.size();
+    Limb ones = ~Limb(0);
+    Limb aMask = aNegative ? ones : 0;
+    Limb bMask = bNegative ? ones : 0;
+    bool negative = operation(aMask, bMask) != 0;
+    size_t n = std::max(an, bn);
+    // The limbs past a nonnegative operand matter only if the operation doesn't map zero bits to zero
+    if (!aNegative && operation(Limb(0), ones) == 0) {
+        n = std::min(n, an);
+    }
+    if (!bNegative && operation(ones, Limb(0)) == 0) {
+        n = std::min(n, bn);
+    }
+    a.resize(negative ? n + 1 : n);
+    Limb* r = a.data();
+    size_t common = std::min(n, std::min(an, bn));
+    if (!aNegative && !bNegative) {
+        for (size_t i = 0; i < common; ++i) {
+            r[i] = operation(r[i], b[i]);
         }
+        for (size_t i = common; i < n; ++i) {
+            r[i] = operation(i < an ? r[i] : 0, i < bn ? b[i] : 0);
+        }
+        return false;
     }
-    return count;
+    Limb mask = negative ? ones : 0;
+    Limb aCarry = aNegative ? 1 : 0;
+    Limb bCarry = bNegative ? 1 : 0;
+    Limb carry = negative ? 1 : 0;
+    for (size_t i = 0; i < common; ++i) {
+        Limb x = twosComplement(r[i], aMask, aCarry);
+        Limb y = twosComplement(b[i], bMask, bCarry);
+        r[i] = twosComplement(operation(x, y), mask, carry);
+    }
+    for (size_t i = common; i < n; ++i) {
+        Limb x = twosComplement(i < an ? r[i] : 0, aMask, aCarry);
+        Limb y = twosComplement(i < bn ? b[i] : 0, bMask, bCarry);
+        r[i] = twosComplement(operation(x, y), mask, carry);
+    }
+    if (negative) {
+        // The sign limbs of the result are all ones, their magnitude is just the final carry
+        r[n] = carry;
+    }
+    return negative;
 }
+
+} // namespace
+
+BigInteger::BigInteger()
+    : mSign(Plus)
+{
 }
 
-namespace apmath {
+BigInteger::BigInteger(std::pmr::memory_resource* resource)
+    : mLimbs(resource),
+      mSign(Plus)
+{
+}
 
-BigInteger::BigInteger(const std::string &numberString)
-    : mNumberString(numberString),
+BigInteger::BigInteger(std::string_view numberString, std::pmr::memory_resource* resource)
+    : mLimbs(resource),
       mSign(Plus)
 {
-    parseSign();
-    for (const auto& digit: mNumberString) {
-        if (digit < '0' || digit > '9') {
-            throw std::runtime_error("BigInteger format error: usage [+-][000]123456789");
-        }
-    }
-    skipZeros();
+    parseDecimal(numberString);
+}
+
+BigInteger::BigInteger(const BigInteger& other, std::pmr::memory_resource* resource)
+    : mLimbs(other.mLimbs, resource),
+      mSign(other.mSign)
+{
 }
 
 BigInteger& BigInteger::operator+=(const BigInteger &rhs) {
+    detail::OperationScope scope(InstrumentedOperation::Add, std::max(mLimbs.size(), rhs.mLimbs.size()));
     if (mSign == rhs.mSign) {
-        add(rhs);
+        add(rhs.mLimbs.data(), rhs.mLimbs.size());
     }
     else {
-        sub(rhs);
+        sub(rhs.mLimbs.data(), rhs.mLimbs.size(), rhs.mSign);
     }
     return *this;
 }
-// Uses: a - b = -(-a + b)
+// Uses: a - b = a + (-b), the operands may be the same object
 BigInteger& BigInteger::operator-=(const BigInteger &other) {
-    changeSign();
-    *this += other;
-    changeSign();
+    detail::OperationScope scope(InstrumentedOperation::Subtract, std::max(mLimbs.size(), other.mLimbs.size()));
+    if (mSign != other.mSign) {
+        add(other.mLimbs.data(), other.mLimbs.size());
+    }
+    else {
+        sub(other.mLimbs.data(), other.mLimbs.size(), other.mSign == Plus ? Minus : Plus);
+    }
+    return *this;
+}
+
+BigInteger& BigInteger::operator*=(const BigInteger &rhs) {
+    detail::OperationScope scope(InstrumentedOperation::Multiply, std::max(mLimbs.size(), rhs.mLimbs.size()));
+    detail::LimbStorage product(mLimbs.resource());
+    product.resize(mLimbs.size() + rhs.mLimbs.size());
+    detail::multiplyLimbs(product.data(), std::as_const(mLimbs).data(), mLimbs.size(), rhs.mLimbs.data(), rhs.mLimbs.size());
+    mLimbs.swap(product);
+    mSign = mSign == rhs.mSign ? Plus : Minus;
+    normalize();
     return *this;
 }
 
+BigInteger& BigInteger::addMultiply(const BigInteger& a, const BigInteger& b) {
+    addProduct(a.mLimbs.data(), a.mLimbs.size(), b.mLimbs.data(), b.mLimbs.size(), a.mSign == b.mSign ? Plus : Minus);
+    return *this;
+}
+
+BigInteger& BigInteger::subtractMultiply(const BigInteger& a, const BigInteger& b) {
+    addProduct(a.mLimbs.data(), a.mLimbs.size(), b.mLimbs.data(), b.mLimbs.size(), a.mSign == b.mSign ? Minus : Plus);
+    return *this;
+}
+
+BigInteger fma(const BigInteger& a, const BigInteger& b, const BigInteger& c) {
+    // The limbs of c are copied into a buffer of the final length
+    BigInteger result(c.resource());
+    result.reserve(std::max(a.bitLength() + b.bitLength(), c.bitLength()) + 1);
+    result = c;
+    result.addMultiply(a, b);
+    return result;
+}
+
+BigInteger& BigInteger::operator/=(const BigInteger &rhs) {
+    divide(*this, rhs, this, nullptr);
+    return *this;
+}
+
+BigInteger& BigInteger::operator%=(const BigInteger &rhs) {
+    divide(*this, rhs, nullptr, this);
+    return *this;
+}
+
+std::pair<BigInteger, BigInteger> divmod(const BigInteger& dividend, const BigInteger& divisor) {
+    std::pair<BigInteger, BigInteger> result;
+    BigInteger::divide(dividend, divisor, &result.first, &result.second);
+    return result;
+}
+
+BigInteger& BigInteger::operator&=(const BigInteger& rhs) {
+    if (this != &rhs) {
+        bool negative = applyBitwise(mLimbs, mSign == Minus, rhs.mLimbs.data(), rhs.mLimbs.size(),
+                                     rhs.mSign == Minus, [](Limb x, Limb y) { return x & y; });
+        mSign = negative ? Minus : Plus;
+        normalize();
+    }
+    return *this;
+}
+
+BigInteger& BigInteger::operator|=(const BigInteger& rhs) {
+    if (this != &rhs) {
+        bool negative = applyBitwise(mLimbs, mSign == Minus, rhs.mLimbs.data(), rhs.mLimbs.size(),
+                                     rhs.mSign == Minus, [](Limb x, Limb y) { return x | y; });
+        mSign = negative ? Minus : Plus;
+        normalize();
+    }
+    return *this;
+}
+
+BigInteger& BigInteger::operator^=(const BigInteger& rhs) {
+    if (this == &rhs) {
+        mLimbs.resize(0);
+        mSign = Plus;
+        return *this;
+    }
+    bool negative = applyBitwise(mLimbs, mSign == Minus, rhs.mLimbs.data(), rhs.mLimbs.size(),
+                                 rhs.mSign == Minus, [](Limb x, Limb y) { return x ^ y; });
+    mSign = negative ? Minus : Plus;
+    normalize();
+    return *this;
+}
+
+// Whole limbs are moved by the shift kernel itself, it writes from the top down
+BigInteger& BigInteger::operator<<=(size_t bits) {
+    if (mLimbs.empty()) {
+        return *this;
+    }
+    size_t limbShift = bits / detail::LimbBits;
+    size_t n = mLimbs.size();
+    mLimbs.resize(n + limbShift + 1);
+    Limb* limbs = mLimbs.data();
+    limbs[n + limbShift] = detail::shiftLeftLimbs(limbs + limbShift, limbs, n,
+                                                  static_cast<unsigned>(bits % detail::LimbBits));
+    std::fill(limbs, limbs + limbShift, Limb(0));
+    normalize();
+    return *this;
+}
+
+// Shifting the magnitude rounds toward zero, negative numbers which lose one bits are rounded down
+// by adding one to the magnitude
+BigInteger& BigInteger::operator>>=(size_t bits) {
+    size_t limbShift = bits / detail::LimbBits;
+    unsigned bitShift = static_cast<unsigned>(bits % detail::LimbBits);
+    size_t n = mLimbs.size();
+    if (limbShift >= n) {
+        mLimbs.resize(0);
+        if (mSign == Minus) {
+            mLimbs.push_back(1);
+        }
+        return *this;
+    }
+    Limb* limbs = mLimbs.data();
+    bool inexact = false;
+    if (mSign == Minus) {
+        inexact = (limbs[limbShift] & ((Limb(1) << bitShift) - 1)) != 0;
+        for (size_t i = 0; i < limbShift && !inexact; ++i) {
+            inexact = limbs[i] != 0;
+        }
+    }
+    detail::shiftRightLimbs(limbs, limbs + limbShift, n - limbShift, bitShift);
+    mLimbs.resize(n - limbShift);
+    if (inexact) {
+        incrementMagnitude();
+    }
+    normalize();
+    return *this;
+}
+
+std::string BigInteger::toString() const {
+    std::string digits(decimalLengthBound(), '0');
+    std::to_chars_result result = to_chars(&digits[0], &digits[0] + digits.size(), *this);
+    digits.resize(static_cast<size_t>(result.ptr - digits.data()));
+    return digits;
+}
+
+size_t BigInteger::decimalLengthBound() const {
+    if (mLimbs.empty()) {
+        return 1;
+    }
+    return detail::decimalDigitsBound(mLimbs.size()) + (mSign == Minus ? 1 : 0);
+}
+
+size_t BigInteger::hash() const {
+    return hashLimbs(mLimbs.data(), mLimbs.size(), mSign == Minus);
+}
+
+size_t BigInteger::hashValue(Sign sign, std::uint64_t magnitude) {
+    Limb limbs[NativeLimbs];
+    return hashLimbs(limbs, splitMagnitude(limbs, magnitude), sign == Minus);
+}
+
+int BigInteger::compareWithValue(Sign sign, std::uint64_t magnitude) const {
+    detail::OperationScope scope(InstrumentedOperation::Compare, mLimbs.size());
+    // Zero has plus sign, so different signs mean that the numbers differ
+    if (mSign != sign) {
+        return mSign;
+    }
+    Limb limbs[NativeLimbs];
+    size_t length = splitMagnitude(limbs, magnitude);
+    int magnitudesDiff = detail::compareLimbs(mLimbs.data(), mLimbs.size(), limbs, length);
+    return magnitudesDiff == 0 ? 0 : magnitudesDiff < 0 ? -mSign : mSign;
+}
+
+void BigInteger::reserve(size_t bits) {
+    mLimbs.reserve((bits + detail::LimbBits - 1) / detail::LimbBits);
+}
+
+size_t BigInteger::capacity() const {
+    return mLimbs.capacity() * detail::LimbBits;
+}
+
+size_t BigInteger::bitLength() const {
+    if (mLimbs.empty()) {
+        return 0;
+    }
+    return mLimbs.size() * detail::LimbBits - detail::countLeadingZeroBits(mLimbs[mLimbs.size() - 1]);
+}
+
+size_t BigInteger::popcount() const {
+    size_t count = 0;
+    for (size_t i = 0; i < mLimbs.size(); ++i) {
+        count += detail::countOneBits(mLimbs[i]);
+    }
+    return count;
+}
+
+// -m = ~(m - 1): limbs above the lowest nonzero one are complemented, that one is negated
+bool BigInteger::testBit(size_t bit) const {
+    size_t index = bit / detail::LimbBits;
+    if (index >= mLimbs.size()) {
+        return mSign == Minus;
+    }
+    Limb limb = mLimbs[index];
+    if (mSign == Minus) {
+        size_t lowZeros = 0;
+        while (mLimbs[lowZeros] == 0) {
+            ++lowZeros;
+        }
+        limb = index == lowZeros ? 0 - limb : index > lowZeros ? ~limb : limb;
+    }
+    return (limb >> (bit % detail::LimbBits) & 1) != 0;
+}
+
+size_t BigInteger::countTrailingZeroBits() const {
+    if (mLimbs.empty()) {
+        throw std::domain_error("BigInteger countTrailingZeroBits of zero");
+    }
+    size_t i = 0;
+    while (mLimbs[i] == 0) {
+        ++i;
+    }
+    return i * detail::LimbBits + detail::countTrailingZeroBits(mLimbs[i]);
+}
+
 void BigInteger::changeSign() {
-    if (mNumberString != "0") {
+    if (!mLimbs.empty()) {
         mSign = static_cast<Sign>(-(static_cast<int>(mSign)));
     }
 }
 
-void BigInteger::parseSign() {
-    if (mNumberString.at(0) == '-') {
-        mNumberString.erase(0, 1);
-        mSign = Minus;
+void BigInteger::parseDecimal(std::string_view numberString) {
+    std::from_chars_result result = from_chars(numberString.data(), numberString.data() + numberString.size(), *this);
+    if (result.ec != std::errc() || result.ptr != numberString.data() + numberString.size()) {
+        throw std::runtime_error("BigInteger format error: usage [+-][000]123456789");
     }
-    else if (mNumberString.at(0) == '+') {
-        mNumberString.erase(0, 1);
+}
+void BigInteger::assignDecimal(Sign sign, const char* digits, size_t count) {
+    detail::OperationScope scope(InstrumentedOperation::Parse, detail::decimalDigitsLimbs(count));
+    while (count > 1 && *digits == '0') {
+        ++digits;
+        --count;
     }
+    mLimbs.resize(detail::decimalDigitsLimbs(count));
+    mLimbs.resize(detail::parseDecimalDigits(mLimbs.data(), digits, count));
+    mSign = sign;
+    normalize();
 }
-void BigInteger::skipZeros() {
-    mNumberString.erase(0, countLeadingZeros(mNumberString));
+void BigInteger::normalize() {
+    mLimbs.resize(detail::significantLength(std::as_const(mLimbs).data(), mLimbs.size()));
     // Zero has plus sign
-    if (mNumberString == "0") {
+    if (mLimbs.empty()) {
         mSign = Plus;
     }
 }
-// Compare absolute values of numbers and add less to greater
-void BigInteger::add(const BigInteger &rhs) {
-    if (compareNumberStrings(mNumberString, rhs.mNumberString) >= 0) {
-        sumString(mNumberString, rhs.mNumberString);
+void BigInteger::assign(Sign sign, std::uint64_t magnitude) {
+    detail::OperationScope scope(InstrumentedOperation::Construct, NativeLimbs);
+    Limb limbs[NativeLimbs];
+    mLimbs.assign(limbs, splitMagnitude(limbs, magnitude));
+    mSign = sign;
+    normalize();
+}
+// Adds absolute values in place, the shorter operand is virtually extended with zero limbs
+void BigInteger::add(const Limb* limbs, size_t length) {
+    if (mLimbs.size() < length) {
+        mLimbs.resize(length);
+    }
+    Limb* r = mLimbs.data();
+    Limb carry = detail::addLimbs(r, r, mLimbs.size(), limbs, length);
+    if (carry) {
+        mLimbs.push_back(carry);
+    }
+}
+// Compare absolute values of numbers and subtract less from greater in place
+void BigInteger::sub(const Limb* limbs, size_t length, Sign sign) {
+    if (detail::compareLimbs(std::as_const(mLimbs).data(), mLimbs.size(), limbs, length) >= 0) {
+        Limb* r = mLimbs.data();
+        detail::subtractLimbs(r, r, mLimbs.size(), limbs, length);
+    }
+    else {
+        size_t oldLength = mLimbs.size();
+        mLimbs.resize(length);
+        Limb* r = mLimbs.data();
+        detail::subtractLimbs(r, limbs, length, r, oldLength);
+        mSign = sign;
+    }
+    normalize();
+}
+
+void BigInteger::addValue(Sign sign, std::uint64_t magnitude) {
+    detail::OperationScope scope(InstrumentedOperation::Add, mLimbs.size());
+    Limb limbs[NativeLimbs];
+    size_t length = splitMagnitude(limbs, magnitude);
+    if (mSign == sign) {
+        add(limbs, length);
+    }
+    else {
+        sub(limbs, length, sign);
+    }
+}
+
+void BigInteger::multiplyByValue(Sign sign, std::uint64_t magnitude) {
+    detail::OperationScope scope(InstrumentedOperation::Multiply, mLimbs.size());
+    if (magnitude == 0 || mLimbs.empty()) {
+        mLimbs.clear();
+        mSign = Plus;
+        return;
+    }
+    Limb limbs[NativeLimbs];
+    size_t length = splitMagnitude(limbs, magnitude);
+    if (length == 1) {
+        Limb carry = detail::multiplyByLimb(mLimbs.data(), mLimbs.data(), mLimbs.size(), limbs[0], 0);
+        if (carry) {
+            mLimbs.push_back(carry);
+        }
+    }
+    else {
+        detail::LimbStorage product(mLimbs.resource());
+        product.resize(mLimbs.size() + length);
+        detail::multiplyLimbs(product.data(), std::as_const(mLimbs).data(), mLimbs.size(), limbs, length);
+        mLimbs.swap(product);
+        normalize();
+    }
+    mSign = mSign == sign ? Plus : Minus;
+}
+// A single-limb factor whose product has the accumulator's sign is added limb by limb in place,
+// other products are computed aside and added, which also makes it safe for a and b to alias mLimbs
+void BigInteger::addProduct(const Limb* a, size_t an, const Limb* b, size_t bn, Sign sign) {
+    detail::OperationScope scope(InstrumentedOperation::Multiply, std::max(an, bn));
+    if (an == 0 || bn == 0) {
+        return;
+    }
+    if (an < bn) {
+        std::swap(a, b);
+        std::swap(an, bn);
+    }
+    if (bn == 1 && (mSign == sign || mLimbs.empty()) && a != std::as_const(mLimbs).data()) {
+        Limb factor = b[0];
+        if (mLimbs.size() < an) {
+            mLimbs.resize(an);
+        }
+        Limb* r = mLimbs.data();
+        Limb carry = detail::addMultiplyByLimb(r, a, an, factor);
+        if (mLimbs.size() > an) {
+            carry = detail::addLimbs(r + an, r + an, mLimbs.size() - an, &carry, 1);
+        }
+        if (carry) {
+            mLimbs.push_back(carry);
+        }
+        mSign = sign;
+        return;
+    }
+    Limb stackProduct[ProductStackLimbs];
+    Limb* product = stackProduct;
+    // The buffer of the thread is taken while it's in use, a nested call, like one of a task the thread
+    // runs while it waits for the thread pool, starts a buffer of its own
+    std::vector<Limb> heapProduct;
+    if (an + bn > ProductStackLimbs) {
+        heapProduct.swap(productBuffer);
+        if (heapProduct.size() < an + bn) {
+            heapProduct.resize(an + bn);
+        }
+        product = heapProduct.data();
+    }
+    detail::multiplyLimbs(product, a, an, b, bn);
+    size_t length = detail::significantLength(product, an + bn);
+    if (mSign == sign) {
+        add(product, length);
     }
     else {
-        std::string result = rhs.mNumberString;
-        sumString(result, mNumberString);
-        mNumberString = result;
+        sub(product, length, sign);
+    }
+    if (heapProduct.size() <= MaxKeptProductLimbs && heapProduct.size() > productBuffer.size()) {
+        productBuffer.swap(heapProduct);
     }
 }
-// Compare absolute values of numbers and subtract less from greater
-void BigInteger::sub(const BigInteger &rhs) {
-    if (compareNumberStrings(mNumberString, rhs.mNumberString) >= 0) {
-        subtractString(mNumberString, rhs.mNumberString);
+
+void BigInteger::addProductWithValue(const BigInteger& a, Sign sign, std::uint64_t magnitude) {
+    Limb limbs[NativeLimbs];
+    size_t length = splitMagnitude(limbs, magnitude);
+    addProduct(a.mLimbs.data(), a.mLimbs.size(), limbs, length, a.mSign == sign ? Plus : Minus);
+}
+// The carry stops at the first limb which doesn't wrap around to zero
+void BigInteger::incrementMagnitude() {
+    for (size_t i = 0; i < mLimbs.size(); ++i) {
+        if (++mLimbs[i] != 0) {
+            return;
+        }
+    }
+    mLimbs.push_back(1);
+}
+// The borrow passes through zero limbs, they become all ones
+void BigInteger::decrementMagnitude() {
+    size_t i = 0;
+    while (mLimbs[i]-- == 0) {
+        ++i;
+    }
+    normalize();
+}
+
+// Results are computed into separate buffers first, so the operands may alias them.
+// Single-limb divisors use the precomputed reciprocal and skip the quotient when it's not needed.
+void BigInteger::divide(const BigInteger& dividend, const BigInteger& divisor,
+                        BigInteger* quotient, BigInteger* remainder) {
+    detail::OperationScope scope(InstrumentedOperation::Divide, dividend.mLimbs.size());
+    if (divisor.mLimbs.empty()) {
+        throw std::domain_error("BigInteger division by zero");
+    }
+    Sign quotientSign = dividend.mSign == divisor.mSign ? Plus : Minus;
+    Sign remainderSign = dividend.mSign;
+    size_t dividendLength = dividend.mLimbs.size();
+    size_t divisorLength = divisor.mLimbs.size();
+
+    detail::LimbStorage quotientLimbs(quotient ? quotient->resource() : std::pmr::get_default_resource());
+    detail::LimbStorage remainderLimbs(remainder ? remainder->resource() : std::pmr::get_default_resource());
+    if (dividendLength < divisorLength) {
+        remainderLimbs = dividend.mLimbs;
+    }
+    else if (divisorLength == 1) {
+        detail::LimbDivisor limbDivisor(divisor.mLimbs[0]);
+        if (quotient) {
+            quotientLimbs.resize(dividendLength);
+            remainderLimbs.push_back(limbDivisor.divide(quotientLimbs.data(), dividend.mLimbs.data(), dividendLength));
+        }
+        else {
+            remainderLimbs.push_back(limbDivisor.remainder(dividend.mLimbs.data(), dividendLength));
+        }
     }
     else {
-        std::string result {rhs.mNumberString};
-        subtractString(result, mNumberString);
-        mNumberString = result;
-        mSign = rhs.mSign;
+        quotientLimbs.resize(dividendLength - divisorLength + 1);
+        remainderLimbs.resize(divisorLength);
+        detail::divideLimbs(quotientLimbs.data(), remainderLimbs.data(), dividend.mLimbs.data(), dividendLength,
+                            divisor.mLimbs.data(), divisorLength);
+    }
+
+    if (quotient) {
+        quotient->mLimbs.swap(quotientLimbs);
+        quotient->mSign = quotientSign;
+        quotient->normalize();
     }
-    skipZeros();
+    if (remainder) {
+        remainder->mLimbs.swap(remainderLimbs);
+        remainder->mSign = remainderSign;
+        remainder->normalize();
+    }
+}
+
+int BigInteger::compareMagnitudes(const BigInteger& lhs, const BigInteger& rhs) {
+    return detail::compareLimbs(lhs.mLimbs.data(), lhs.mLimbs.size(),
+                                rhs.mLimbs.data(), rhs.mLimbs.size());
 }
 
-int BigInteger::compareNumberStrings(const std::string& lhs, const std::string& rhs) {
-    if (lhs.size() != rhs.size()) {
-        return lhs.size() - rhs.size();
+std::from_chars_result from_chars(const char* first, const char* last, BigInteger& value) {
+    const char* digits = first;
+    BigInteger::Sign sign = BigInteger::Plus;
+    if (digits != last && (*digits == '-' || *digits == '+')) {
+        sign = *digits == '-' ? BigInteger::Minus : BigInteger::Plus;
+        ++digits;
+    }
+    const char* end = digits;
+    while (end != last && *end >= '0' && *end <= '9') {
+        ++end;
+    }
+    if (end == digits) {
+        return {first, std::errc::invalid_argument};
+    }
+    value.assignDecimal(sign, digits, static_cast<size_t>(end - digits));
+    return {end, std::errc()};
+}
+
+// The digits are printed padded to the bound right in the buffer and moved over the leading zeros.
+// Only a buffer shorter than the bound needs a temporary string to learn the exact length.
+std::to_chars_result to_chars(char* first, char* last, const BigInteger& value) {
+    size_t available = static_cast<size_t>(last - first);
+    size_t bound = value.decimalLengthBound();
+    if (bound > available) {
+        std::string digits = value.toString();
+        if (digits.size() > available) {
+            return {last, std::errc::value_too_large};
+        }
+        return {std::copy(digits.begin(), digits.end(), first), std::errc()};
+    }
+    detail::OperationScope scope(InstrumentedOperation::ToString, value.mLimbs.size());
+    if (value.mLimbs.empty()) {
+        *first = '0';
+        return {first + 1, std::errc()};
+    }
+    char* digits = first;
+    if (value.mSign == BigInteger::Minus) {
+        *digits++ = '-';
+    }
+    size_t width = detail::decimalDigitsBound(value.mLimbs.size());
+    detail::printDecimalDigits(digits, width, value.mLimbs.data(), value.mLimbs.size());
+    size_t zeros = 0;
+    while (digits[zeros] == '0') {
+        ++zeros;
+    }
+    std::memmove(digits, digits + zeros, width - zeros);
+    return {digits + width - zeros, std::errc()};
+}
+
+std::ostream& operator<<(std::ostream& out, const BigInteger& value) {
+    if (out.width() > 0 || value.decimalLengthBound() <= StreamPieceDigits) {
+        return out << value.toString();
+    }
+    detail::OperationScope scope(InstrumentedOperation::ToString, value.mLimbs.size());
+    if (value.mSign == BigInteger::Minus) {
+        out.put('-');
+    }
+    bool leadingZeros = true;
+    auto write = [&](const char* digits, size_t count) {
+        if (leadingZeros) {
+            const char* significant = std::find_if(digits, digits + count, [](char digit) { return digit != '0'; });
+            count -= static_cast<size_t>(significant - digits);
+            digits = significant;
+            leadingZeros = count == 0;
+        }
+        out.write(digits, static_cast<std::streamsize>(count));
+    };
+    detail::writeDecimalDigits(write, StreamPieceDigits, detail::decimalDigitsBound(value.mLimbs.size()),
+                               value.mLimbs.data(), value.mLimbs.size());
+    return out;
+}
+
+std::istream& operator>>(std::istream& in, BigInteger& value) {
+    using Traits = std::istream::traits_type;
+    std::istream::sentry sentry(in);
+    if (!sentry) {
+        return in;
+    }
+    std::streambuf* buffer = in.rdbuf();
+    Traits::int_type c = buffer->sgetc();
+    BigInteger::Sign sign = BigInteger::Plus;
+    if (c == '-' || c == '+') {
+        sign = c == '-' ? BigInteger::Minus : BigInteger::Plus;
+        c = buffer->snextc();
+    }
+    detail::OperationScope scope(InstrumentedOperation::Parse, 0);
+    detail::DecimalParser parser;
+    char digits[StreamReadDigits];
+    size_t count = 0;
+    bool empty = true;
+    while (!Traits::eq_int_type(c, Traits::eof()) && c >= '0' && c <= '9') {
+        digits[count++] = Traits::to_char_type(c);
+        empty = false;
+        if (count == StreamReadDigits) {
+            parser.append(digits, count);
+            count = 0;
+        }
+        c = buffer->snextc();
+    }
+    std::ios_base::iostate state = Traits::eq_int_type(c, Traits::eof()) ? std::ios_base::eofbit
+                                                                          : std::ios_base::goodbit;
+    if (empty) {
+        state |= std::ios_base::failbit;
+    }
+    else {
+        parser.append(digits, count);
+        parser.finish(value.mLimbs);
+        value.mSign = sign;
+        value.normalize();
+        scope.setLimbs(value.mLimbs.size());
     }
-    return lhs.compare(rhs);
+    in.setstate(state);
+    return in;
 }
 
 } // namespace apmath
@@ -1,48 +1,363 @@
 #pragma once
 
+#include <charconv>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <utility>
+
+#include "LimbStorage.hpp"
+#include "NativeIntegers.hpp"
 
 /**
  * Arbitrary-precision math
  */
 namespace apmath {
 
+class BigInteger;
+
+namespace detail {
+
+class LimbAccess;
+
+/**
+ * @brief SumTerm - operand of a lazy sum, see Expression.hpp
+ */
+struct SumTerm {
+    const BigInteger* value;
+    bool negate;
+};
+/**
+ * @brief evaluateSum - assigns the signed sum of count terms to target in one pass
+ */
+void evaluateSum(BigInteger& target, const SumTerm* terms, std::size_t count);
+
+} // namespace detail
+
 /**
  * @brief BigInteger class implements work with arbitrary-precision arithmetic.
  *
  * BigInteger is a simple class for working with arbitrary-precision integer arithmetic.
- * BigInteger supports addition, subtraction and comparison.
+ * BigInteger supports addition, subtraction, multiplication, division and comparison.
+ *
+ * Limbs which don't fit inside the object are allocated from a polymorphic memory resource,
+ * so temporaries of a computation can be carved from an arena and released at once.
+ * Copies share the resource of the source, including the results of binary operators
+ * which copy their left operand, or reuse a temporary right operand. Assignment keeps the resource of the target,
+ * it's the way to move a result out of an arena.
+ *
+ * Built with BIG_NUMBER_SHARED_LIMBS, copies of long numbers share their limbs until one of them is changed,
+ * so a copy costs O(1) and a large constant handed out to many readers is stored once.
  */
 class BigInteger {
+private:
+    enum Sign {
+        Minus = -1,
+        Plus = 1
+    };
+
+    template <typename T>
+    using EnableIfIntegral = detail::EnableIfIntegral<T>;
+    template <typename T>
+    using NativeType = detail::NativeType<T>;
+
 public:
+    /**
+     * @brief BigInteger constructor of zero
+     */
+    BigInteger();
+    /**
+     * @brief BigInteger constructor of zero
+     * @param resource - memory resource of the limbs, it must outlive the number
+     */
+    explicit BigInteger(std::pmr::memory_resource* resource);
     /**
      * @brief BigInteger constructor
      * @param numberString - string representation of
-     * a decimal integer number in format [+-][000]123456789
+     * a decimal integer number in format [+-][000]123456789, the characters are parsed in place
+     * @param resource - memory resource of the limbs, it must outlive the number
      */
-    explicit BigInteger(const std::string& numberString);
+    explicit BigInteger(std::string_view numberString,
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    /**
+     * @brief BigInteger constructor of a native integer, values up to 128 bits don't allocate
+     * @param resource - memory resource of the limbs, it must outlive the number
+     */
+    template <typename T, EnableIfIntegral<T> = 0>
+    BigInteger(T value, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : mLimbs(resource),
+          mSign(Plus)
+    {
+        assign(signOf(static_cast<NativeType<T>>(value)), detail::magnitudeOf(static_cast<NativeType<T>>(value)));
+    }
+    /**
+     * @brief BigInteger copy constructor with another memory resource
+     */
+    BigInteger(const BigInteger& other, std::pmr::memory_resource* resource);
     BigInteger(const BigInteger& other) = default;
     BigInteger& operator=(const BigInteger& other) = default;
     BigInteger(BigInteger&& other) noexcept = default;
-    BigInteger& operator=(BigInteger&& other) noexcept = default;
+    // Copies the limbs if other has an incompatible memory resource
+    BigInteger& operator=(BigInteger&& other) = default;
     ~BigInteger() = default;
 
     BigInteger& operator+=(const BigInteger& rhs);
 
-    friend inline BigInteger operator+(BigInteger lhs, const BigInteger& rhs) {
+    friend inline BigInteger operator+(const BigInteger& lhs, const BigInteger& rhs) {
+        BigInteger sum = lhs.copyWithCapacity(lhs.sumCapacity(rhs.mLimbs.size()));
+        sum += rhs;
+        return sum;
+    }
+    // Temporary operands give their limbs to the result, a + b * c doesn't copy a
+    friend inline BigInteger operator+(BigInteger&& lhs, const BigInteger& rhs) {
         lhs += rhs;
-        return lhs;
+        return std::move(lhs);
+    }
+    friend inline BigInteger operator+(const BigInteger& lhs, BigInteger&& rhs) {
+        rhs += lhs;
+        return std::move(rhs);
+    }
+    friend inline BigInteger operator+(BigInteger&& lhs, BigInteger&& rhs) {
+        lhs += rhs;
+        return std::move(lhs);
+    }
+
+    /**
+     * @brief operator+= - adds a native integer without creating a temporary BigInteger
+     */
+    template <typename T, EnableIfIntegral<T> = 0>
+    BigInteger& operator+=(T rhs) {
+        addValue(signOf(static_cast<NativeType<T>>(rhs)), detail::magnitudeOf(static_cast<NativeType<T>>(rhs)));
+        return *this;
+    }
+
+    template <typename T, EnableIfIntegral<T> = 0>
+    friend inline BigInteger operator+(const BigInteger& lhs, T rhs) {
+        BigInteger sum = lhs.copyWithCapacity(lhs.sumCapacity(NativeLimbs));
+        sum += rhs;
+        return sum;
+    }
+    template <typename T, EnableIfIntegral<T> = 0>
+    friend inline BigInteger operator+(BigInteger&& lhs, T rhs) {
+        lhs += rhs;
+        return std::move(lhs);
+    }
+    template <typename T, EnableIfIntegral<T> = 0>
+    friend inline BigInteger operator+(T lhs, const BigInteger& rhs) {
+        return rhs + lhs;
+    }
+    template <typename T, EnableIfIntegral<T> = 0>
+    friend inline BigInteger operator+(T lhs, BigInteger&& rhs) {
+        return std::move(rhs) + lhs;
     }
 
     BigInteger& operator-=(const BigInteger& other);
 
-    friend inline BigInteger operator-(BigInteger lhs, const BigInteger& rhs) {
+    friend inline BigInteger operator-(const BigInteger& lhs, const BigInteger& rhs) {
+        BigInteger difference = lhs.copyWithCapacity(lhs.sumCapacity(rhs.mLimbs.size()));
+        difference -= rhs;
+        return difference;
+    }
+    friend inline BigInteger operator-(BigInteger&& lhs, const BigInteger& rhs) {
+        lhs -= rhs;
+        return std::move(lhs);
+    }
+    friend inline BigInteger operator-(const BigInteger& lhs, BigInteger&& rhs) {
+        rhs -= lhs;
+        rhs.changeSign();
+        return std::move(rhs);
+    }
+    friend inline BigInteger operator-(BigInteger&& lhs, BigInteger&& rhs) {
+        lhs -= rhs;
+        return std::move(lhs);
+    }
+
+    template <typename T, EnableIfIntegral<T> = 0>
+    BigInteger& operator-=(T rhs) {
+        addValue(signOf(static_cast<NativeType<T>>(rhs)) == Plus ? Minus : Plus,
+                 detail::magnitudeOf(static_cast<NativeType<T>>(rhs)));
+        return *this;
+    }
+
+    template <typename T, EnableIfIntegral<T> = 0>
+    friend inline BigInteger operator-(const BigInteger& lhs, T rhs) {
+        BigInteger difference = lhs.copyWithCapacity(lhs.sumCapacity(NativeLimbs));
+        difference -= rhs;
+        return difference;
+    }
+    template <typename T, EnableIfIntegral<T> = 0>
+    friend inline BigInteger operator-(BigInteger&& lhs, T rhs) {
         lhs -= rhs;
+        return std::move(lhs);
+    }
+    template <typename T, EnableIfIntegral<T> = 0>
+    friend inline BigInteger operator-(T lhs, const BigInteger& rhs) {
+        BigInteger result(lhs);
+        result -= rhs;
+        return result;
+    }
+
+    BigInteger& operator*=(const BigInteger& rhs);
+
+    friend inline BigInteger operator*(BigInteger lhs, const BigInteger& rhs) {
+        lhs *= rhs;
+        return lhs;
+    }
+
+    /**
+     * @brief operator*= - multiplies by a native integer in place
+     */
+    template <typename T, EnableIfIntegral<T> = 0>
+    BigInteger& operator*=(T rhs) {
+        multiplyByValue(signOf(static_cast<NativeType<T>>(rhs)), detail::magnitudeOf(static_cast<NativeType<T>>(rhs)));
+        return *this;
+    }
+
+    template <typename T, EnableIfIntegral<T> = 0>
+    friend inline BigInteger operator*(const BigInteger& lhs, T rhs) {
+        BigInteger product = lhs.copyWithCapacity(lhs.mLimbs.size() + NativeLimbs);
+        product *= rhs;
+        return product;
+    }
+    template <typename T, EnableIfIntegral<T> = 0>
+    friend inline BigInteger operator*(BigInteger&& lhs, T rhs) {
+        lhs *= rhs;
+        return std::move(lhs);
+    }
+    template <typename T, EnableIfIntegral<T> = 0>
+    friend inline BigInteger operator*(T lhs, const BigInteger& rhs) {
+        return rhs * lhs;
+    }
+    template <typename T, EnableIfIntegral<T> = 0>
+    friend inline BigInteger operator*(T lhs, BigInteger&& rhs) {
+        return std::move(rhs) * lhs;
+    }
+
+    /**
+     * @brief addMultiply - adds a * b in place, a and b may be this number.
+     * Products of a native integer are accumulated limb by limb, other products up to
+     * ProductStackLimbs limbs are computed on the stack and longer ones in a buffer the thread keeps
+     * for the following calls, so an accumulator with reserved capacity doesn't allocate from its resource.
+     * Multiplication algorithms beyond schoolbook still use temporary buffers of their own.
+     */
+    BigInteger& addMultiply(const BigInteger& a, const BigInteger& b);
+    /**
+     * @brief subtractMultiply - subtracts a * b in place like addMultiply
+     */
+    BigInteger& subtractMultiply(const BigInteger& a, const BigInteger& b);
+
+    template <typename T, EnableIfIntegral<T> = 0>
+    BigInteger& addMultiply(const BigInteger& a, T b) {
+        addProductWithValue(a, signOf(static_cast<NativeType<T>>(b)), detail::magnitudeOf(static_cast<NativeType<T>>(b)));
+        return *this;
+    }
+    template <typename T, EnableIfIntegral<T> = 0>
+    BigInteger& subtractMultiply(const BigInteger& a, T b) {
+        addProductWithValue(a, signOf(static_cast<NativeType<T>>(b)) == Plus ? Minus : Plus,
+                            detail::magnitudeOf(static_cast<NativeType<T>>(b)));
+        return *this;
+    }
+
+    /**
+     * @brief ProductStackLimbs - longest product addMultiply computes on the stack
+     */
+    static constexpr std::size_t ProductStackLimbs = 4096 / APMATH_LIMB_BITS;
+
+    /**
+     * @brief operator/= - truncating division, the quotient is rounded toward zero
+     * @throw std::domain_error on division by zero
+     */
+    BigInteger& operator/=(const BigInteger& rhs);
+
+    friend inline BigInteger operator/(BigInteger lhs, const BigInteger& rhs) {
+        lhs /= rhs;
+        return lhs;
+    }
+
+    /**
+     * @brief operator%= - remainder of truncating division, it has the dividend's sign
+     * @throw std::domain_error on division by zero
+     */
+    BigInteger& operator%=(const BigInteger& rhs);
+
+    friend inline BigInteger operator%(BigInteger lhs, const BigInteger& rhs) {
+        lhs %= rhs;
+        return lhs;
+    }
+
+    /**
+     * @brief divmod - computes quotient and remainder of truncating division in one pass
+     * @return pair of quotient and remainder
+     * @throw std::domain_error on division by zero
+     */
+    friend std::pair<BigInteger, BigInteger> divmod(const BigInteger& dividend, const BigInteger& divisor);
+
+    /*
+     * Bitwise operators work on the infinite two's complement form like the operators of native signed integers:
+     * -1 has all bits set and x & -x isolates the lowest one bit of x. Limbs of negative operands
+     * are complemented on the fly, word by word, without temporary numbers.
+     */
+    BigInteger& operator&=(const BigInteger& rhs);
+
+    friend inline BigInteger operator&(BigInteger lhs, const BigInteger& rhs) {
+        lhs &= rhs;
+        return lhs;
+    }
+
+    BigInteger& operator|=(const BigInteger& rhs);
+
+    friend inline BigInteger operator|(BigInteger lhs, const BigInteger& rhs) {
+        lhs |= rhs;
+        return lhs;
+    }
+
+    BigInteger& operator^=(const BigInteger& rhs);
+
+    friend inline BigInteger operator^(BigInteger lhs, const BigInteger& rhs) {
+        lhs ^= rhs;
+        return lhs;
+    }
+
+    /**
+     * @brief operator~ - complement of all bits, -x - 1
+     */
+    BigInteger operator~() const {
+        BigInteger result(*this);
+        result.changeSign();
+        --result;
+        return result;
+    }
+
+    /**
+     * @brief operator<<= - multiplies by 2^bits
+     */
+    BigInteger& operator<<=(std::size_t bits);
+
+    friend inline BigInteger operator<<(BigInteger lhs, std::size_t bits) {
+        lhs <<= bits;
+        return lhs;
+    }
+
+    /**
+     * @brief operator>>= - arithmetic shift, divides by 2^bits rounding toward minus infinity
+     */
+    BigInteger& operator>>=(std::size_t bits);
+
+    friend inline BigInteger operator>>(BigInteger lhs, std::size_t bits) {
+        lhs >>= bits;
         return lhs;
     }
 
     BigInteger& operator++() {
-        *this += BigInteger("1");
+        if (mSign == Plus) {
+            incrementMagnitude();
+        }
+        else {
+            decrementMagnitude();
+        }
         return *this;
     }
     BigInteger operator++(int) {
@@ -52,7 +367,13 @@ public:
     }
 
     BigInteger& operator--() {
-        *this -= BigInteger("1");
+        if (mSign == Minus || mLimbs.empty()) {
+            mSign = Minus;
+            incrementMagnitude();
+        }
+        else {
+            decrementMagnitude();
+        }
         return *this;
     }
     BigInteger operator--(int) {
@@ -72,40 +393,142 @@ public:
     }
 
     friend inline bool operator==(const BigInteger& lhs, const BigInteger& rhs) {
-        return lhs.mSign == rhs.mSign && lhs.mNumberString == rhs.mNumberString;
+        return lhs.mSign == rhs.mSign && lhs.mLimbs == rhs.mLimbs;
     }
     friend inline bool operator!=(const BigInteger& lhs, const BigInteger& rhs) { return !(lhs == rhs); }
 
-    friend bool operator< (const BigInteger& lhs, const BigInteger& rhs) {
-        if (lhs.mSign != rhs.mSign) {
-            return lhs.mSign == Minus;
-        }
-        int stringsDiff = compareNumberStrings(lhs.mNumberString, rhs.mNumberString);
-        return lhs.mSign == Plus ? stringsDiff < 0 : stringsDiff > 0 ;
-    }
+    friend bool operator< (const BigInteger& lhs, const BigInteger& rhs) { return compare(lhs, rhs) < 0; }
     friend inline bool operator> (const BigInteger& lhs, const BigInteger& rhs){ return rhs < lhs; }
     friend inline bool operator<=(const BigInteger& lhs, const BigInteger& rhs){ return !(lhs > rhs); }
     friend inline bool operator>=(const BigInteger& lhs, const BigInteger& rhs){ return !(lhs < rhs); }
 
+    /**
+     * @brief compare - three-way comparison. Signs, lengths and top limbs decide most comparisons inline,
+     * only numbers which agree in all of them are compared by the limb kernel.
+     * @return -1, 0 or 1 when lhs is less than, equal to or greater than rhs
+     */
+    friend int compare(const BigInteger& lhs, const BigInteger& rhs) {
+        detail::OperationScope scope(InstrumentedOperation::Compare,
+                                     lhs.mLimbs.size() > rhs.mLimbs.size() ? lhs.mLimbs.size() : rhs.mLimbs.size());
+        if (lhs.mSign != rhs.mSign) {
+            return lhs.mSign;
+        }
+        std::size_t length = lhs.mLimbs.size();
+        if (length != rhs.mLimbs.size()) {
+            return length < rhs.mLimbs.size() ? -lhs.mSign : lhs.mSign;
+        }
+        if (length == 0) {
+            return 0;
+        }
+        Limb lhsTop = lhs.mLimbs[length - 1];
+        Limb rhsTop = rhs.mLimbs[length - 1];
+        if (lhsTop != rhsTop) {
+            return lhsTop < rhsTop ? -lhs.mSign : lhs.mSign;
+        }
+        int magnitudesDiff = compareMagnitudes(lhs, rhs);
+        return magnitudesDiff == 0 ? 0 : magnitudesDiff < 0 ? -lhs.mSign : lhs.mSign;
+    }
+    /**
+     * @brief compare - three-way comparison with a native integer without creating a temporary BigInteger
+     */
+    template <typename T, EnableIfIntegral<T> = 0>
+    friend int compare(const BigInteger& lhs, T rhs) {
+        return lhs.compareWithValue(signOf(static_cast<NativeType<T>>(rhs)), detail::magnitudeOf(static_cast<NativeType<T>>(rhs)));
+    }
+
     /**
      * @brief toString - creates string representation of the decimal integer number
      * @return string representation
      */
-    inline std::string toString() const {
-        return mSign == Plus ? mNumberString : "-" + mNumberString;
+    std::string toString() const;
+    /**
+     * @brief decimalLengthBound - upper bound of the length of toString(), a buffer of this size
+     * always fits the output of to_chars
+     */
+    std::size_t decimalLengthBound() const;
+
+    /**
+     * @brief bitLength - number of bits of the absolute value, zero has none
+     */
+    std::size_t bitLength() const;
+    /**
+     * @brief popcount - number of one bits of the absolute value
+     */
+    std::size_t popcount() const;
+    /**
+     * @brief testBit - bit of the two's complement form, negative numbers have ones above their length
+     */
+    bool testBit(std::size_t bit) const;
+    /**
+     * @brief countTrailingZeroBits - number of low zero bits, the same for x and -x
+     * @throw std::domain_error for zero
+     */
+    std::size_t countTrailingZeroBits() const;
+
+    /**
+     * @brief hash - hash of the sign and the magnitude. The limbs are mixed in 64-bit words with 128-bit products
+     * like wyhash does it, so a key costs about one multiplication per word and the hash doesn't depend on the limb width.
+     */
+    std::size_t hash() const;
+    /**
+     * @brief hashOf - the hash of BigInteger(value) computed without creating the number
+     */
+    template <typename T, EnableIfIntegral<T> = 0>
+    static std::size_t hashOf(T value) {
+        return hashValue(signOf(static_cast<NativeType<T>>(value)), detail::magnitudeOf(static_cast<NativeType<T>>(value)));
     }
 
+    /**
+     * @brief resource - memory resource the limbs are allocated from
+     */
+    std::pmr::memory_resource* resource() const { return mLimbs.resource(); }
+    /**
+     * @brief reserve - makes room for values of up to bits bits, so an accumulator grows once
+     */
+    void reserve(std::size_t bits);
+    /**
+     * @brief capacity - number of bits stored without reallocation. Limbs shared with a copy
+     * are copied with this capacity on the first write.
+     */
+    std::size_t capacity() const;
+
+    friend void detail::evaluateSum(BigInteger& target, const detail::SumTerm* terms, std::size_t count);
+    friend class detail::LimbAccess;
+    friend std::from_chars_result from_chars(const char* first, const char* last, BigInteger& value);
+    friend std::to_chars_result to_chars(char* first, char* last, const BigInteger& value);
+    friend std::ostream& operator<<(std::ostream& out, const BigInteger& value);
+    friend std::istream& operator>>(std::istream& in, BigInteger& value);
+
 private:
-    enum Sign {
-        Minus = -1,
-        Plus = 1
-    };
+    template <typename T>
+    static Sign signOf(T value) { return detail::isNegative(value) ? Minus : Plus; }
+
+    static constexpr std::size_t NativeLimbs = sizeof(std::uint64_t) / sizeof(Limb);
 
     /**
-     * @brief mNumberString - string representation of the absolute value of
-     * the decimal integer number without leading zeros
+     * @brief copyWithCapacity - copy with room for capacity limbs, binary operators which overwrite
+     * the copy allocate their result once
      */
-    std::string mNumberString;
+    BigInteger copyWithCapacity(std::size_t capacity) const {
+        BigInteger result(mLimbs.resource());
+        result.mLimbs.reserve(capacity);
+        result.mLimbs.assign(mLimbs.data(), mLimbs.size());
+        result.mSign = mSign;
+        return result;
+    }
+    /**
+     * @brief sumCapacity - length of a sum with a number of length limbs
+     */
+    std::size_t sumCapacity(std::size_t length) const {
+        return (length > mLimbs.size() ? length : mLimbs.size()) + 1;
+    }
+
+    /**
+     * @brief mLimbs - binary absolute value of the number as little-endian limbs
+     * without high zero limbs, zero has no limbs at all.
+     * Values of up to two 64-bit words are stored inline.
+     */
+    detail::LimbStorage mLimbs;
     /**
      * @brief mSign - number's sign
      */
@@ -116,31 +539,167 @@ private:
      */
     void changeSign();
     /**
-     * @brief parseSign - parses number's sign in input string
+     * @brief parseDecimal - parses sign and decimal digits of the input string
+     */
+    void parseDecimal(std::string_view numberString);
+    /**
+     * @brief assignDecimal - sets the number from a sign and validated decimal digits
      */
-    void parseSign();
+    void assignDecimal(Sign sign, const char* digits, std::size_t count);
     /**
-     * @brief skipZeros - erases leading zeros in constructor and after subtraction
+     * @brief normalize - drops high zero limbs in constructor and after subtraction
      */
-    void skipZeros();
+    void normalize();
+    /**
+     * @brief assign - sets the number from a sign and a native magnitude
+     */
+    void assign(Sign sign, std::uint64_t magnitude);
     /**
      * @brief add - implements addition of the absolute values
-     * @param rhs - BigInteger to add
+     * @param limbs, length - magnitude to add, may alias mLimbs only if it has the same length
      */
-    void add(const BigInteger& rhs);
+    void add(const Limb* limbs, std::size_t length);
     /**
      * @brief sub - implements subtraction of the absolute values
-     * @param rhs - BigInteger to subtract
+     * @param limbs, length - magnitude to subtract, may alias mLimbs only if it has the same length
+     * @param sign - sign of the subtrahend, the result takes it when the subtrahend is greater
+     */
+    void sub(const Limb* limbs, std::size_t length, Sign sign);
+    /**
+     * @brief addValue - adds a native integer given by its sign and magnitude
+     */
+    void addValue(Sign sign, std::uint64_t magnitude);
+    /**
+     * @brief addProduct - adds the product of magnitudes a and b with the given sign
+     * @param a, an, b, bn - magnitudes without high zero limbs, may alias mLimbs
+     */
+    void addProduct(const Limb* a, std::size_t an, const Limb* b, std::size_t bn, Sign sign);
+    /**
+     * @brief addProductWithValue - adds a times a native integer given by its sign and magnitude
      */
-    void sub(const BigInteger& rhs);
+    void addProductWithValue(const BigInteger& a, Sign sign, std::uint64_t magnitude);
     /**
-     * @brief compareNumberStrings - compares the absolute values of the numbers represented by strings
-     * lhs, rhs - string representations of the absolute values of the numbers to compare
-     * @return Negative value if lhs is less than rhs.
-     * Zero if lhs and rhs compare equal.
-     * Positive value if lhs is greater than rhs.
+     * @brief multiplyByValue - multiplies by a native integer given by its sign and magnitude
      */
-    static int compareNumberStrings(const std::string& lhs, const std::string& rhs);
+    void multiplyByValue(Sign sign, std::uint64_t magnitude);
+    /**
+     * @brief compareWithValue - compares with a native integer given by its sign and magnitude like compare()
+     */
+    int compareWithValue(Sign sign, std::uint64_t magnitude) const;
+    /**
+     * @brief hashValue - hash of a native integer given by its sign and magnitude
+     */
+    static std::size_t hashValue(Sign sign, std::uint64_t magnitude);
+    /**
+     * @brief incrementMagnitude - adds one to the absolute value
+     */
+    void incrementMagnitude();
+    /**
+     * @brief decrementMagnitude - subtracts one from the nonzero absolute value
+     */
+    void decrementMagnitude();
+    /**
+     * @brief divide - divides absolute values and sets signs of truncating division
+     * @param quotient, remainder - results, nullptr if not needed, may alias the operands
+     */
+    static void divide(const BigInteger& dividend, const BigInteger& divisor,
+                       BigInteger* quotient, BigInteger* remainder);
+    /**
+     * @brief compareMagnitudes - compares the absolute values of the numbers
+     * lhs, rhs - numbers to compare
+     * @return Negative value if |lhs| is less than |rhs|.
+     * Zero if |lhs| and |rhs| compare equal.
+     * Positive value if |lhs| is greater than |rhs|.
+     */
+    static int compareMagnitudes(const BigInteger& lhs, const BigInteger& rhs);
+};
+
+/**
+ * @brief fma - a * b + c, the result is allocated once at its final length and the product
+ * is computed aside like by addMultiply
+ */
+BigInteger fma(const BigInteger& a, const BigInteger& b, const BigInteger& c);
+
+/**
+ * @brief from_chars - parses a decimal number [+-]123456789 at the beginning of [first, last) like std::from_chars.
+ * Parsing stops at the first character which isn't a digit, ptr of the result points to it.
+ * @return ec is std::errc::invalid_argument and value is unchanged if there are no digits
+ */
+std::from_chars_result from_chars(const char* first, const char* last, BigInteger& value);
+/**
+ * @brief to_chars - writes the decimal representation into [first, last) like std::to_chars,
+ * without a terminating null character
+ * @return ec is std::errc::value_too_large and ptr is last if the buffer is too short
+ */
+std::to_chars_result to_chars(char* first, char* last, const BigInteger& value);
+/**
+ * @brief operator<< - prints the decimal representation, long numbers are converted and written in pieces.
+ * Field width, fill and adjustment of the stream apply like to strings.
+ */
+std::ostream& operator<<(std::ostream& out, const BigInteger& value);
+/**
+ * @brief operator>> - reads a decimal number [+-]123456789 after optional whitespace.
+ * Digits are converted in blocks while they're read, so the text is never kept whole.
+ * Sets failbit and leaves value unchanged if there are no digits.
+ */
+std::istream& operator>>(std::istream& in, BigInteger& value);
+
+/*
+ * Transparent functors for containers keyed by BigInteger. Native integers and decimal strings are hashed and compared
+ * as the numbers they represent, so std::map and std::set (and unordered containers since C++20) find them
+ * without building a key. Integers take no conversion at all, strings are parsed, which doesn't allocate
+ * for up to 38 digits.
+ */
+
+/**
+ * @brief BigIntegerHash - hash of BigInteger keys, native integers and decimal strings
+ */
+struct BigIntegerHash {
+    using is_transparent = void;
+
+    std::size_t operator()(const BigInteger& value) const noexcept { return value.hash(); }
+    template <typename T, detail::EnableIfIntegral<T> = 0>
+    std::size_t operator()(T value) const noexcept { return BigInteger::hashOf(value); }
+    std::size_t operator()(std::string_view text) const { return BigInteger(text).hash(); }
+};
+
+/**
+ * @brief BigIntegerEqual - equality of BigInteger keys with BigInteger, native integers and decimal strings
+ */
+struct BigIntegerEqual {
+    using is_transparent = void;
+
+    bool operator()(const BigInteger& lhs, const BigInteger& rhs) const noexcept { return lhs == rhs; }
+    template <typename T, detail::EnableIfIntegral<T> = 0>
+    bool operator()(const BigInteger& lhs, T rhs) const noexcept { return compare(lhs, rhs) == 0; }
+    template <typename T, detail::EnableIfIntegral<T> = 0>
+    bool operator()(T lhs, const BigInteger& rhs) const noexcept { return compare(rhs, lhs) == 0; }
+    bool operator()(const BigInteger& lhs, std::string_view rhs) const { return lhs == BigInteger(rhs); }
+    bool operator()(std::string_view lhs, const BigInteger& rhs) const { return BigInteger(lhs) == rhs; }
+};
+
+/**
+ * @brief BigIntegerLess - ordering of BigInteger keys with BigInteger, native integers and decimal strings
+ */
+struct BigIntegerLess {
+    using is_transparent = void;
+
+    bool operator()(const BigInteger& lhs, const BigInteger& rhs) const noexcept { return compare(lhs, rhs) < 0; }
+    template <typename T, detail::EnableIfIntegral<T> = 0>
+    bool operator()(const BigInteger& lhs, T rhs) const noexcept { return compare(lhs, rhs) < 0; }
+    template <typename T, detail::EnableIfIntegral<T> = 0>
+    bool operator()(T lhs, const BigInteger& rhs) const noexcept { return compare(rhs, lhs) > 0; }
+    bool operator()(const BigInteger& lhs, std::string_view rhs) const { return compare(lhs, BigInteger(rhs)) < 0; }
+    bool operator()(std::string_view lhs, const BigInteger& rhs) const { return compare(BigInteger(lhs), rhs) < 0; }
 };
 
 } // namespace apmath
+
+namespace std {
+
+template <>
+struct hash<apmath::BigInteger> {
+    std::size_t operator()(const apmath::BigInteger& value) const noexcept { return value.hash(); }
+};
+
+} // namespace std
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "LimbAccess.hpp"
+#include "LimbKernels.hpp"
+
+namespace apmath {
+namespace detail {
+
+/**
+ * @brief ColumnSum - signed sum of many magnitudes kept as double-width column accumulators.
+ * Terms are added without carry propagation, carries run through the columns only when
+ * the accumulators might overflow and once when the sum is stored.
+ */
+class ColumnSum {
+public:
+    /**
+     * @brief MaxPendingTerms - a column starts below B after carries are propagated and every term
+     * adds less than B, so this many terms fit into the double-width accumulator with room for the sign
+     */
+    static constexpr std::size_t MaxPendingTerms = std::size_t(1) << (LimbBits - 2);
+
+    void add(const Limb* limbs, std::size_t n, bool negative) {
+        if (++mPendingTerms > MaxPendingTerms) {
+            propagateCarries();
+            mPendingTerms = 1;
+        }
+        if (mColumns.size() < n) {
+            mColumns.resize(n);
+        }
+        // Signs of columnar data are unpredictable, the limbs are negated without branches:
+        // -x = (x ^ -1) - (-1)
+        SignedDoubleLimb signMask = -static_cast<SignedDoubleLimb>(negative);
+        SignedDoubleLimb* columns = mColumns.data();
+        for (std::size_t i = 0; i < n; ++i) {
+            columns[i] += (static_cast<SignedDoubleLimb>(limbs[i]) ^ signMask) - signMask;
+        }
+    }
+
+    /**
+     * @brief merge - adds the columns of another sum
+     */
+    void merge(const ColumnSum& other) {
+        if (mPendingTerms + other.mPendingTerms > MaxPendingTerms) {
+            propagateCarries();
+            mPendingTerms = 1;
+        }
+        // Up to MaxPendingTerms + 1 terms may be pending now, the columns stay below 2^(2 * LimbBits - 2) + B
+        if (mColumns.size() < other.mColumns.size()) {
+            mColumns.resize(other.mColumns.size());
+        }
+        for (std::size_t i = 0; i < other.mColumns.size(); ++i) {
+            mColumns[i] += other.mColumns[i];
+        }
+        mPendingTerms += other.mPendingTerms;
+    }
+
+    /**
+     * @brief store - assigns the sum to target, carries are propagated on the way
+     * and the columns stay as they are
+     */
+    void store(BigInteger& target) const {
+        LimbStorage& limbs = LimbAccess::limbs(target);
+        limbs.resize(mColumns.size() + 1);
+        Limb* result = limbs.data();
+        // All limbs but the top one end up in [0, B), the top one is the signed final carry,
+        // so the limbs are the sum in two's complement
+        SignedDoubleLimb carry = 0;
+        for (std::size_t i = 0; i < mColumns.size(); ++i) {
+            SignedDoubleLimb sum = mColumns[i] + carry;
+            result[i] = static_cast<Limb>(sum);
+            carry = sum >> LimbBits;
+        }
+        result[mColumns.size()] = static_cast<Limb>(carry);
+        bool negative = carry < 0;
+        if (negative) {
+            negateLimbs(result, result, limbs.size());
+        }
+        LimbAccess::setNegative(target, negative);
+    }
+
+    /**
+     * @brief reserve - makes room for terms of up to limbs limbs
+     */
+    void reserve(std::size_t limbs) {
+        mColumns.reserve(limbs);
+    }
+
+    void clear() {
+        mColumns.clear();
+        mPendingTerms = 0;
+    }
+
+private:
+    std::vector<SignedDoubleLimb> mColumns;
+    std::size_t mPendingTerms = 0;
+
+    void propagateCarries() {
+        SignedDoubleLimb carry = 0;
+        for (SignedDoubleLimb& column : mColumns) {
+            SignedDoubleLimb sum = column + carry;
+            column = static_cast<Limb>(sum);
+            carry = sum >> LimbBits;
+        }
+        if (carry != 0) {
+            mColumns.push_back(carry);
+        }
+    }
+};
+
+} // namespace detail
+} // namespace apmath
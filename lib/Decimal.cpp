@@ -0,0 +1,375 @@
+#include "Decimal.hpp"
+#include "LimbAccess.hpp"
+#include "LimbKernels.hpp"
+#include "NumberTheory.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+using apmath::BigInteger;
+using apmath::Limb;
+using apmath::Rounding;
+using namespace apmath::detail;
+
+// 10^19 is the largest power of ten in 64 bits
+constexpr std::uint32_t NativePowers = 20;
+// Powers of ten below this exponent are computed once, longer ones on every use
+constexpr std::uint32_t CachedPowers = 256;
+// Limbs of a 64-bit word
+constexpr std::size_t WordLimbs = 64 / LimbBits;
+
+constexpr std::array<std::uint64_t, NativePowers> nativePowersOfTen() {
+    std::array<std::uint64_t, NativePowers> powers = {};
+    std::uint64_t power = 1;
+    for (std::uint32_t i = 0; i < NativePowers; ++i) {
+        powers[i] = power;
+        power *= i + 1 < NativePowers ? 10 : 1;
+    }
+    return powers;
+}
+
+constexpr std::array<std::uint64_t, NativePowers> PowersOfTen = nativePowersOfTen();
+
+// Cached powers are used in place, longer ones are computed into scratch
+const BigInteger& powerOfTen(std::uint32_t exponent, BigInteger& scratch) {
+    static const std::vector<BigInteger> cache = [] {
+        std::vector<BigInteger> powers;
+        powers.reserve(CachedPowers);
+        powers.emplace_back(1);
+        for (std::uint32_t i = 1; i < CachedPowers; ++i) {
+            powers.push_back(powers.back() * 10);
+        }
+        return powers;
+    }();
+    if (exponent < CachedPowers) {
+        return cache[exponent];
+    }
+    scratch = apmath::pow(BigInteger(10), exponent);
+    return scratch;
+}
+
+void multiplyByPowerOfTen(BigInteger& value, std::uint32_t exponent) {
+    if (exponent < NativePowers) {
+        value *= PowersOfTen[exponent];
+    }
+    else {
+        BigInteger scratch;
+        value *= powerOfTen(exponent, scratch);
+    }
+}
+
+bool isZero(const BigInteger& value) {
+    return LimbAccess::limbs(value).empty();
+}
+
+/**
+ * @brief roundsAway - true when a truncated quotient has to move one step away from zero
+ * @param inexact - the remainder isn't zero
+ * @param half - sign of twice the remainder minus the divisor, both taken as absolute values
+ * @param odd - the truncated quotient is odd
+ */
+bool roundsAway(Rounding rounding, bool negative, bool inexact, int half, bool odd) {
+    switch (rounding) {
+    case Rounding::HalfEven:
+        return half > 0 || (half == 0 && odd);
+    case Rounding::HalfUp:
+        return half >= 0;
+    case Rounding::HalfDown:
+        return half > 0;
+    case Rounding::Down:
+        return false;
+    case Rounding::Up:
+        return inexact;
+    case Rounding::Floor:
+        return inexact && negative;
+    case Rounding::Ceiling:
+        return inexact && !negative;
+    }
+    return false;
+}
+
+// Quotient of truncating division moved according to the rounding
+BigInteger divideRounded(const BigInteger& numerator, const BigInteger& denominator, Rounding rounding) {
+    std::pair<BigInteger, BigInteger> result = divmod(numerator, denominator);
+    BigInteger& quotient = result.first;
+    BigInteger& remainder = result.second;
+    if (isZero(remainder)) {
+        return quotient;
+    }
+    bool negative = LimbAccess::isNegative(numerator) != LimbAccess::isNegative(denominator);
+    BigInteger magnitude = denominator;
+    LimbAccess::setNegative(magnitude, false);
+    LimbAccess::setNegative(remainder, false);
+    remainder <<= 1;
+    if (roundsAway(rounding, negative, true, compare(remainder, magnitude), quotient.testBit(0))) {
+        quotient += negative ? -1 : 1;
+    }
+    return quotient;
+}
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 Wide;
+
+bool fitsWord(const BigInteger& value) {
+    return LimbAccess::limbs(value).size() <= WordLimbs;
+}
+
+Wide magnitudeOf(const BigInteger& value) {
+    const LimbStorage& limbs = LimbAccess::limbs(value);
+    Wide magnitude = 0;
+    for (std::size_t i = limbs.size(); i-- > 0;) {
+        magnitude = (magnitude << LimbBits) | limbs[i];
+    }
+    return magnitude;
+}
+
+void assignWide(BigInteger& value, Wide magnitude, bool negative) {
+    Limb limbs[2 * WordLimbs];
+    std::size_t n = 0;
+    for (; magnitude != 0; magnitude >>= LimbBits) {
+        limbs[n++] = static_cast<Limb>(magnitude);
+    }
+    LimbAccess::limbs(value).assign(limbs, n);
+    LimbAccess::setNegative(value, negative);
+}
+
+/**
+ * @brief rescaleWide - rounds value / 10^digits in native arithmetic
+ * @return false if value has more than 128 bits or 10^digits more than 64 bits
+ */
+bool rescaleWide(BigInteger& value, std::uint32_t digits, Rounding rounding) {
+    if (digits >= NativePowers || LimbAccess::limbs(value).size() > 2 * WordLimbs) {
+        return false;
+    }
+    Wide magnitude = magnitudeOf(value);
+    std::uint64_t divisor = PowersOfTen[digits];
+    Wide quotient;
+    std::uint64_t remainder;
+    if (magnitude >> 64 == 0) {
+        // 64-bit division is several times faster than the 128-bit one
+        std::uint64_t word = static_cast<std::uint64_t>(magnitude);
+        quotient = word / divisor;
+        remainder = word % divisor;
+    }
+    else {
+        quotient = magnitude / divisor;
+        remainder = static_cast<std::uint64_t>(magnitude % divisor);
+    }
+    bool negative = LimbAccess::isNegative(value);
+    int half = remainder > divisor - remainder ? 1 : remainder == divisor - remainder ? 0 : -1;
+    if (roundsAway(rounding, negative, remainder != 0, half, (quotient & 1) != 0)) {
+        ++quotient;
+    }
+    assignWide(value, quotient, negative);
+    return true;
+}
+#endif
+
+[[noreturn]] void throwFormatError() {
+    throw std::runtime_error("Decimal format error: usage [+-]123.456");
+}
+
+// Parses a nonempty run of digits which has to fill the whole part
+void parseDigits(std::string_view digits, BigInteger& value) {
+    if (digits.empty() || digits[0] < '0' || digits[0] > '9') {
+        throwFormatError();
+    }
+    auto result = apmath::from_chars(digits.data(), digits.data() + digits.size(), value);
+    if (result.ptr != digits.data() + digits.size()) {
+        throwFormatError();
+    }
+}
+} // namespace
+
+namespace apmath {
+
+Decimal::Decimal(std::string_view text) {
+    bool negative = !text.empty() && text[0] == '-';
+    if (!text.empty() && (text[0] == '-' || text[0] == '+')) {
+        text.remove_prefix(1);
+    }
+    std::size_t point = text.find('.');
+    parseDigits(text.substr(0, point), mCoefficient);
+    if (point != std::string_view::npos) {
+        std::string_view fraction = text.substr(point + 1);
+        if (fraction.size() > std::numeric_limits<std::uint32_t>::max()) {
+            throwFormatError();
+        }
+        BigInteger fractionDigits;
+        parseDigits(fraction, fractionDigits);
+        mScale = static_cast<std::uint32_t>(fraction.size());
+        multiplyByPowerOfTen(mCoefficient, mScale);
+        mCoefficient += fractionDigits;
+    }
+    LimbAccess::setNegative(mCoefficient, negative);
+}
+
+void Decimal::alignScale(std::uint32_t scale) {
+    if (scale > mScale) {
+        multiplyByPowerOfTen(mCoefficient, scale - mScale);
+        mScale = scale;
+    }
+}
+
+Decimal& Decimal::operator+=(const Decimal& rhs) {
+    alignScale(rhs.mScale);
+    std::uint32_t digits = mScale - rhs.mScale;
+    if (digits == 0) {
+        mCoefficient += rhs.mCoefficient;
+    }
+    else if (digits < NativePowers) {
+        mCoefficient.addMultiply(rhs.mCoefficient, PowersOfTen[digits]);
+    }
+    else {
+        BigInteger scratch;
+        mCoefficient.addMultiply(rhs.mCoefficient, powerOfTen(digits, scratch));
+    }
+    return *this;
+}
+
+Decimal& Decimal::operator-=(const Decimal& rhs) {
+    alignScale(rhs.mScale);
+    std::uint32_t digits = mScale - rhs.mScale;
+    if (digits == 0) {
+        mCoefficient -= rhs.mCoefficient;
+    }
+    else if (digits < NativePowers) {
+        mCoefficient.subtractMultiply(rhs.mCoefficient, PowersOfTen[digits]);
+    }
+    else {
+        BigInteger scratch;
+        mCoefficient.subtractMultiply(rhs.mCoefficient, powerOfTen(digits, scratch));
+    }
+    return *this;
+}
+
+Decimal& Decimal::operator*=(const Decimal& rhs) {
+    std::uint64_t scale = static_cast<std::uint64_t>(mScale) + rhs.mScale;
+    if (scale > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::overflow_error("Decimal scale overflow");
+    }
+#if defined(__SIZEOF_INT128__)
+    if (fitsWord(mCoefficient) && fitsWord(rhs.mCoefficient)) {
+        bool negative = LimbAccess::isNegative(mCoefficient) != LimbAccess::isNegative(rhs.mCoefficient);
+        assignWide(mCoefficient, magnitudeOf(mCoefficient) * magnitudeOf(rhs.mCoefficient), negative);
+    }
+    else {
+        mCoefficient *= rhs.mCoefficient;
+    }
+#else
+    mCoefficient *= rhs.mCoefficient;
+#endif
+    mScale = static_cast<std::uint32_t>(scale);
+    return *this;
+}
+
+Decimal& Decimal::rescale(std::uint32_t scale, Rounding rounding) {
+    if (scale >= mScale) {
+        alignScale(scale);
+        return *this;
+    }
+    std::uint32_t digits = mScale - scale;
+    mScale = scale;
+    if (isZero(mCoefficient)) {
+        return *this;
+    }
+#if defined(__SIZEOF_INT128__)
+    if (rescaleWide(mCoefficient, digits, rounding)) {
+        return *this;
+    }
+#endif
+    if (digits > mCoefficient.decimalLengthBound()) {
+        // The value is below a tenth of the last kept digit, only directed rounding gives a nonzero result
+        bool negative = LimbAccess::isNegative(mCoefficient);
+        bool away = roundsAway(rounding, negative, true, -1, false);
+        mCoefficient = away ? (negative ? -1 : 1) : 0;
+        return *this;
+    }
+    BigInteger scratch;
+    mCoefficient = divideRounded(mCoefficient, powerOfTen(digits, scratch), rounding);
+    return *this;
+}
+
+Decimal& Decimal::normalize() {
+    if (isZero(mCoefficient)) {
+        mScale = 0;
+        return *this;
+    }
+    // Every trailing decimal zero is also a trailing binary zero
+    std::size_t zeros = std::min<std::size_t>(mScale, mCoefficient.countTrailingZeroBits());
+    for (std::uint32_t step = NativePowers - 1; zeros > 0; ) {
+        step = static_cast<std::uint32_t>(std::min<std::size_t>(step, zeros));
+        std::pair<BigInteger, BigInteger> result = divmod(mCoefficient, BigInteger(PowersOfTen[step]));
+        if (!isZero(result.second)) {
+            if (step == 1) {
+                break;
+            }
+            step /= 2;
+            continue;
+        }
+        mCoefficient = std::move(result.first);
+        mScale -= step;
+        zeros -= step;
+    }
+    return *this;
+}
+
+Decimal divide(const Decimal& dividend, const Decimal& divisor, std::uint32_t scale, Rounding rounding) {
+    if (isZero(divisor.mCoefficient)) {
+        throw std::domain_error("Decimal division by zero");
+    }
+    // dividend / divisor = dividend.c * 10^(divisor.s - dividend.s) / divisor.c, scaled by 10^scale
+    std::int64_t exponent = static_cast<std::int64_t>(scale) + divisor.mScale - dividend.mScale;
+    if (exponent >= 0) {
+        BigInteger numerator = dividend.mCoefficient;
+        multiplyByPowerOfTen(numerator, static_cast<std::uint32_t>(exponent));
+        return Decimal(divideRounded(numerator, divisor.mCoefficient, rounding), scale);
+    }
+    BigInteger denominator = divisor.mCoefficient;
+    multiplyByPowerOfTen(denominator, static_cast<std::uint32_t>(-exponent));
+    return Decimal(divideRounded(dividend.mCoefficient, denominator, rounding), scale);
+}
+
+int compare(const Decimal& lhs, const Decimal& rhs) {
+    if (lhs.mScale == rhs.mScale) {
+        return compare(lhs.mCoefficient, rhs.mCoefficient);
+    }
+    int lhsSign = compare(lhs.mCoefficient, 0);
+    int rhsSign = compare(rhs.mCoefficient, 0);
+    if (lhsSign != rhsSign || lhsSign == 0) {
+        return lhsSign < rhsSign ? -1 : lhsSign > rhsSign ? 1 : 0;
+    }
+    if (lhs.mScale < rhs.mScale) {
+        Decimal aligned = lhs;
+        aligned.alignScale(rhs.mScale);
+        return compare(aligned.mCoefficient, rhs.mCoefficient);
+    }
+    Decimal aligned = rhs;
+    aligned.alignScale(lhs.mScale);
+    return compare(lhs.mCoefficient, aligned.mCoefficient);
+}
+
+std::string Decimal::toString() const {
+    std::string text = mCoefficient.toString();
+    if (mScale == 0) {
+        return text;
+    }
+    std::size_t sign = text[0] == '-' ? 1 : 0;
+    std::size_t digits = text.size() - sign;
+    if (digits <= mScale) {
+        text.insert(sign, mScale + 1 - digits, '0');
+    }
+    text.insert(text.size() - mScale, 1, '.');
+    return text;
+}
+
+std::ostream& operator<<(std::ostream& out, const Decimal& value) {
+    return out << value.toString();
+}
+
+} // namespace apmath
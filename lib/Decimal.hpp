@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "BigInteger.hpp"
+#include "NativeIntegers.hpp"
+
+/**
+ * Scaled decimal numbers for exact money arithmetic.
+ * Decimal keeps a BigInteger coefficient and a scale, its value is coefficient / 10^scale.
+ * Addition, subtraction and multiplication are exact and never round: sums get the larger scale
+ * of the operands, products the sum of the scales. Rounding happens only when the scale is reduced
+ * by rescale() or a quotient is computed by divide(), with an explicit rounding mode.
+ * Coefficients up to 128 bits are kept inside the numbers, products and rescaling of coefficients
+ * up to 64 bits use native 128-bit arithmetic, and powers of ten are computed once and shared.
+ */
+namespace apmath {
+
+/**
+ * @brief Rounding - direction of rounding when digits are dropped
+ */
+enum class Rounding {
+    HalfEven,  // to the nearest, ties to the even neighbour (banker's rounding)
+    HalfUp,    // to the nearest, ties away from zero
+    HalfDown,  // to the nearest, ties toward zero
+    Down,      // toward zero, truncation
+    Up,        // away from zero
+    Floor,     // toward minus infinity
+    Ceiling    // toward plus infinity
+};
+
+/**
+ * @brief Decimal - exact decimal number coefficient * 10^-scale
+ */
+class Decimal {
+public:
+    /**
+     * @brief Decimal constructor of zero with scale 0
+     */
+    Decimal() = default;
+    /**
+     * @brief Decimal constructor of a native integer with scale 0
+     */
+    template <typename T, detail::EnableIfIntegral<T> = 0>
+    Decimal(T value)
+        : mCoefficient(value)
+    {}
+    /**
+     * @brief Decimal constructor of coefficient / 10^scale, Decimal(12345, 2) is 123.45
+     */
+    Decimal(BigInteger coefficient, std::uint32_t scale)
+        : mCoefficient(std::move(coefficient)),
+          mScale(scale)
+    {}
+    /**
+     * @brief Decimal constructor
+     * @param text - decimal number in format [+-]123.456, the scale is the number of fraction digits
+     * @throw std::runtime_error if the text isn't a number
+     */
+    explicit Decimal(std::string_view text);
+
+    const BigInteger& coefficient() const { return mCoefficient; }
+    std::uint32_t scale() const { return mScale; }
+
+    Decimal& operator+=(const Decimal& rhs);
+    friend inline Decimal operator+(Decimal lhs, const Decimal& rhs) {
+        lhs += rhs;
+        return lhs;
+    }
+
+    Decimal& operator-=(const Decimal& rhs);
+    friend inline Decimal operator-(Decimal lhs, const Decimal& rhs) {
+        lhs -= rhs;
+        return lhs;
+    }
+
+    /**
+     * @brief operator*= - exact product, its scale is the sum of the scales
+     */
+    Decimal& operator*=(const Decimal& rhs);
+    friend inline Decimal operator*(Decimal lhs, const Decimal& rhs) {
+        lhs *= rhs;
+        return lhs;
+    }
+
+    Decimal operator-() const {
+        return Decimal(-mCoefficient, mScale);
+    }
+
+    /**
+     * @brief rescale - changes the scale, the value is rounded when fraction digits are dropped
+     */
+    Decimal& rescale(std::uint32_t scale, Rounding rounding = Rounding::HalfEven);
+    /**
+     * @brief rescaled - copy with another scale like rescale()
+     */
+    Decimal rescaled(std::uint32_t scale, Rounding rounding = Rounding::HalfEven) const {
+        Decimal result = *this;
+        result.rescale(scale, rounding);
+        return result;
+    }
+    /**
+     * @brief normalize - drops trailing zero fraction digits, the value doesn't change
+     */
+    Decimal& normalize();
+
+    friend Decimal divide(const Decimal& dividend, const Decimal& divisor, std::uint32_t scale, Rounding rounding);
+    friend int compare(const Decimal& lhs, const Decimal& rhs);
+
+    friend inline bool operator==(const Decimal& lhs, const Decimal& rhs) { return compare(lhs, rhs) == 0; }
+    friend inline bool operator!=(const Decimal& lhs, const Decimal& rhs) { return compare(lhs, rhs) != 0; }
+    friend inline bool operator< (const Decimal& lhs, const Decimal& rhs) { return compare(lhs, rhs) < 0; }
+    friend inline bool operator> (const Decimal& lhs, const Decimal& rhs) { return compare(lhs, rhs) > 0; }
+    friend inline bool operator<=(const Decimal& lhs, const Decimal& rhs) { return compare(lhs, rhs) <= 0; }
+    friend inline bool operator>=(const Decimal& lhs, const Decimal& rhs) { return compare(lhs, rhs) >= 0; }
+
+    /**
+     * @brief toString - decimal representation with exactly scale() fraction digits, like -0.050
+     */
+    std::string toString() const;
+
+private:
+    BigInteger mCoefficient;
+    std::uint32_t mScale = 0;
+
+    /**
+     * @brief alignScale - multiplies the coefficient by a power of ten to reach the larger scale
+     */
+    void alignScale(std::uint32_t scale);
+};
+
+/**
+ * @brief divide - quotient rounded to the given scale
+ * @throw std::domain_error on division by zero
+ */
+Decimal divide(const Decimal& dividend, const Decimal& divisor, std::uint32_t scale,
+               Rounding rounding = Rounding::HalfEven);
+/**
+ * @brief compare - three-way comparison of the values, 1.50 and 1.5 are equal
+ */
+int compare(const Decimal& lhs, const Decimal& rhs);
+/**
+ * @brief operator<< - prints the value like toString()
+ */
+std::ostream& operator<<(std::ostream& out, const Decimal& value);
+
+} // namespace apmath
@@ -0,0 +1,218 @@
+#include "Division.hpp"
+#include "LimbKernels.hpp"
+#include "Multiplication.hpp"
+
+#include <algorithm>
+
+namespace {
+using apmath::Limb;
+using namespace apmath::detail;
+
+// Divisors and quotients shorter than this are handled by Knuth's algorithm D,
+// longer ones by multiplication with the Newton reciprocal.
+constexpr size_t NewtonThreshold = 96;
+
+const Limb One[1] = {1};
+
+// Knuth's algorithm D (TAOCP vol. 2, 4.3.1) for a normalized divisor: every quotient limb
+// is estimated from the top two limbs of the current remainder and corrected at most twice.
+// u has an + 1 limbs and is replaced by the remainder.
+void divideNormalized(Limb* q, Limb* u, size_t an, const Limb* v, size_t bn) {
+    const DoubleLimb base = DoubleLimb(1) << LimbBits;
+    for (size_t j = an - bn + 1; j-- > 0; ) {
+        DoubleLimb numerator = (static_cast<DoubleLimb>(u[j + bn]) << LimbBits) | u[j + bn - 1];
+        DoubleLimb estimate = numerator / v[bn - 1];
+        DoubleLimb estimateRemainder = numerator % v[bn - 1];
+        while (estimate >= base ||
+               estimate * v[bn - 2] > ((estimateRemainder << LimbBits) | u[j + bn - 2])) {
+            --estimate;
+            estimateRemainder += v[bn - 1];
+            if (estimateRemainder >= base) {
+                break;
+            }
+        }
+
+        Limb quotientLimb = static_cast<Limb>(estimate);
+        Limb borrow = subtractMultiplyByLimb(u + j, v, bn, quotientLimb);
+        Limb top = u[j + bn];
+        u[j + bn] = top - borrow;
+        if (top < borrow) {
+            // The estimate was one too large: add the divisor back
+            --quotientLimb;
+            u[j + bn] += addLimbs(u + j, u + j, bn, v, bn);
+        }
+        q[j] = quotientLimb;
+    }
+}
+
+void divideKnuth(Limb* q, Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn) {
+    unsigned shift = countLeadingZeroBits(b[bn - 1]);
+    std::vector<Limb> divisor(bn);
+    std::vector<Limb> remainder(an + 1);
+    shiftLeftLimbs(divisor.data(), b, bn, shift);
+    remainder[an] = shiftLeftLimbs(remainder.data(), a, an, shift);
+    divideNormalized(q, remainder.data(), an, divisor.data(), bn);
+    shiftRightLimbs(r, remainder.data(), bn, shift);
+}
+
+// x = floor((B^2n - 1) / d) for a normalized n-limb d, x has n + 2 limbs of room.
+void reciprocalBasecase(Limb* x, const Limb* d, size_t n) {
+    std::vector<Limb> numerator(2 * n + 1, ~Limb(0));
+    numerator[2 * n] = 0;
+    std::vector<Limb> quotient(n + 1);
+    divideNormalized(quotient.data(), numerator.data(), 2 * n, d, n);
+    std::copy(quotient.begin(), quotient.end(), x);
+    x[n + 1] = 0;
+}
+
+// Fixes an approximate x = floor((B^2n - 1) / d) by adding or subtracting units.
+// x has n + 2 limbs of room, the Newton step leaves it a few units off.
+void correctReciprocal(Limb* x, const Limb* d, size_t n) {
+    std::vector<Limb> product(2 * n + 2);
+    multiplyLimbs(product.data(), d, n, x, n + 2);
+    // d * x > B^2n - 1 exactly when the product reaches B^2n
+    while (significantLength(product.data(), product.size()) > 2 * n) {
+        subtractLimbs(product.data(), product.data(), product.size(), d, n);
+        subtractLimbs(x, x, n + 2, One, 1);
+    }
+    std::vector<Limb> remainder(2 * n, ~Limb(0));
+    subtractLimbs(remainder.data(), remainder.data(), 2 * n, product.data(), 2 * n);
+    while (compareLimbs(remainder.data(), significantLength(remainder.data(), 2 * n), d, n) >= 0) {
+        subtractLimbs(remainder.data(), remainder.data(), 2 * n, d, n);
+        addLimbs(x, x, n + 2, One, 1);
+    }
+}
+
+// Newton iteration x' = x + x * (1 - d * x) from the reciprocal of the top half of d.
+// With xh = floor((B^2h - 1) / dh) for the top h limbs dh:
+// x = xh * B^(n-h) + xh * (B^(n+h) - d * xh) / B^2h
+// Each level costs a few multiplications of its size, so the total is O(M(n)).
+void computeReciprocal(Limb* x, const Limb* d, size_t n) {
+    if (n < NewtonThreshold) {
+        reciprocalBasecase(x, d, n);
+        return;
+    }
+    size_t h = (n + 1) / 2;
+    std::vector<Limb> xh(h + 2);
+    computeReciprocal(xh.data(), d + n - h, h);
+
+    // error = B^(n+h) - d * xh, its sign decides the direction of the correction
+    std::vector<Limb> product(n + h + 2);
+    multiplyLimbs(product.data(), d, n, xh.data(), h + 1);
+    std::vector<Limb> error(n + h + 2);
+    error[n + h] = 1;
+    bool negative = compareLimbs(product.data(), significantLength(product.data(), product.size()),
+                                 error.data(), n + h + 1) > 0;
+    if (negative) {
+        subtractLimbs(error.data(), product.data(), error.size(), error.data(), error.size());
+    }
+    else {
+        subtractLimbs(error.data(), error.data(), error.size(), product.data(), product.size());
+    }
+    size_t errorLength = significantLength(error.data(), error.size());
+
+    std::fill(x, x + n + 2, Limb(0));
+    std::copy(xh.begin(), xh.begin() + static_cast<std::ptrdiff_t>(h + 1), x + n - h);
+    if (errorLength > 0) {
+        std::vector<Limb> step(h + 1 + errorLength);
+        multiplyLimbs(step.data(), xh.data(), h + 1, error.data(), errorLength);
+        if (step.size() > 2 * h) {
+            // |x - xh * B^(n-h)| is far below B^n, so the shifted step fits into x
+            const Limb* shifted = step.data() + 2 * h;
+            size_t shiftedLength = significantLength(shifted, step.size() - 2 * h);
+            if (negative) {
+                subtractLimbs(x, x, n + 2, shifted, shiftedLength);
+            }
+            else {
+                addLimbs(x, x, n + 2, shifted, shiftedLength);
+            }
+        }
+    }
+    correctReciprocal(x, d, n);
+}
+
+// The quotient of u < d * B^n by the normalized n-limb d, u has 2n limbs.
+// q = floor(top(u) * x / B^(n+1)) underestimates by at most three, the rest is corrected.
+// q has n limbs, u is replaced by the remainder.
+void divideBlock(Limb* q, Limb* u, const Limb* d, const Limb* x, size_t n) {
+    std::vector<Limb> estimate(2 * n + 2);
+    multiplyLimbs(estimate.data(), u + n - 1, n + 1, x, n + 1);
+    std::copy(estimate.begin() + static_cast<std::ptrdiff_t>(n + 1),
+              estimate.begin() + static_cast<std::ptrdiff_t>(2 * n + 1), q);
+
+    std::vector<Limb> product(2 * n);
+    multiplyLimbs(product.data(), q, n, d, n);
+    subtractLimbs(u, u, 2 * n, product.data(), 2 * n);
+    while (compareLimbs(u, significantLength(u, 2 * n), d, n) >= 0) {
+        subtractLimbs(u, u, 2 * n, d, n);
+        addLimbs(q, q, n, One, 1);
+    }
+}
+}
+
+namespace apmath {
+namespace detail {
+
+Reciprocal::Reciprocal(const Limb* d, size_t n)
+    : mDivisor(n),
+      mInverse(n + 2),
+      mShift(countLeadingZeroBits(d[n - 1]))
+{
+    shiftLeftLimbs(mDivisor.data(), d, n, mShift);
+    computeReciprocal(mInverse.data(), mDivisor.data(), n);
+}
+
+// Schoolbook division in base B^n: the normalized dividend is cut into n-limb blocks
+// from the top, every block with the running remainder is divided by divideBlock.
+// The incomplete top block is less than d, so it starts as the remainder.
+void Reciprocal::divide(Limb* q, Limb* r, const Limb* a, size_t an) const {
+    size_t n = mDivisor.size();
+    std::vector<Limb> dividend(an + 1);
+    dividend[an] = shiftLeftLimbs(dividend.data(), a, an, mShift);
+    size_t length = significantLength(dividend.data(), dividend.size());
+    size_t blocks = length / n;
+
+    std::fill(q, q + an - n + 1, Limb(0));
+    std::vector<Limb> window(2 * n);
+    std::copy(dividend.begin() + static_cast<std::ptrdiff_t>(blocks * n),
+              dividend.begin() + static_cast<std::ptrdiff_t>(length), window.begin());
+    for (size_t block = blocks; block-- > 0; ) {
+        // window = remainder * B^n + block
+        bool emptyRemainder = significantLength(window.data(), n) == 0;
+        std::copy(window.begin(), window.begin() + static_cast<std::ptrdiff_t>(n),
+                  window.begin() + static_cast<std::ptrdiff_t>(n));
+        std::copy(dividend.begin() + static_cast<std::ptrdiff_t>(block * n),
+                  dividend.begin() + static_cast<std::ptrdiff_t>(block * n + n), window.begin());
+        if (emptyRemainder) {
+            // A lone block of the normalized divisor's length is less than 2d
+            std::fill(window.begin() + static_cast<std::ptrdiff_t>(n), window.end(), Limb(0));
+            if (compareLimbs(window.data(), significantLength(window.data(), n), mDivisor.data(), n) >= 0) {
+                subtractLimbs(window.data(), window.data(), n, mDivisor.data(), n);
+                q[block * n] = 1;
+            }
+        }
+        else {
+            std::vector<Limb> blockQuotient(n);
+            divideBlock(blockQuotient.data(), window.data(), mDivisor.data(), mInverse.data(), n);
+            std::copy(blockQuotient.begin(),
+                      blockQuotient.begin() + static_cast<std::ptrdiff_t>(std::min(n, an - n + 1 - block * n)),
+                      q + block * n);
+        }
+    }
+    shiftRightLimbs(r, window.data(), n, mShift);
+}
+
+void divideLimbs(Limb* q, Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn) {
+    if (bn == 1) {
+        r[0] = divideByLimb(q, a, an, b[0]);
+    }
+    else if (bn < NewtonThreshold || an - bn < NewtonThreshold) {
+        divideKnuth(q, r, a, an, b, bn);
+    }
+    else {
+        Reciprocal(b, bn).divide(q, r, a, an);
+    }
+}
+
+} // namespace detail
+} // namespace apmath
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "BigInteger.hpp"
+
+namespace apmath {
+namespace detail {
+
+/**
+ * @brief Reciprocal - multi-limb divisor with its reciprocal floor((B^2n - 1) / d)
+ * computed by Newton iteration. Division by it costs a few multiplications,
+ * so repeated divisions by the same number should share one Reciprocal.
+ */
+class Reciprocal {
+public:
+    /**
+     * @brief Reciprocal constructor
+     * @param d, n - divisor without high zero limbs, n > 0
+     */
+    Reciprocal(const Limb* d, std::size_t n);
+
+    std::size_t size() const { return mDivisor.size(); }
+
+    /**
+     * @brief divide - computes q = a / d and r = a % d
+     * @param q - quotient with room for an - size() + 1 limbs
+     * @param r - remainder with room for size() limbs
+     * @param a, an - dividend, an >= size()
+     */
+    void divide(Limb* q, Limb* r, const Limb* a, std::size_t an) const;
+
+private:
+    // Normalized divisor: shifted left until its top bit is set
+    std::vector<Limb> mDivisor;
+    std::vector<Limb> mInverse;
+    unsigned mShift;
+};
+
+/**
+ * @brief divideLimbs - computes q = a / b and r = a % b
+ * @param q - quotient with room for an - bn + 1 limbs
+ * @param r - remainder with room for bn limbs
+ * @param a, an - dividend, an >= bn
+ * @param b, bn - divisor without high zero limbs
+ */
+void divideLimbs(Limb* q, Limb* r, const Limb* a, std::size_t an, const Limb* b, std::size_t bn);
+
+} // namespace detail
+} // namespace apmath
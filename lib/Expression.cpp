@@ -0,0 +1,97 @@
+#include "Expression.hpp"
+#include "LimbKernels.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace apmath {
+namespace detail {
+
+namespace {
+
+constexpr size_t InlineOperands = 32;
+
+struct Operand {
+    const BigInteger* value;
+    const Limb* limbs;
+    size_t length;
+};
+
+} // namespace
+
+// Every column adds and subtracts the limbs of all terms at once and passes a signed carry
+// to the next column, so the terms are read once and the result is written once.
+// Columns below the shortest term don't check term lengths.
+// A negative total ends up in two's complement and is negated at the end.
+void evaluateSum(BigInteger& target, const SumTerm* terms, size_t count) {
+    Operand inlineOperands[InlineOperands];
+    std::vector<Operand> heapOperands;
+    Operand* operands = inlineOperands;
+    if (count > InlineOperands) {
+        heapOperands.resize(count);
+        operands = heapOperands.data();
+    }
+
+    // The target may be one of the terms, so lengths and signs are taken before it changes.
+    // Added terms go first and subtracted ones after them, the columns don't branch on signs.
+    size_t addedCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        addedCount += (terms[i].value->mSign == BigInteger::Minus) == terms[i].negate;
+    }
+    size_t length = 0;
+    size_t commonLength = terms[0].value->mLimbs.size();
+    for (size_t i = 0, added = 0, subtracted = addedCount; i < count; ++i) {
+        const BigInteger& value = *terms[i].value;
+        bool isAdded = (value.mSign == BigInteger::Minus) == terms[i].negate;
+        operands[isAdded ? added++ : subtracted++] = Operand{&value, nullptr, value.mLimbs.size()};
+        length = std::max(length, value.mLimbs.size());
+        commonLength = std::min(commonLength, value.mLimbs.size());
+    }
+    target.mLimbs.resize(length + 1);
+    for (size_t i = 0; i < count; ++i) {
+        operands[i].limbs = operands[i].value->mLimbs.data();
+    }
+
+    // Column i of the target is read as a term before it's overwritten
+    Limb* r = target.mLimbs.data();
+    SignedDoubleLimb carry = 0;
+    size_t column = 0;
+    for ( ; column < commonLength; ++column) {
+        SignedDoubleLimb sum = carry;
+        for (size_t i = 0; i < addedCount; ++i) {
+            sum += operands[i].limbs[column];
+        }
+        for (size_t i = addedCount; i < count; ++i) {
+            sum -= operands[i].limbs[column];
+        }
+        r[column] = static_cast<Limb>(sum);
+        carry = sum >> LimbBits;
+    }
+    for ( ; column < length; ++column) {
+        SignedDoubleLimb sum = carry;
+        for (size_t i = 0; i < count; ++i) {
+            if (column >= operands[i].length) {
+                continue;
+            }
+            if (i < addedCount) {
+                sum += operands[i].limbs[column];
+            }
+            else {
+                sum -= operands[i].limbs[column];
+            }
+        }
+        r[column] = static_cast<Limb>(sum);
+        carry = sum >> LimbBits;
+    }
+    r[length] = static_cast<Limb>(carry);
+
+    target.mSign = BigInteger::Plus;
+    if (carry < 0) {
+        negateLimbs(r, r, length + 1);
+        target.mSign = BigInteger::Minus;
+    }
+    target.normalize();
+}
+
+} // namespace detail
+} // namespace apmath
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "BigInteger.hpp"
+
+/**
+ * Opt-in lazy arithmetic.
+ * A chain of additions and subtractions started with lazy() doesn't create temporaries:
+ * it collects references to its operands and is evaluated in a single pass over all of them
+ * straight into the destination's limbs.
+ *
+ *     BigInteger total = lazy(a) + b - c + d;
+ *     (lazy(total) - e).assignTo(total);
+ */
+namespace apmath {
+
+/**
+ * @brief SumExpression - lazy signed sum of N BigInteger terms.
+ * The expression refers to its operands, so it has to be evaluated while they are alive,
+ * expressions with temporary operands should be evaluated in the same full-expression.
+ */
+template <std::size_t N>
+class SumExpression {
+public:
+    explicit SumExpression(const std::array<detail::SumTerm, N>& terms)
+        : mTerms(terms)
+    {}
+
+    /**
+     * @brief assignTo - evaluates the expression into target reusing its limbs
+     * @param target - result, it may be one of the terms
+     */
+    void assignTo(BigInteger& target) const {
+        detail::evaluateSum(target, mTerms.data(), N);
+    }
+
+    /**
+     * @brief operator BigInteger - evaluates the expression,
+     * the result uses the memory resource of the first term
+     */
+    operator BigInteger() const {
+        BigInteger result(mTerms[0].value->resource());
+        assignTo(result);
+        return result;
+    }
+
+    SumExpression operator-() const {
+        SumExpression negated(*this);
+        for (detail::SumTerm& term : negated.mTerms) {
+            term.negate = !term.negate;
+        }
+        return negated;
+    }
+
+    const std::array<detail::SumTerm, N>& terms() const { return mTerms; }
+
+private:
+    std::array<detail::SumTerm, N> mTerms;
+};
+
+/**
+ * @brief lazy - starts a lazy expression with a single term
+ */
+inline SumExpression<1> lazy(const BigInteger& value) {
+    return SumExpression<1>(std::array<detail::SumTerm, 1>{{detail::SumTerm{&value, false}}});
+}
+
+namespace detail {
+
+template <std::size_t N, std::size_t M>
+SumExpression<N + M> concatenate(const SumExpression<N>& lhs, const SumExpression<M>& rhs, bool negateRhs) {
+    std::array<SumTerm, N + M> terms;
+    for (std::size_t i = 0; i < N; ++i) {
+        terms[i] = lhs.terms()[i];
+    }
+    for (std::size_t i = 0; i < M; ++i) {
+        terms[N + i] = SumTerm{rhs.terms()[i].value, rhs.terms()[i].negate != negateRhs};
+    }
+    return SumExpression<N + M>(terms);
+}
+
+} // namespace detail
+
+template <std::size_t N, std::size_t M>
+inline SumExpression<N + M> operator+(const SumExpression<N>& lhs, const SumExpression<M>& rhs) {
+    return detail::concatenate(lhs, rhs, false);
+}
+template <std::size_t N>
+inline SumExpression<N + 1> operator+(const SumExpression<N>& lhs, const BigInteger& rhs) {
+    return detail::concatenate(lhs, lazy(rhs), false);
+}
+template <std::size_t N>
+inline SumExpression<N + 1> operator+(const BigInteger& lhs, const SumExpression<N>& rhs) {
+    return detail::concatenate(lazy(lhs), rhs, false);
+}
+
+template <std::size_t N, std::size_t M>
+inline SumExpression<N + M> operator-(const SumExpression<N>& lhs, const SumExpression<M>& rhs) {
+    return detail::concatenate(lhs, rhs, true);
+}
+template <std::size_t N>
+inline SumExpression<N + 1> operator-(const SumExpression<N>& lhs, const BigInteger& rhs) {
+    return detail::concatenate(lhs, lazy(rhs), true);
+}
+template <std::size_t N>
+inline SumExpression<N + 1> operator-(const BigInteger& lhs, const SumExpression<N>& rhs) {
+    return detail::concatenate(lazy(lhs), rhs, true);
+}
+
+} // namespace apmath
@@ -0,0 +1,461 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "BigInteger.hpp"
+#include "LimbAccess.hpp"
+#include "LimbKernels.hpp"
+#include "NativeIntegers.hpp"
+
+/**
+ * Fixed-capacity integers usable in constant expressions.
+ * The magnitude lives in an array of limbs inside the object, so values never allocate,
+ * and all arithmetic is constexpr: a constant computed from FixedBigInteger is folded into the binary.
+ * Results which don't fit the capacity throw std::overflow_error, which is a compile error
+ * in a constant expression.
+ */
+namespace apmath {
+
+namespace detail {
+
+constexpr std::size_t fixedLimbCount(std::size_t bits) {
+    return (bits + LimbBits - 1) / LimbBits;
+}
+
+// Limb kernels of LimbKernels.hpp aren't constexpr, these are simple loops for short arrays
+
+constexpr bool isNegativeValue(std::int64_t value) {
+    return value < 0;
+}
+
+constexpr bool isNegativeValue(std::uint64_t) {
+    return false;
+}
+
+constexpr Limb limbAt(const Limb* a, std::size_t n, std::size_t i) {
+    return i < n ? a[i] : 0;
+}
+
+constexpr int compareFixedLimbs(const Limb* a, std::size_t an, const Limb* b, std::size_t bn) {
+    for (std::size_t i = an > bn ? an : bn; i-- > 0; ) {
+        Limb x = limbAt(a, an, i);
+        Limb y = limbAt(b, bn, i);
+        if (x != y) {
+            return x < y ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// r += b, returns false when the sum doesn't fit into rn limbs
+constexpr bool addFixedLimbs(Limb* r, std::size_t rn, const Limb* b, std::size_t bn) {
+    Limb carry = 0;
+    for (std::size_t i = 0; i < rn; ++i) {
+        Limb sum = r[i] + carry;
+        carry = sum < carry;
+        Limb limbSum = sum + limbAt(b, bn, i);
+        carry += limbSum < sum;
+        r[i] = limbSum;
+    }
+    return carry == 0 && compareFixedLimbs(nullptr, 0, b + (bn > rn ? rn : bn), bn > rn ? bn - rn : 0) == 0;
+}
+
+// r = r - b when subtractFrom is false and r = b - r otherwise, the result must be nonnegative
+constexpr void subtractFixedLimbs(Limb* r, std::size_t rn, const Limb* b, std::size_t bn, bool subtractFrom) {
+    Limb borrow = 0;
+    for (std::size_t i = 0; i < rn; ++i) {
+        Limb lhs = subtractFrom ? limbAt(b, bn, i) : r[i];
+        Limb rhs = subtractFrom ? r[i] : limbAt(b, bn, i);
+        Limb diff = lhs - rhs;
+        Limb nextBorrow = diff > lhs;
+        r[i] = diff - borrow;
+        borrow = nextBorrow + (diff < borrow);
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief FixedBigInteger - signed integer with magnitude of at most Bits bits.
+ * It supports parsing, addition, subtraction, multiplication and comparison in constant expressions
+ * and converts to and from BigInteger at runtime.
+ * Operands of different widths give a result of the wider one.
+ */
+template <std::size_t Bits>
+class FixedBigInteger {
+    static_assert(Bits > 0, "FixedBigInteger needs at least one bit");
+
+    template <typename T>
+    using EnableIfIntegral = detail::EnableIfIntegral<T>;
+
+    template <std::size_t> friend class FixedBigInteger;
+
+public:
+    /**
+     * @brief LimbCount - number of limbs holding the magnitude
+     */
+    static constexpr std::size_t LimbCount = detail::fixedLimbCount(Bits);
+
+    /**
+     * @brief FixedBigInteger constructor of zero
+     */
+    constexpr FixedBigInteger()
+        : mLimbs(),
+          mNegative(false)
+    {}
+    /**
+     * @brief FixedBigInteger constructor of a native integer
+     * @throw std::overflow_error if the value doesn't fit
+     */
+    template <typename T, EnableIfIntegral<T> = 0>
+    constexpr FixedBigInteger(T value)
+        : FixedBigInteger()
+    {
+        using Native = detail::NativeType<T>;
+        mNegative = detail::isNegativeValue(static_cast<Native>(value));
+        std::uint64_t magnitude = mNegative ? 0 - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+        for (std::size_t i = 0; magnitude != 0; ++i) {
+            if (i == LimbCount) {
+                throw std::overflow_error("FixedBigInteger overflow");
+            }
+            mLimbs[i] = static_cast<Limb>(magnitude);
+            magnitude = detail::LimbBits < 64 ? magnitude >> (detail::LimbBits % 64) : 0;
+        }
+        checkCapacity();
+    }
+    /**
+     * @brief FixedBigInteger constructor
+     * @param numberString - decimal integer number in format [+-][000]123456789
+     * @throw std::runtime_error on wrong format, std::overflow_error if the value doesn't fit
+     */
+    constexpr explicit FixedBigInteger(std::string_view numberString)
+        : FixedBigInteger()
+    {
+        std::size_t begin = 0;
+        if (!numberString.empty() && (numberString[0] == '-' || numberString[0] == '+')) {
+            begin = 1;
+        }
+        if (begin == numberString.size()) {
+            throw std::runtime_error("FixedBigInteger format error: usage [+-][000]123456789");
+        }
+        for (std::size_t i = begin; i < numberString.size(); ++i) {
+            if (numberString[i] < '0' || numberString[i] > '9') {
+                throw std::runtime_error("FixedBigInteger format error: usage [+-][000]123456789");
+            }
+            multiplyAdd(10, static_cast<Limb>(numberString[i] - '0'));
+        }
+        mNegative = numberString[0] == '-';
+        normalizeSign();
+    }
+    /**
+     * @brief FixedBigInteger converting constructor from another width
+     * @throw std::overflow_error if the value doesn't fit
+     */
+    template <std::size_t OtherBits>
+    constexpr explicit FixedBigInteger(const FixedBigInteger<OtherBits>& other)
+        : FixedBigInteger()
+    {
+        if (!detail::addFixedLimbs(mLimbs, LimbCount, other.mLimbs, other.LimbCount)) {
+            throw std::overflow_error("FixedBigInteger overflow");
+        }
+        checkCapacity();
+        mNegative = other.mNegative;
+    }
+    /**
+     * @brief FixedBigInteger constructor from BigInteger
+     * @throw std::overflow_error if the value doesn't fit
+     */
+    explicit FixedBigInteger(const BigInteger& value)
+        : FixedBigInteger()
+    {
+        const detail::LimbStorage& limbs = detail::LimbAccess::limbs(value);
+        if (!detail::addFixedLimbs(mLimbs, LimbCount, limbs.data(), limbs.size())) {
+            throw std::overflow_error("FixedBigInteger overflow");
+        }
+        checkCapacity();
+        mNegative = detail::LimbAccess::isNegative(value);
+    }
+
+    /**
+     * @brief operator BigInteger - copies the limbs, no digits are parsed
+     */
+    operator BigInteger() const {
+        BigInteger result;
+        detail::LimbAccess::limbs(result).assign(mLimbs, LimbCount);
+        detail::LimbAccess::setNegative(result, mNegative);
+        return result;
+    }
+
+    /**
+     * @brief toString - creates string representation of the decimal integer number
+     */
+    std::string toString() const {
+        return BigInteger(*this).toString();
+    }
+
+    constexpr bool isNegative() const { return mNegative; }
+    /**
+     * @brief limb - limb i of the magnitude, the lowest one first
+     */
+    constexpr Limb limb(std::size_t i) const { return mLimbs[i]; }
+
+    template <std::size_t OtherBits>
+    constexpr FixedBigInteger& operator+=(const FixedBigInteger<OtherBits>& rhs) {
+        addSigned(rhs.mLimbs, rhs.LimbCount, rhs.mNegative);
+        return *this;
+    }
+    template <std::size_t OtherBits>
+    constexpr FixedBigInteger& operator-=(const FixedBigInteger<OtherBits>& rhs) {
+        addSigned(rhs.mLimbs, rhs.LimbCount, !rhs.mNegative);
+        return *this;
+    }
+    // Schoolbook multiplication, products landing above the capacity are overflow
+    template <std::size_t OtherBits>
+    constexpr FixedBigInteger& operator*=(const FixedBigInteger<OtherBits>& rhs) {
+        Limb product[LimbCount] = {};
+        for (std::size_t j = 0; j < rhs.LimbCount; ++j) {
+            if (rhs.mLimbs[j] == 0) {
+                continue;
+            }
+            Limb carry = 0;
+            for (std::size_t i = 0; i < LimbCount; ++i) {
+                if (i + j >= LimbCount) {
+                    if (mLimbs[i] != 0) {
+                        throw std::overflow_error("FixedBigInteger overflow");
+                    }
+                    continue;
+                }
+                detail::DoubleLimb limbProduct = static_cast<detail::DoubleLimb>(mLimbs[i]) * rhs.mLimbs[j]
+                                                 + product[i + j] + carry;
+                product[i + j] = static_cast<Limb>(limbProduct);
+                carry = static_cast<Limb>(limbProduct >> detail::LimbBits);
+            }
+            if (carry != 0) {
+                throw std::overflow_error("FixedBigInteger overflow");
+            }
+        }
+        for (std::size_t i = 0; i < LimbCount; ++i) {
+            mLimbs[i] = product[i];
+        }
+        checkCapacity();
+        mNegative = mNegative != rhs.mNegative;
+        normalizeSign();
+        return *this;
+    }
+    template <typename T, EnableIfIntegral<T> = 0>
+    constexpr FixedBigInteger& operator+=(T rhs) { return *this += FixedBigInteger<64>(rhs); }
+    template <typename T, EnableIfIntegral<T> = 0>
+    constexpr FixedBigInteger& operator-=(T rhs) { return *this -= FixedBigInteger<64>(rhs); }
+    template <typename T, EnableIfIntegral<T> = 0>
+    constexpr FixedBigInteger& operator*=(T rhs) { return *this *= FixedBigInteger<64>(rhs); }
+
+    constexpr FixedBigInteger operator+() const {
+        return *this;
+    }
+    constexpr FixedBigInteger operator-() const {
+        FixedBigInteger result(*this);
+        result.mNegative = !mNegative;
+        result.normalizeSign();
+        return result;
+    }
+
+    template <std::size_t OtherBits>
+    constexpr int compare(const FixedBigInteger<OtherBits>& other) const {
+        if (mNegative != other.mNegative) {
+            return mNegative ? -1 : 1;
+        }
+        int magnitudes = detail::compareFixedLimbs(mLimbs, LimbCount, other.mLimbs, other.LimbCount);
+        return mNegative ? -magnitudes : magnitudes;
+    }
+
+private:
+    static constexpr std::size_t TopBits = Bits % detail::LimbBits;
+
+    Limb mLimbs[LimbCount];
+    bool mNegative;
+
+    // Bits of the top limb above Bits are overflow too
+    constexpr void checkCapacity() const {
+        if (TopBits != 0 && (mLimbs[LimbCount - 1] >> TopBits) != 0) {
+            throw std::overflow_error("FixedBigInteger overflow");
+        }
+    }
+
+    // Zero is never negative, so equal values have equal representations
+    constexpr void normalizeSign() {
+        if (detail::compareFixedLimbs(mLimbs, LimbCount, nullptr, 0) == 0) {
+            mNegative = false;
+        }
+    }
+
+    constexpr void multiplyAdd(Limb factor, Limb addend) {
+        Limb carry = addend;
+        for (std::size_t i = 0; i < LimbCount; ++i) {
+            detail::DoubleLimb limbProduct = static_cast<detail::DoubleLimb>(mLimbs[i]) * factor + carry;
+            mLimbs[i] = static_cast<Limb>(limbProduct);
+            carry = static_cast<Limb>(limbProduct >> detail::LimbBits);
+        }
+        if (carry != 0) {
+            throw std::overflow_error("FixedBigInteger overflow");
+        }
+        checkCapacity();
+    }
+
+    constexpr void addSigned(const Limb* limbs, std::size_t count, bool negative) {
+        if (mNegative == negative) {
+            if (!detail::addFixedLimbs(mLimbs, LimbCount, limbs, count)) {
+                throw std::overflow_error("FixedBigInteger overflow");
+            }
+            checkCapacity();
+            return;
+        }
+        // The difference is never longer than the greater operand
+        if (detail::compareFixedLimbs(mLimbs, LimbCount, limbs, count) >= 0) {
+            detail::subtractFixedLimbs(mLimbs, LimbCount, limbs, count, false);
+        }
+        else {
+            if (detail::compareFixedLimbs(nullptr, 0, limbs + (count > LimbCount ? LimbCount : count),
+                                          count > LimbCount ? count - LimbCount : 0) != 0) {
+                throw std::overflow_error("FixedBigInteger overflow");
+            }
+            detail::subtractFixedLimbs(mLimbs, LimbCount, limbs, count, true);
+            checkCapacity();
+            mNegative = negative;
+        }
+        normalizeSign();
+    }
+};
+
+namespace detail {
+
+constexpr std::size_t widerBits(std::size_t a, std::size_t b) {
+    return a > b ? a : b;
+}
+
+} // namespace detail
+
+template <std::size_t A, std::size_t B>
+constexpr FixedBigInteger<detail::widerBits(A, B)> operator+(const FixedBigInteger<A>& lhs, const FixedBigInteger<B>& rhs) {
+    FixedBigInteger<detail::widerBits(A, B)> result(lhs);
+    return result += rhs;
+}
+template <std::size_t A, std::size_t B>
+constexpr FixedBigInteger<detail::widerBits(A, B)> operator-(const FixedBigInteger<A>& lhs, const FixedBigInteger<B>& rhs) {
+    FixedBigInteger<detail::widerBits(A, B)> result(lhs);
+    return result -= rhs;
+}
+template <std::size_t A, std::size_t B>
+constexpr FixedBigInteger<detail::widerBits(A, B)> operator*(const FixedBigInteger<A>& lhs, const FixedBigInteger<B>& rhs) {
+    FixedBigInteger<detail::widerBits(A, B)> result(lhs);
+    return result *= rhs;
+}
+
+template <std::size_t A, typename T, detail::EnableIfIntegral<T> = 0>
+constexpr FixedBigInteger<A> operator+(FixedBigInteger<A> lhs, T rhs) { return lhs += rhs; }
+template <std::size_t A, typename T, detail::EnableIfIntegral<T> = 0>
+constexpr FixedBigInteger<A> operator+(T lhs, FixedBigInteger<A> rhs) { return rhs += lhs; }
+template <std::size_t A, typename T, detail::EnableIfIntegral<T> = 0>
+constexpr FixedBigInteger<A> operator-(FixedBigInteger<A> lhs, T rhs) { return lhs -= rhs; }
+template <std::size_t A, typename T, detail::EnableIfIntegral<T> = 0>
+constexpr FixedBigInteger<A> operator-(T lhs, const FixedBigInteger<A>& rhs) { return -(rhs - lhs); }
+template <std::size_t A, typename T, detail::EnableIfIntegral<T> = 0>
+constexpr FixedBigInteger<A> operator*(FixedBigInteger<A> lhs, T rhs) { return lhs *= rhs; }
+template <std::size_t A, typename T, detail::EnableIfIntegral<T> = 0>
+constexpr FixedBigInteger<A> operator*(T lhs, FixedBigInteger<A> rhs) { return rhs *= lhs; }
+
+template <std::size_t A, std::size_t B>
+constexpr bool operator==(const FixedBigInteger<A>& lhs, const FixedBigInteger<B>& rhs) { return lhs.compare(rhs) == 0; }
+template <std::size_t A, std::size_t B>
+constexpr bool operator!=(const FixedBigInteger<A>& lhs, const FixedBigInteger<B>& rhs) { return lhs.compare(rhs) != 0; }
+template <std::size_t A, std::size_t B>
+constexpr bool operator< (const FixedBigInteger<A>& lhs, const FixedBigInteger<B>& rhs) { return lhs.compare(rhs) < 0; }
+template <std::size_t A, std::size_t B>
+constexpr bool operator> (const FixedBigInteger<A>& lhs, const FixedBigInteger<B>& rhs) { return lhs.compare(rhs) > 0; }
+template <std::size_t A, std::size_t B>
+constexpr bool operator<=(const FixedBigInteger<A>& lhs, const FixedBigInteger<B>& rhs) { return lhs.compare(rhs) <= 0; }
+template <std::size_t A, std::size_t B>
+constexpr bool operator>=(const FixedBigInteger<A>& lhs, const FixedBigInteger<B>& rhs) { return lhs.compare(rhs) >= 0; }
+
+namespace detail {
+
+// Characters of a literal as a null-terminated array with static storage
+template <char... Chars>
+struct LiteralChars {
+    static constexpr char value[] = {Chars..., '\0'};
+};
+
+// Digits of an integer literal with an optional 0x or 0b prefix, apostrophes separate digits
+struct LiteralDigits {
+    unsigned base;
+    std::size_t begin;
+};
+
+constexpr LiteralDigits literalDigits(const char* chars) {
+    if (chars[0] == '0' && (chars[1] == 'x' || chars[1] == 'X')) {
+        return LiteralDigits{16, 2};
+    }
+    if (chars[0] == '0' && (chars[1] == 'b' || chars[1] == 'B')) {
+        return LiteralDigits{2, 2};
+    }
+    return LiteralDigits{10, 0};
+}
+
+// Floating-point literals like 1e5_big and 0x1p4_big reach the operator too, their exponents aren't digits.
+// The throw makes the constant evaluation of such literals fail to compile.
+constexpr Limb literalDigit(char c, unsigned base) {
+    unsigned digit = c >= '0' && c <= '9' ? static_cast<unsigned>(c - '0')
+                   : c >= 'a' && c <= 'f' ? static_cast<unsigned>(c - 'a' + 10)
+                   : c >= 'A' && c <= 'F' ? static_cast<unsigned>(c - 'A' + 10)
+                                          : base;
+    if (digit >= base) {
+        throw std::invalid_argument("_big literal has a character which isn't a digit");
+    }
+    return digit;
+}
+
+// Bits enough for any literal with these digits, whole limbs: log2(10) < 3.33
+constexpr std::size_t literalBits(const char* chars) {
+    LiteralDigits digits = literalDigits(chars);
+    std::size_t count = 0;
+    for (std::size_t i = digits.begin; chars[i] != '\0'; ++i) {
+        count += chars[i] != '\'';
+    }
+    std::size_t bits = digits.base == 16 ? 4 * count : digits.base == 2 ? count : (count * 333 + 99) / 100;
+    return fixedLimbCount(bits) * LimbBits;
+}
+
+template <std::size_t Bits>
+constexpr FixedBigInteger<Bits> parseLiteral(const char* chars) {
+    LiteralDigits digits = literalDigits(chars);
+    FixedBigInteger<Bits> value;
+    for (std::size_t i = digits.begin; chars[i] != '\0'; ++i) {
+        if (chars[i] != '\'') {
+            value *= static_cast<Limb>(digits.base);
+            value += literalDigit(chars[i], digits.base);
+        }
+    }
+    return value;
+}
+
+} // namespace detail
+
+namespace literals {
+
+/**
+ * @brief operator""_big - integer literal of any length, 123_big, 0xFF_big, -1'000_big.
+ * It's parsed at compile time into a FixedBigInteger of whole limbs,
+ * conversion to BigInteger copies the limbs. A leading zero doesn't make the literal octal.
+ */
+template <char... Chars>
+constexpr auto operator""_big() {
+    constexpr const char* chars = detail::LiteralChars<Chars...>::value;
+    constexpr auto value = detail::parseLiteral<detail::literalBits(chars)>(chars);
+    return value;
+}
+
+} // namespace literals
+} // namespace apmath
@@ -0,0 +1,543 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include "BigInteger.hpp"
+#include "Division.hpp"
+#include "LimbAccess.hpp"
+#include "LimbKernels.hpp"
+#include "NativeIntegers.hpp"
+
+/**
+ * Fixed-width binary integers: UInt<Bits> and two's complement Int<Bits>.
+ * Widths are whole limbs and every operation works on all of them, so loops over limbs
+ * are unrolled at compile time into add-with-carry chains and there is no length or sign bookkeeping.
+ * Overflow either wraps around modulo 2^Bits or throws std::overflow_error, as chosen by the type.
+ */
+namespace apmath {
+
+/**
+ * @brief Overflow - what fixed-width arithmetic does with results out of range
+ */
+enum class Overflow {
+    Wrap,
+    Check
+};
+
+namespace detail {
+
+// One limb of an add-with-carry or subtract-with-borrow chain, x86-64 compiles them to adc and sbb
+inline Limb addWithCarry(Limb a, Limb b, unsigned char& carry) {
+#if defined(__x86_64__) && APMATH_LIMB_BITS == 64
+    unsigned long long sum;
+    carry = _addcarry_u64(carry, a, b, &sum);
+    return sum;
+#elif defined(__x86_64__)
+    unsigned int sum;
+    carry = _addcarry_u32(carry, a, b, &sum);
+    return sum;
+#else
+    Limb sum;
+    bool overflow = __builtin_add_overflow(a, b, &sum);
+    overflow |= __builtin_add_overflow(sum, static_cast<Limb>(carry), &sum);
+    carry = overflow;
+    return sum;
+#endif
+}
+
+inline Limb subtractWithBorrow(Limb a, Limb b, unsigned char& borrow) {
+#if defined(__x86_64__) && APMATH_LIMB_BITS == 64
+    unsigned long long diff;
+    borrow = _subborrow_u64(borrow, a, b, &diff);
+    return diff;
+#elif defined(__x86_64__)
+    unsigned int diff;
+    borrow = _subborrow_u32(borrow, a, b, &diff);
+    return diff;
+#else
+    Limb diff;
+    bool overflow = __builtin_sub_overflow(a, b, &diff);
+    overflow |= __builtin_sub_overflow(diff, static_cast<Limb>(borrow), &diff);
+    borrow = overflow;
+    return diff;
+#endif
+}
+
+// r += a * m + carry for one limb, the high limb replaces carry
+inline void multiplyAddLimb(Limb& r, Limb a, Limb m, Limb& carry) {
+    DoubleLimb product = static_cast<DoubleLimb>(a) * m + r + carry;
+    r = static_cast<Limb>(product);
+    carry = static_cast<Limb>(product >> LimbBits);
+}
+
+} // namespace detail
+
+/**
+ * @brief FixedInteger - integer of exactly Bits bits, Bits is a multiple of the limb width.
+ * Signed integers are two's complement. Division truncates toward zero like BigInteger.
+ * Converts implicitly from native integers, BigInteger and the other Mode of the same width, values out of range
+ * wrap around or throw depending on Mode, and implicitly to BigInteger. Arithmetic and comparisons
+ * mixing FixedInteger and BigInteger are computed in BigInteger.
+ */
+template <std::size_t Bits, bool Signed, Overflow Mode = Overflow::Wrap>
+class FixedInteger {
+    static_assert(Bits > 0 && Bits % detail::LimbBits == 0, "FixedInteger width must be a whole number of limbs");
+
+    template <typename T>
+    using EnableIfIntegral = detail::EnableIfIntegral<T>;
+    template <typename T>
+    using EnableIfBigInteger = typename std::enable_if<std::is_same<typename std::decay<T>::type, BigInteger>::value,
+                                                       int>::type;
+    using Indices = std::make_index_sequence<Bits / detail::LimbBits>;
+
+    template <std::size_t, bool, Overflow> friend class FixedInteger;
+
+public:
+    /**
+     * @brief LimbCount - number of limbs, the lowest one first
+     */
+    static constexpr std::size_t LimbCount = Bits / detail::LimbBits;
+
+    FixedInteger()
+        : mLimbs()
+    {}
+    /**
+     * @brief FixedInteger constructor of a native integer, negative values are sign-extended
+     */
+    template <typename T, EnableIfIntegral<T> = 0>
+    FixedInteger(T value)
+        : mLimbs()
+    {
+        using Native = detail::NativeType<T>;
+        Native native = static_cast<Native>(value);
+        bool negative = std::is_signed<T>::value && static_cast<std::int64_t>(native) < 0;
+        std::uint64_t bits = static_cast<std::uint64_t>(native);
+        for (std::size_t i = 0; i < LimbCount; ++i) {
+            mLimbs[i] = i * detail::LimbBits < 64 ? static_cast<Limb>(bits >> (i * detail::LimbBits % 64))
+                                                  : negative ? ~Limb(0) : 0;
+        }
+        if (Mode == Overflow::Check && (negative ? !fitsNegative(bits) : !fitsNonnegative(bits))) {
+            throw std::overflow_error("FixedInteger overflow");
+        }
+    }
+    /**
+     * @brief FixedInteger constructor from BigInteger, keeps the lowest Bits bits of two's complement
+     */
+    FixedInteger(const BigInteger& value)
+        : mLimbs()
+    {
+        const detail::LimbStorage& limbs = detail::LimbAccess::limbs(value);
+        bool truncated = limbs.size() > LimbCount;
+        for (std::size_t i = 0; i < LimbCount && i < limbs.size(); ++i) {
+            mLimbs[i] = limbs[i];
+        }
+        bool negative = detail::LimbAccess::isNegative(value);
+        if (Mode == Overflow::Check && (truncated || !fitsMagnitude(negative))) {
+            throw std::overflow_error("FixedInteger overflow");
+        }
+        if (negative) {
+            negate();
+        }
+    }
+    /**
+     * @brief FixedInteger constructor from the other overflow mode, implicit since every value fits
+     */
+    template <Overflow OtherMode, typename std::enable_if<OtherMode != Mode, int>::type = 0>
+    FixedInteger(const FixedInteger<Bits, Signed, OtherMode>& other)
+        : mLimbs()
+    {
+        for (std::size_t i = 0; i < LimbCount; ++i) {
+            mLimbs[i] = other.mLimbs[i];
+        }
+    }
+    /**
+     * @brief FixedInteger converting constructor from another width or signedness,
+     * extends the sign of signed values and keeps the lowest bits of longer ones
+     */
+    template <std::size_t OtherBits, bool OtherSigned, Overflow OtherMode,
+              typename std::enable_if<OtherBits != Bits || OtherSigned != Signed, int>::type = 0>
+    explicit FixedInteger(const FixedInteger<OtherBits, OtherSigned, OtherMode>& other)
+        : mLimbs()
+    {
+        Limb extension = other.isNegative() ? ~Limb(0) : 0;
+        for (std::size_t i = 0; i < LimbCount; ++i) {
+            mLimbs[i] = i < other.LimbCount ? other.mLimbs[i] : extension;
+        }
+        if (Mode == Overflow::Check && BigInteger(*this) != BigInteger(other)) {
+            throw std::overflow_error("FixedInteger overflow");
+        }
+    }
+
+    /**
+     * @brief operator BigInteger - value of the number, no digits are parsed
+     */
+    operator BigInteger() const {
+        Wrapping magnitude = isNegative() ? -wrapped() : wrapped();
+        BigInteger result;
+        detail::LimbAccess::limbs(result).assign(magnitude.mLimbs, LimbCount);
+        detail::LimbAccess::setNegative(result, isNegative());
+        return result;
+    }
+
+    /**
+     * @brief toString - creates string representation of the decimal integer number
+     */
+    std::string toString() const {
+        return BigInteger(*this).toString();
+    }
+
+    bool isNegative() const {
+        return Signed && (mLimbs[LimbCount - 1] >> (detail::LimbBits - 1)) != 0;
+    }
+    /**
+     * @brief limb - limb i of the two's complement representation, the lowest one first
+     */
+    Limb limb(std::size_t i) const { return mLimbs[i]; }
+
+    FixedInteger& operator+=(const FixedInteger& rhs) {
+        bool negative = isNegative();
+        unsigned char carry = add(rhs, Indices());
+        checkSum(carry != 0, negative, rhs.isNegative());
+        return *this;
+    }
+    FixedInteger& operator-=(const FixedInteger& rhs) {
+        bool negative = isNegative();
+        unsigned char borrow = subtract(rhs, Indices());
+        checkSum(borrow != 0, negative, !rhs.isNegative());
+        return *this;
+    }
+    // Only the lowest Bits bits of the product are computed, the higher ones are overflow
+    FixedInteger& operator*=(const FixedInteger& rhs) {
+        if (Mode == Overflow::Check) {
+            return *this = checkedProduct(*this, rhs);
+        }
+        FixedInteger product;
+        product.multiplyRows(mLimbs, rhs.mLimbs, Indices());
+        return *this = product;
+    }
+    /**
+     * @throw std::domain_error on division by zero
+     */
+    FixedInteger& operator/=(const FixedInteger& rhs) {
+        FixedInteger remainder;
+        divide(rhs, *this, remainder);
+        return *this;
+    }
+    /**
+     * @brief operator%= - remainder of truncating division, it has the dividend's sign
+     * @throw std::domain_error on division by zero
+     */
+    FixedInteger& operator%=(const FixedInteger& rhs) {
+        FixedInteger quotient;
+        divide(rhs, quotient, *this);
+        return *this;
+    }
+
+    FixedInteger& operator&=(const FixedInteger& rhs) {
+        for (std::size_t i = 0; i < LimbCount; ++i) {
+            mLimbs[i] &= rhs.mLimbs[i];
+        }
+        return *this;
+    }
+    FixedInteger& operator|=(const FixedInteger& rhs) {
+        for (std::size_t i = 0; i < LimbCount; ++i) {
+            mLimbs[i] |= rhs.mLimbs[i];
+        }
+        return *this;
+    }
+    FixedInteger& operator^=(const FixedInteger& rhs) {
+        for (std::size_t i = 0; i < LimbCount; ++i) {
+            mLimbs[i] ^= rhs.mLimbs[i];
+        }
+        return *this;
+    }
+    // Bits shifted out are lost in both modes
+    FixedInteger& operator<<=(std::size_t shift) {
+        std::size_t limbShift = shift / detail::LimbBits;
+        unsigned bitShift = static_cast<unsigned>(shift % detail::LimbBits);
+        for (std::size_t i = LimbCount; i-- > 0; ) {
+            Limb high = i >= limbShift ? mLimbs[i - limbShift] : 0;
+            Limb low = i >= limbShift + 1 ? mLimbs[i - limbShift - 1] : 0;
+            mLimbs[i] = bitShift == 0 ? high : (high << bitShift) | (low >> (detail::LimbBits - bitShift));
+        }
+        return *this;
+    }
+    // Arithmetic shift for signed integers, it rounds toward minus infinity
+    FixedInteger& operator>>=(std::size_t shift) {
+        Limb extension = isNegative() ? ~Limb(0) : 0;
+        std::size_t limbShift = shift / detail::LimbBits;
+        unsigned bitShift = static_cast<unsigned>(shift % detail::LimbBits);
+        for (std::size_t i = 0; i < LimbCount; ++i) {
+            Limb low = i + limbShift < LimbCount ? mLimbs[i + limbShift] : extension;
+            Limb high = i + limbShift + 1 < LimbCount ? mLimbs[i + limbShift + 1] : extension;
+            mLimbs[i] = bitShift == 0 ? low : (low >> bitShift) | (high << (detail::LimbBits - bitShift));
+        }
+        return *this;
+    }
+
+    friend FixedInteger operator+(FixedInteger lhs, const FixedInteger& rhs) { return lhs += rhs; }
+    friend FixedInteger operator-(FixedInteger lhs, const FixedInteger& rhs) { return lhs -= rhs; }
+    friend FixedInteger operator*(FixedInteger lhs, const FixedInteger& rhs) { return lhs *= rhs; }
+    friend FixedInteger operator/(FixedInteger lhs, const FixedInteger& rhs) { return lhs /= rhs; }
+    friend FixedInteger operator%(FixedInteger lhs, const FixedInteger& rhs) { return lhs %= rhs; }
+    friend FixedInteger operator&(FixedInteger lhs, const FixedInteger& rhs) { return lhs &= rhs; }
+    friend FixedInteger operator|(FixedInteger lhs, const FixedInteger& rhs) { return lhs |= rhs; }
+    friend FixedInteger operator^(FixedInteger lhs, const FixedInteger& rhs) { return lhs ^= rhs; }
+    friend FixedInteger operator<<(FixedInteger lhs, std::size_t shift) { return lhs <<= shift; }
+    friend FixedInteger operator>>(FixedInteger lhs, std::size_t shift) { return lhs >>= shift; }
+
+    FixedInteger& operator++() {
+        return *this += FixedInteger(1);
+    }
+    FixedInteger operator++(int) {
+        FixedInteger result(*this);
+        ++*this;
+        return result;
+    }
+    FixedInteger& operator--() {
+        return *this -= FixedInteger(1);
+    }
+    FixedInteger operator--(int) {
+        FixedInteger result(*this);
+        --*this;
+        return result;
+    }
+
+    FixedInteger operator+() const {
+        return *this;
+    }
+    FixedInteger operator-() const {
+        return FixedInteger() - *this;
+    }
+    FixedInteger operator~() const {
+        FixedInteger result;
+        for (std::size_t i = 0; i < LimbCount; ++i) {
+            result.mLimbs[i] = ~mLimbs[i];
+        }
+        return result;
+    }
+
+    friend bool operator==(const FixedInteger& lhs, const FixedInteger& rhs) {
+        for (std::size_t i = 0; i < LimbCount; ++i) {
+            if (lhs.mLimbs[i] != rhs.mLimbs[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    friend bool operator!=(const FixedInteger& lhs, const FixedInteger& rhs) { return !(lhs == rhs); }
+    // Signed values of different signs compare opposite to their top limbs
+    friend bool operator< (const FixedInteger& lhs, const FixedInteger& rhs) {
+        if (lhs.isNegative() != rhs.isNegative()) {
+            return lhs.isNegative();
+        }
+        for (std::size_t i = LimbCount; i-- > 0; ) {
+            if (lhs.mLimbs[i] != rhs.mLimbs[i]) {
+                return lhs.mLimbs[i] < rhs.mLimbs[i];
+            }
+        }
+        return false;
+    }
+    friend bool operator> (const FixedInteger& lhs, const FixedInteger& rhs) { return rhs < lhs; }
+    friend bool operator<=(const FixedInteger& lhs, const FixedInteger& rhs) { return !(rhs < lhs); }
+    friend bool operator>=(const FixedInteger& lhs, const FixedInteger& rhs) { return !(lhs < rhs); }
+
+    // Mixed with BigInteger the operands would convert either way, these overloads match exactly
+    // and compute in BigInteger. They are templates so that native integers still convert to FixedInteger.
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend BigInteger operator+(B&& lhs, const FixedInteger& rhs) { return std::forward<B>(lhs) + BigInteger(rhs); }
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend BigInteger operator+(const FixedInteger& lhs, B&& rhs) { return BigInteger(lhs) + std::forward<B>(rhs); }
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend BigInteger operator-(B&& lhs, const FixedInteger& rhs) { return std::forward<B>(lhs) - BigInteger(rhs); }
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend BigInteger operator-(const FixedInteger& lhs, B&& rhs) { return BigInteger(lhs) - std::forward<B>(rhs); }
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend BigInteger operator*(B&& lhs, const FixedInteger& rhs) { return std::forward<B>(lhs) * BigInteger(rhs); }
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend BigInteger operator*(const FixedInteger& lhs, B&& rhs) { return BigInteger(lhs) * std::forward<B>(rhs); }
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend BigInteger operator/(B&& lhs, const FixedInteger& rhs) { return std::forward<B>(lhs) / BigInteger(rhs); }
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend BigInteger operator/(const FixedInteger& lhs, B&& rhs) { return BigInteger(lhs) / std::forward<B>(rhs); }
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend BigInteger operator%(B&& lhs, const FixedInteger& rhs) { return std::forward<B>(lhs) % BigInteger(rhs); }
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend BigInteger operator%(const FixedInteger& lhs, B&& rhs) { return BigInteger(lhs) % std::forward<B>(rhs); }
+
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend bool operator==(const B& lhs, const FixedInteger& rhs) { return lhs == BigInteger(rhs); }
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend bool operator==(const FixedInteger& lhs, const B& rhs) { return BigInteger(lhs) == rhs; }
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend bool operator!=(const B& lhs, const FixedInteger& rhs) { return lhs != BigInteger(rhs); }
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend bool operator!=(const FixedInteger& lhs, const B& rhs) { return BigInteger(lhs) != rhs; }
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend bool operator< (const B& lhs, const FixedInteger& rhs) { return lhs < BigInteger(rhs); }
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend bool operator< (const FixedInteger& lhs, const B& rhs) { return BigInteger(lhs) < rhs; }
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend bool operator> (const B& lhs, const FixedInteger& rhs) { return lhs > BigInteger(rhs); }
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend bool operator> (const FixedInteger& lhs, const B& rhs) { return BigInteger(lhs) > rhs; }
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend bool operator<=(const B& lhs, const FixedInteger& rhs) { return lhs <= BigInteger(rhs); }
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend bool operator<=(const FixedInteger& lhs, const B& rhs) { return BigInteger(lhs) <= rhs; }
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend bool operator>=(const B& lhs, const FixedInteger& rhs) { return lhs >= BigInteger(rhs); }
+    template <typename B, EnableIfBigInteger<B> = 0>
+    friend bool operator>=(const FixedInteger& lhs, const B& rhs) { return BigInteger(lhs) >= rhs; }
+
+private:
+    Limb mLimbs[LimbCount];
+
+    // Arithmetic in the wrapping mode, used internally by both modes
+    using Wrapping = FixedInteger<Bits, Signed, Overflow::Wrap>;
+
+    Wrapping wrapped() const {
+        return Wrapping::fromLimbs(mLimbs);
+    }
+
+    static FixedInteger fromLimbs(const Limb* limbs) {
+        FixedInteger result;
+        for (std::size_t i = 0; i < LimbCount; ++i) {
+            result.mLimbs[i] = limbs[i];
+        }
+        return result;
+    }
+
+    template <std::size_t... I>
+    unsigned char add(const FixedInteger& rhs, std::index_sequence<I...>) {
+        unsigned char carry = 0;
+        ((mLimbs[I] = detail::addWithCarry(mLimbs[I], rhs.mLimbs[I], carry)), ...);
+        return carry;
+    }
+
+    template <std::size_t... I>
+    unsigned char subtract(const FixedInteger& rhs, std::index_sequence<I...>) {
+        unsigned char borrow = 0;
+        ((mLimbs[I] = detail::subtractWithBorrow(mLimbs[I], rhs.mLimbs[I], borrow)), ...);
+        return borrow;
+    }
+
+    // Row I adds a * b[I] to the limbs from I up, the part above Bits is dropped
+    template <std::size_t I, std::size_t... J>
+    void multiplyRow(const Limb* a, Limb m, std::index_sequence<J...>) {
+        Limb carry = 0;
+        (detail::multiplyAddLimb(mLimbs[I + J], a[J], m, carry), ...);
+    }
+
+    template <std::size_t... I>
+    void multiplyRows(const Limb* a, const Limb* b, std::index_sequence<I...>) {
+        (multiplyRow<I>(a, b[I], std::make_index_sequence<LimbCount - I>()), ...);
+    }
+
+    void negate() {
+        *this = fromLimbs((-wrapped()).mLimbs);
+    }
+
+    // Sign of a sum of operands with the given signs: a signed sum overflows when the operands have
+    // the same sign and the result the other one, an unsigned one when the top limb carries
+    void checkSum(bool carry, bool lhsNegative, bool rhsNegative) const {
+        if (Mode == Overflow::Check) {
+            bool overflow = Signed ? lhsNegative == rhsNegative && isNegative() != lhsNegative : carry;
+            if (overflow) {
+                throw std::overflow_error("FixedInteger overflow");
+            }
+        }
+    }
+
+    // The magnitude in mLimbs fits when its top bit is clear, or for signed numbers it's exactly 2^(Bits-1)
+    bool fitsMagnitude(bool negative) const {
+        bool topBit = (mLimbs[LimbCount - 1] >> (detail::LimbBits - 1)) != 0;
+        if (!Signed) {
+            return !negative || *this == FixedInteger();
+        }
+        return !topBit || (negative && *this == (FixedInteger(1) << (Bits - 1)));
+    }
+    bool fitsNonnegative(std::uint64_t bits) const {
+        return LimbCount * detail::LimbBits > 64 || (!Signed && LimbCount * detail::LimbBits == 64) ||
+               (bits >> (LimbCount * detail::LimbBits - Signed) % 64) == 0;
+    }
+    bool fitsNegative(std::uint64_t bits) const {
+        return Signed && (LimbCount * detail::LimbBits >= 64 ||
+                          (0 - bits) <= (std::uint64_t(1) << (LimbCount * detail::LimbBits - 1) % 64));
+    }
+
+    // Full product of the magnitudes, it fits when the limbs above Bits are zero and the sign fits
+    static FixedInteger checkedProduct(const FixedInteger& lhs, const FixedInteger& rhs) {
+        bool negative = lhs.isNegative() != rhs.isNegative();
+        Wrapping a = lhs.isNegative() ? -lhs.wrapped() : lhs.wrapped();
+        Wrapping b = rhs.isNegative() ? -rhs.wrapped() : rhs.wrapped();
+        std::size_t an = detail::significantLength(a.mLimbs, LimbCount);
+        std::size_t bn = detail::significantLength(b.mLimbs, LimbCount);
+        Limb product[2 * LimbCount] = {};
+        for (std::size_t j = 0; j < bn; ++j) {
+            product[an + j] = detail::addMultiplyByLimb(product + j, a.mLimbs, an, b.mLimbs[j]);
+        }
+        FixedInteger result = fromLimbs(product);
+        if (detail::significantLength(product, 2 * LimbCount) > LimbCount || !result.fitsMagnitude(negative)) {
+            throw std::overflow_error("FixedInteger overflow");
+        }
+        if (negative) {
+            result.negate();
+        }
+        return result;
+    }
+
+    // Divides magnitudes by the library kernels, signs are applied like in BigInteger
+    void divide(const FixedInteger& divisor, FixedInteger& quotient, FixedInteger& remainder) const {
+        bool negative = isNegative();
+        bool divisorNegative = divisor.isNegative();
+        Wrapping a = negative ? -wrapped() : wrapped();
+        Wrapping b = divisorNegative ? -divisor.wrapped() : divisor.wrapped();
+        std::size_t an = detail::significantLength(a.mLimbs, LimbCount);
+        std::size_t bn = detail::significantLength(b.mLimbs, LimbCount);
+        if (bn == 0) {
+            throw std::domain_error("FixedInteger division by zero");
+        }
+        Wrapping q;
+        Wrapping r;
+        if (an < bn) {
+            r = a;
+        }
+        else if (bn == 1) {
+            r.mLimbs[0] = detail::divideByLimb(q.mLimbs, a.mLimbs, an, b.mLimbs[0]);
+        }
+        else {
+            detail::divideLimbs(q.mLimbs, r.mLimbs, a.mLimbs, an, b.mLimbs, bn);
+        }
+        // Only the minimum divided by -1 doesn't fit, its quotient wraps around to itself
+        if (Mode == Overflow::Check && Signed && negative && divisorNegative &&
+            (q.mLimbs[LimbCount - 1] >> (detail::LimbBits - 1)) != 0) {
+            throw std::overflow_error("FixedInteger overflow");
+        }
+        quotient = fromLimbs((negative != divisorNegative ? -q : q).mLimbs);
+        remainder = fromLimbs((negative ? -r : r).mLimbs);
+    }
+};
+
+template <std::size_t Bits, Overflow Mode = Overflow::Wrap>
+using UInt = FixedInteger<Bits, false, Mode>;
+template <std::size_t Bits, Overflow Mode = Overflow::Wrap>
+using Int = FixedInteger<Bits, true, Mode>;
+
+using uint128 = UInt<128>;
+using uint256 = UInt<256>;
+using uint512 = UInt<512>;
+using int128 = Int<128>;
+using int256 = Int<256>;
+using int512 = Int<512>;
+
+} // namespace apmath
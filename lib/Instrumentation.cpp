@@ -0,0 +1,187 @@
+#include "Instrumentation.hpp"
+#include "LimbStorage.hpp"
+
+#include <atomic>
+
+namespace {
+using apmath::InstrumentedOperation;
+using apmath::LengthBuckets;
+
+constexpr std::size_t OperationCount = static_cast<std::size_t>(InstrumentedOperation::Count);
+
+#if APMATH_INSTRUMENTATION
+struct OperationCounters {
+    std::atomic<std::uint64_t> calls{0};
+    std::atomic<std::uint64_t> nanoseconds{0};
+    std::atomic<std::uint64_t> lengths[LengthBuckets] = {};
+};
+
+struct Counters {
+    OperationCounters operations[OperationCount];
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> allocatedBytes{0};
+    std::atomic<std::uint64_t> reallocations{0};
+    std::atomic<std::uint64_t> copiesOnWrite{0};
+};
+
+Counters& counters() {
+    static Counters instance;
+    return instance;
+}
+
+// Bucket k holds 2^(k-1) to 2^k - 1 limbs
+std::size_t lengthBucket(std::size_t limbs) {
+    std::size_t bucket = 0;
+    while (limbs > 0 && bucket + 1 < LengthBuckets) {
+        limbs >>= 1;
+        ++bucket;
+    }
+    return limbs > 0 ? LengthBuckets - 1 : bucket;
+}
+
+void increment(std::atomic<std::uint64_t>& counter, std::uint64_t value = 1) {
+    counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+std::uint64_t load(const std::atomic<std::uint64_t>& counter) {
+    return counter.load(std::memory_order_relaxed);
+}
+#endif
+
+void appendField(std::string& json, const char* name, std::uint64_t value) {
+    json += '"';
+    json += name;
+    json += "\": ";
+    json += std::to_string(value);
+}
+} // namespace
+
+namespace apmath {
+
+std::string InstrumentationSnapshot::toJson() const {
+    std::string json = "{\"enabled\": ";
+    json += enabled ? "true" : "false";
+    json += ", ";
+    appendField(json, "limbBits", APMATH_LIMB_BITS);
+    json += ", \"operations\": {";
+    for (std::size_t i = 0; i < OperationCount; ++i) {
+        const OperationStatistics& statistics = operations[i];
+        json += i > 0 ? ", \"" : "\"";
+        json += operationName(static_cast<InstrumentedOperation>(i));
+        json += "\": {";
+        appendField(json, "calls", statistics.calls);
+        json += ", ";
+        appendField(json, "nanoseconds", statistics.nanoseconds);
+        json += ", \"lengths\": [";
+        std::size_t used = LengthBuckets;
+        while (used > 0 && statistics.lengths[used - 1] == 0) {
+            --used;
+        }
+        for (std::size_t bucket = 0; bucket < used; ++bucket) {
+            if (bucket > 0) {
+                json += ", ";
+            }
+            json += std::to_string(statistics.lengths[bucket]);
+        }
+        json += "]}";
+    }
+    json += "}, ";
+    appendField(json, "allocations", allocations);
+    json += ", ";
+    appendField(json, "allocatedBytes", allocatedBytes);
+    json += ", ";
+    appendField(json, "reallocations", reallocations);
+    json += ", ";
+    appendField(json, "copiesOnWrite", copiesOnWrite);
+    json += '}';
+    return json;
+}
+
+const char* operationName(InstrumentedOperation operation) {
+    switch (operation) {
+    case InstrumentedOperation::Construct:
+        return "construct";
+    case InstrumentedOperation::Parse:
+        return "parse";
+    case InstrumentedOperation::Add:
+        return "add";
+    case InstrumentedOperation::Subtract:
+        return "subtract";
+    case InstrumentedOperation::Multiply:
+        return "multiply";
+    case InstrumentedOperation::Divide:
+        return "divide";
+    case InstrumentedOperation::Compare:
+        return "compare";
+    case InstrumentedOperation::ToString:
+        return "toString";
+    case InstrumentedOperation::Count:
+        break;
+    }
+    return "unknown";
+}
+
+InstrumentationSnapshot instrumentationSnapshot() {
+    InstrumentationSnapshot snapshot;
+#if APMATH_INSTRUMENTATION
+    const Counters& current = counters();
+    snapshot.enabled = true;
+    for (std::size_t i = 0; i < OperationCount; ++i) {
+        snapshot.operations[i].calls = load(current.operations[i].calls);
+        snapshot.operations[i].nanoseconds = load(current.operations[i].nanoseconds);
+        for (std::size_t bucket = 0; bucket < LengthBuckets; ++bucket) {
+            snapshot.operations[i].lengths[bucket] = load(current.operations[i].lengths[bucket]);
+        }
+    }
+    snapshot.allocations = load(current.allocations);
+    snapshot.allocatedBytes = load(current.allocatedBytes);
+    snapshot.reallocations = load(current.reallocations);
+    snapshot.copiesOnWrite = load(current.copiesOnWrite);
+#endif
+    return snapshot;
+}
+
+void resetInstrumentation() {
+#if APMATH_INSTRUMENTATION
+    Counters& current = counters();
+    for (OperationCounters& operation : current.operations) {
+        operation.calls.store(0, std::memory_order_relaxed);
+        operation.nanoseconds.store(0, std::memory_order_relaxed);
+        for (std::atomic<std::uint64_t>& bucket : operation.lengths) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+    current.allocations.store(0, std::memory_order_relaxed);
+    current.allocatedBytes.store(0, std::memory_order_relaxed);
+    current.reallocations.store(0, std::memory_order_relaxed);
+    current.copiesOnWrite.store(0, std::memory_order_relaxed);
+#endif
+}
+
+#if APMATH_INSTRUMENTATION
+namespace detail {
+
+void recordOperation(InstrumentedOperation operation, std::size_t limbs, std::uint64_t nanoseconds) {
+    OperationCounters& counter = counters().operations[static_cast<std::size_t>(operation)];
+    increment(counter.calls);
+    increment(counter.nanoseconds, nanoseconds);
+    increment(counter.lengths[lengthBucket(limbs)]);
+}
+
+void recordAllocation(std::size_t bytes, bool reallocation) {
+    Counters& current = counters();
+    increment(current.allocations);
+    increment(current.allocatedBytes, bytes);
+    if (reallocation) {
+        increment(current.reallocations);
+    }
+}
+
+void recordCopyOnWrite() {
+    increment(counters().copiesOnWrite);
+}
+
+} // namespace detail
+#endif
+
+} // namespace apmath
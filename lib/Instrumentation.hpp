@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifndef APMATH_INSTRUMENTATION
+#define APMATH_INSTRUMENTATION 0
+#endif
+
+#if APMATH_INSTRUMENTATION
+#include <chrono>
+#endif
+
+/**
+ * Operation counters of the library, built with the BIG_NUMBER_INSTRUMENTATION CMake option.
+ * Every instrumented operation counts its calls, time and the length of its longest operand,
+ * every limb buffer allocation counts its bytes. Counters are relaxed atomics shared by all threads.
+ * Without the option the hooks are empty inline functions and snapshots stay zero.
+ */
+namespace apmath {
+
+/**
+ * @brief InstrumentedOperation - operations with their own counters
+ */
+enum class InstrumentedOperation {
+    Construct,  // from a native integer
+    Parse,      // from decimal text
+    Add,        // += and + with BigInteger and native operands
+    Subtract,
+    Multiply,   // *, *= and multiply-accumulate
+    Divide,     // /, % and divmod
+    Compare,
+    ToString,   // toString, to_chars and stream output
+    Count
+};
+
+/**
+ * @brief LengthBuckets - buckets of operand length histograms. Bucket k counts operands
+ * of 2^(k-1) to 2^k - 1 limbs, bucket 0 counts zero, the last bucket counts all longer ones.
+ */
+constexpr std::size_t LengthBuckets = 40;
+
+/**
+ * @brief OperationStatistics - counters of one operation
+ */
+struct OperationStatistics {
+    std::uint64_t calls = 0;
+    std::uint64_t nanoseconds = 0;
+    std::array<std::uint64_t, LengthBuckets> lengths = {};
+};
+
+/**
+ * @brief InstrumentationSnapshot - copy of all counters at one moment
+ */
+struct InstrumentationSnapshot {
+    bool enabled = false;
+    std::array<OperationStatistics, static_cast<std::size_t>(InstrumentedOperation::Count)> operations = {};
+    // Limb buffers allocated, and the ones which copied limbs of a shorter buffer
+    std::uint64_t allocations = 0;
+    std::uint64_t allocatedBytes = 0;
+    std::uint64_t reallocations = 0;
+    // Buffers copied on the first write to a copy sharing them
+    std::uint64_t copiesOnWrite = 0;
+
+    const OperationStatistics& operator[](InstrumentedOperation operation) const {
+        return operations[static_cast<std::size_t>(operation)];
+    }
+
+    /**
+     * @brief toJson - counters as a JSON object, histograms are arrays without trailing zero buckets
+     */
+    std::string toJson() const;
+};
+
+/**
+ * @brief operationName - lower camel case name of the operation used in JSON
+ */
+const char* operationName(InstrumentedOperation operation);
+/**
+ * @brief instrumentationSnapshot - current counters
+ */
+InstrumentationSnapshot instrumentationSnapshot();
+/**
+ * @brief resetInstrumentation - sets all counters to zero
+ */
+void resetInstrumentation();
+
+namespace detail {
+
+#if APMATH_INSTRUMENTATION
+void recordOperation(InstrumentedOperation operation, std::size_t limbs, std::uint64_t nanoseconds);
+void recordAllocation(std::size_t bytes, bool reallocation);
+void recordCopyOnWrite();
+
+/**
+ * @brief OperationScope - records an operation with its time when it goes out of scope
+ */
+class OperationScope {
+public:
+    OperationScope(InstrumentedOperation operation, std::size_t limbs)
+        : mOperation(operation),
+          mLimbs(limbs),
+          mStart(std::chrono::steady_clock::now())
+    {}
+    OperationScope(const OperationScope&) = delete;
+    OperationScope& operator=(const OperationScope&) = delete;
+
+    ~OperationScope() {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - mStart);
+        recordOperation(mOperation, mLimbs, static_cast<std::uint64_t>(elapsed.count()));
+    }
+
+    /**
+     * @brief setLimbs - replaces the operand length, when it's known only at the end
+     */
+    void setLimbs(std::size_t limbs) { mLimbs = limbs; }
+
+private:
+    InstrumentedOperation mOperation;
+    std::size_t mLimbs;
+    std::chrono::steady_clock::time_point mStart;
+};
+#else
+inline void recordAllocation(std::size_t, bool) {}
+inline void recordCopyOnWrite() {}
+
+class OperationScope {
+public:
+    OperationScope(InstrumentedOperation, std::size_t) {}
+    OperationScope(const OperationScope&) = delete;
+    OperationScope& operator=(const OperationScope&) = delete;
+
+    void setLimbs(std::size_t) {}
+};
+#endif
+
+} // namespace detail
+} // namespace apmath
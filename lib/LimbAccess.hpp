@@ -0,0 +1,29 @@
+#pragma once
+
+#include "BigInteger.hpp"
+
+namespace apmath {
+namespace detail {
+
+/**
+ * @brief LimbAccess - gives the library's free functions access to the representation of BigInteger.
+ * The magnitude is little-endian limbs without high zero limbs, zero has no limbs and plus sign.
+ */
+class LimbAccess {
+public:
+    static const LimbStorage& limbs(const BigInteger& value) { return value.mLimbs; }
+    static LimbStorage& limbs(BigInteger& value) { return value.mLimbs; }
+
+    static bool isNegative(const BigInteger& value) { return value.mSign == BigInteger::Minus; }
+    /**
+     * @brief setNegative - sets the sign of the limbs written with limbs(),
+     * drops their high zero limbs and keeps zero positive
+     */
+    static void setNegative(BigInteger& value, bool negative) {
+        value.mSign = negative ? BigInteger::Minus : BigInteger::Plus;
+        value.normalize();
+    }
+};
+
+} // namespace detail
+} // namespace apmath
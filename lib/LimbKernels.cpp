@@ -0,0 +1,280 @@
+#include "LimbKernels.hpp"
+#include "LimbKernelsX86.hpp"
+#include "Tuning.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+using apmath::Limb;
+using apmath::SimdLevel;
+
+// Vector kernels pay for their setup from this length on
+constexpr size_t SimdMinLength = 16;
+
+// Classical addition with carry, one limb at a time.
+// The carry out of a limb is detected by unsigned wraparound.
+Limb addSameLength(Limb* r, const Limb* a, const Limb* b, size_t n) {
+    Limb carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        Limb sum = a[i] + carry;
+        carry = sum < carry;
+        Limb limbSum = sum + b[i];
+        carry += limbSum < sum;
+        r[i] = limbSum;
+    }
+    return carry;
+}
+
+// Classical subtraction with borrow, looks similar to addition.
+Limb subtractSameLength(Limb* r, const Limb* a, const Limb* b, size_t n) {
+    Limb borrow = 0;
+    for (size_t i = 0; i < n; ++i) {
+        Limb lhs = a[i];
+        Limb diff = lhs - b[i];
+        Limb nextBorrow = diff > lhs;
+        r[i] = diff - borrow;
+        borrow = nextBorrow + (diff < borrow);
+    }
+    return borrow;
+}
+
+int compareSameLength(const Limb* a, const Limb* b, size_t n) {
+    for (size_t i = n; i-- > 0; ) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief SimdKernels - kernels of one instruction set working on operands of the same length
+ */
+struct SimdKernels {
+    SimdLevel level;
+    Limb (*add)(Limb* r, const Limb* a, const Limb* b, size_t n);
+    Limb (*subtract)(Limb* r, const Limb* a, const Limb* b, size_t n);
+    int (*compare)(const Limb* a, const Limb* b, size_t n);
+};
+
+const SimdKernels ScalarKernels = {SimdLevel::Scalar, addSameLength, subtractSameLength, compareSameLength};
+#if APMATH_X86_KERNELS
+const SimdKernels Avx2Kernels = {SimdLevel::Avx2, apmath::detail::addLimbsAvx2,
+                                 apmath::detail::subtractLimbsAvx2, apmath::detail::compareLimbsAvx2};
+const SimdKernels Avx512Kernels = {SimdLevel::Avx512, apmath::detail::addLimbsAvx512,
+                                   apmath::detail::subtractLimbsAvx512, apmath::detail::compareLimbsAvx512};
+#endif
+
+// Kernels of the level if both the build and the CPU support it, nullptr otherwise
+const SimdKernels* supportedKernels(SimdLevel level) {
+#if APMATH_X86_KERNELS
+    __builtin_cpu_init();
+#endif
+    switch (level) {
+    case SimdLevel::Scalar:
+        return &ScalarKernels;
+#if APMATH_X86_KERNELS
+    case SimdLevel::Avx2:
+        return __builtin_cpu_supports("avx2") ? &Avx2Kernels : nullptr;
+    case SimdLevel::Avx512:
+        return __builtin_cpu_supports("avx512f") ? &Avx512Kernels : nullptr;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+const SimdKernels* bestKernels() {
+    for (SimdLevel level : {SimdLevel::Avx512, SimdLevel::Avx2}) {
+        if (const SimdKernels* kernels = supportedKernels(level)) {
+            return kernels;
+        }
+    }
+    return &ScalarKernels;
+}
+
+// Chosen on the first use, so the CPU is checked once and static initialization order doesn't matter
+std::atomic<const SimdKernels*> activeKernels(nullptr);
+
+const SimdKernels& kernels() {
+    const SimdKernels* active = activeKernels.load(std::memory_order_relaxed);
+    if (active == nullptr) {
+        active = bestKernels();
+        activeKernels.store(active, std::memory_order_relaxed);
+    }
+    return *active;
+}
+
+// The carry runs through the high limbs of the longer operand until it's absorbed,
+// the rest of them is copied unless the result is computed in place
+Limb propagateCarry(Limb* r, const Limb* a, size_t n, Limb carry) {
+    size_t i = 0;
+    for ( ; i < n && carry != 0; ++i) {
+        r[i] = a[i] + 1;
+        carry = r[i] == 0;
+    }
+    if (r != a) {
+        std::copy(a + i, a + n, r + i);
+    }
+    return carry;
+}
+
+Limb propagateBorrow(Limb* r, const Limb* a, size_t n, Limb borrow) {
+    size_t i = 0;
+    for ( ; i < n && borrow != 0; ++i) {
+        Limb lhs = a[i];
+        r[i] = lhs - 1;
+        borrow = lhs == 0;
+    }
+    if (r != a) {
+        std::copy(a + i, a + n, r + i);
+    }
+    return borrow;
+}
+
+} // namespace
+
+namespace apmath {
+
+SimdLevel simdLevel() {
+    return kernels().level;
+}
+
+bool setSimdLevel(SimdLevel level) {
+    const SimdKernels* supported = supportedKernels(level);
+    if (supported == nullptr) {
+        return false;
+    }
+    activeKernels.store(supported, std::memory_order_relaxed);
+    return true;
+}
+
+namespace detail {
+
+// Short operands stay with the scalar loops, vector ones need some length to pay off
+Limb addLimbs(Limb* r, const Limb* a, std::size_t an, const Limb* b, std::size_t bn) {
+    Limb carry = bn < SimdMinLength ? addSameLength(r, a, b, bn) : kernels().add(r, a, b, bn);
+    return propagateCarry(r + bn, a + bn, an - bn, carry);
+}
+
+Limb subtractLimbs(Limb* r, const Limb* a, std::size_t an, const Limb* b, std::size_t bn) {
+    Limb borrow = bn < SimdMinLength ? subtractSameLength(r, a, b, bn) : kernels().subtract(r, a, b, bn);
+    return propagateBorrow(r + bn, a + bn, an - bn, borrow);
+}
+
+int compareLimbs(const Limb* a, std::size_t an, const Limb* b, std::size_t bn) {
+    if (an != bn) {
+        return an < bn ? -1 : 1;
+    }
+    return an < SimdMinLength ? compareSameLength(a, b, an) : kernels().compare(a, b, an);
+}
+
+Limb negateLimbs(Limb* r, const Limb* a, std::size_t n) {
+    Limb borrow = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        Limb limb = a[i];
+        r[i] = 0 - limb - borrow;
+        borrow = limb != 0 || borrow != 0;
+    }
+    return borrow;
+}
+
+Limb multiplyByLimb(Limb* r, const Limb* a, std::size_t n, Limb m, Limb carry) {
+    for (std::size_t i = 0; i < n; ++i) {
+        DoubleLimb product = static_cast<DoubleLimb>(a[i]) * m + carry;
+        r[i] = static_cast<Limb>(product);
+        carry = static_cast<Limb>(product >> LimbBits);
+    }
+    return carry;
+}
+
+Limb addMultiplyByLimb(Limb* r, const Limb* a, std::size_t n, Limb m) {
+    Limb carry = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        DoubleLimb product = static_cast<DoubleLimb>(a[i]) * m + r[i] + carry;
+        r[i] = static_cast<Limb>(product);
+        carry = static_cast<Limb>(product >> LimbBits);
+    }
+    return carry;
+}
+
+Limb subtractMultiplyByLimb(Limb* r, const Limb* a, std::size_t n, Limb m) {
+    Limb borrow = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        DoubleLimb product = static_cast<DoubleLimb>(a[i]) * m + borrow;
+        Limb low = static_cast<Limb>(product);
+        borrow = static_cast<Limb>(product >> LimbBits);
+        Limb lhs = r[i];
+        r[i] = lhs - low;
+        borrow += r[i] > lhs;
+    }
+    return borrow;
+}
+
+Limb shiftLeftLimbs(Limb* r, const Limb* a, std::size_t n, unsigned shift) {
+    if (shift == 0) {
+        for (std::size_t i = n; i-- > 0; ) {
+            r[i] = a[i];
+        }
+        return 0;
+    }
+    Limb out = 0;
+    for (std::size_t i = n; i-- > 0; ) {
+        Limb limb = a[i];
+        if (i + 1 == n) {
+            out = limb >> (LimbBits - shift);
+        }
+        r[i] = (limb << shift) | (i > 0 ? a[i - 1] >> (LimbBits - shift) : 0);
+    }
+    return out;
+}
+
+void shiftRightLimbs(Limb* r, const Limb* a, std::size_t n, unsigned shift) {
+    if (shift == 0) {
+        for (std::size_t i = 0; i < n; ++i) {
+            r[i] = a[i];
+        }
+        return;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        r[i] = (a[i] >> shift) | (i + 1 < n ? a[i + 1] << (LimbBits - shift) : 0);
+    }
+}
+
+// Schoolbook division from the most significant limb down.
+// Short numbers use hardware division, it's cheaper than preparing the reciprocal.
+Limb divideByLimb(Limb* q, const Limb* a, std::size_t n, Limb d) {
+    if (n > 2) {
+        return LimbDivisor(d).divide(q, a, n);
+    }
+    DoubleLimb remainder = 0;
+    for (std::size_t i = n; i-- > 0; ) {
+        DoubleLimb current = (remainder << LimbBits) | a[i];
+        q[i] = static_cast<Limb>(current / d);
+        remainder = current % d;
+    }
+    return static_cast<Limb>(remainder);
+}
+
+// Exact division by multiplication with the inverse of d modulo 2^LimbBits
+// (Jebelean's algorithm), no hardware division is involved.
+void divideExactByLimb(Limb* q, const Limb* a, std::size_t n, Limb d) {
+    // Newton iteration doubles the number of correct low bits: 3 -> 6 -> ... -> 96
+    Limb inverse = d;
+    for (int i = 0; i < 5; ++i) {
+        inverse *= 2 - d * inverse;
+    }
+    Limb borrow = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        Limb limb = a[i];
+        Limb nextBorrow = limb < borrow;
+        Limb quotient = (limb - borrow) * inverse;
+        q[i] = quotient;
+        borrow = nextBorrow + static_cast<Limb>((static_cast<DoubleLimb>(quotient) * d) >> LimbBits);
+    }
+}
+
+} // namespace detail
+} // namespace apmath
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <cstddef>
+
+#include "BigInteger.hpp"
+
+/**
+ * Low-level kernels working on little-endian limb arrays.
+ * Kernels take raw pointers and lengths, so they don't care how the limbs are stored.
+ */
+namespace apmath {
+namespace detail {
+
+#if APMATH_LIMB_BITS == 64
+__extension__ typedef unsigned __int128 DoubleLimb;
+__extension__ typedef __int128 SignedDoubleLimb;
+#else
+typedef std::uint64_t DoubleLimb;
+typedef std::int64_t SignedDoubleLimb;
+#endif
+
+constexpr unsigned LimbBits = APMATH_LIMB_BITS;
+
+/**
+ * @brief countLeadingZeroBits - number of high zero bits in a nonzero limb
+ */
+inline unsigned countLeadingZeroBits(Limb limb) {
+#if APMATH_LIMB_BITS == 64
+    return static_cast<unsigned>(__builtin_clzll(limb));
+#else
+    return static_cast<unsigned>(__builtin_clz(limb));
+#endif
+}
+/**
+ * @brief countTrailingZeroBits - number of low zero bits in a nonzero limb
+ */
+inline unsigned countTrailingZeroBits(Limb limb) {
+#if APMATH_LIMB_BITS == 64
+    return static_cast<unsigned>(__builtin_ctzll(limb));
+#else
+    return static_cast<unsigned>(__builtin_ctz(limb));
+#endif
+}
+/**
+ * @brief countOneBits - number of one bits in a limb
+ */
+inline unsigned countOneBits(Limb limb) {
+#if APMATH_LIMB_BITS == 64
+    return static_cast<unsigned>(__builtin_popcountll(limb));
+#else
+    return static_cast<unsigned>(__builtin_popcount(limb));
+#endif
+}
+/**
+ * @brief addLimbs - computes r = a + b
+ * @param r - result with room for an limbs, may alias a or b
+ * @param a, an - greater or equal length operand
+ * @param b, bn - operand with bn <= an
+ * @return carry out of the top limb
+ */
+Limb addLimbs(Limb* r, const Limb* a, std::size_t an, const Limb* b, std::size_t bn);
+/**
+ * @brief subtractLimbs - computes r = a - b
+ * @param r - result with room for an limbs, may alias a or b
+ * @param a, an - greater or equal length operand
+ * @param b, bn - operand with bn <= an
+ * @return borrow out of the top limb, zero when a >= b
+ */
+Limb subtractLimbs(Limb* r, const Limb* a, std::size_t an, const Limb* b, std::size_t bn);
+/**
+ * @brief compareLimbs - compares magnitudes without high zero limbs
+ * @return Negative value if a is less than b.
+ * Zero if a and b compare equal.
+ * Positive value if a is greater than b.
+ */
+int compareLimbs(const Limb* a, std::size_t an, const Limb* b, std::size_t bn);
+/**
+ * @brief negateLimbs - computes r = -a modulo B^n, two's complement of a
+ * @param r - result with room for n limbs, may alias a
+ * @return borrow, zero only when a is zero
+ */
+Limb negateLimbs(Limb* r, const Limb* a, std::size_t n);
+/**
+ * @brief multiplyByLimb - computes r = a * m + carry
+ * @param r - result with room for n limbs, may alias a
+ * @return carry out of the top limb
+ */
+Limb multiplyByLimb(Limb* r, const Limb* a, std::size_t n, Limb m, Limb carry);
+/**
+ * @brief addMultiplyByLimb - computes r += a * m
+ * @param r - accumulator, the lowest n limbs are updated
+ * @return carry out of the n-th limb
+ */
+Limb addMultiplyByLimb(Limb* r, const Limb* a, std::size_t n, Limb m);
+/**
+ * @brief subtractMultiplyByLimb - computes r -= a * m
+ * @param r - accumulator, the lowest n limbs are updated
+ * @return borrow out of the n-th limb
+ */
+Limb subtractMultiplyByLimb(Limb* r, const Limb* a, std::size_t n, Limb m);
+/**
+ * @brief shiftLeftLimbs - computes r = a << shift
+ * @param r - result with room for n limbs, may alias a or overlap it from above
+ * @param shift - bit count less than LimbBits
+ * @return bits shifted out of the top limb
+ */
+Limb shiftLeftLimbs(Limb* r, const Limb* a, std::size_t n, unsigned shift);
+/**
+ * @brief shiftRightLimbs - computes r = a >> shift
+ * @param r - result with room for n limbs, may alias a or overlap it from below
+ * @param shift - bit count less than LimbBits
+ */
+void shiftRightLimbs(Limb* r, const Limb* a, std::size_t n, unsigned shift);
+/**
+ * @brief divideByLimb - computes q = a / d
+ * @param q - quotient with room for n limbs, may alias a
+ * @return remainder
+ */
+Limb divideByLimb(Limb* q, const Limb* a, std::size_t n, Limb d);
+/**
+ * @brief LimbDivisor - single-limb divisor with a precomputed reciprocal.
+ * Every quotient limb costs two multiplications instead of a double-limb hardware division
+ * (Moller, Granlund "Improved division by invariant integers", 2011).
+ */
+class LimbDivisor {
+public:
+    explicit LimbDivisor(Limb divisor)
+        : mDivisor(divisor),
+          mShift(countLeadingZeroBits(divisor)),
+          mNormalized(divisor << mShift),
+          mReciprocal(static_cast<Limb>(((static_cast<DoubleLimb>(static_cast<Limb>(~mNormalized)) << LimbBits) |
+                                          static_cast<Limb>(~Limb(0))) / mNormalized))
+    {}
+
+    Limb divisor() const { return mDivisor; }
+
+    /**
+     * @brief divide - computes q = a / divisor
+     * @param q - quotient with room for n limbs, may alias a
+     * @return remainder
+     */
+    Limb divide(Limb* q, const Limb* a, std::size_t n) const {
+        if (n == 0) {
+            return 0;
+        }
+        Limb remainder = mShift == 0 ? 0 : a[n - 1] >> (LimbBits - mShift);
+        for (std::size_t i = n; i-- > 0; ) {
+            q[i] = divideStep(remainder, shiftedLimb(a, i));
+        }
+        return remainder >> mShift;
+    }
+
+    /**
+     * @brief remainder - computes a % divisor without storing the quotient
+     */
+    Limb remainder(const Limb* a, std::size_t n) const {
+        if (n == 0) {
+            return 0;
+        }
+        Limb remainder = mShift == 0 ? 0 : a[n - 1] >> (LimbBits - mShift);
+        for (std::size_t i = n; i-- > 0; ) {
+            divideStep(remainder, shiftedLimb(a, i));
+        }
+        return remainder >> mShift;
+    }
+
+private:
+    Limb mDivisor;
+    unsigned mShift;
+    Limb mNormalized;
+    Limb mReciprocal;
+
+    // i-th limb of a << mShift
+    Limb shiftedLimb(const Limb* a, std::size_t i) const {
+        if (mShift == 0) {
+            return a[i];
+        }
+        return static_cast<Limb>(a[i] << mShift) | (i > 0 ? a[i - 1] >> (LimbBits - mShift) : 0);
+    }
+
+    // Divides high * B + low by the normalized divisor, high < divisor.
+    // Returns the quotient, the remainder replaces high.
+    Limb divideStep(Limb& high, Limb low) const {
+        DoubleLimb estimate = static_cast<DoubleLimb>(mReciprocal) * high +
+                              ((static_cast<DoubleLimb>(high) << LimbBits) | low);
+        Limb quotient = static_cast<Limb>(estimate >> LimbBits) + 1;
+        Limb remainder = static_cast<Limb>(low - quotient * mNormalized);
+        if (remainder > static_cast<Limb>(estimate)) {
+            --quotient;
+            remainder += mNormalized;
+        }
+        if (remainder >= mNormalized) {
+            ++quotient;
+            remainder -= mNormalized;
+        }
+        high = remainder;
+        return quotient;
+    }
+};
+/**
+ * @brief divideExactByLimb - computes q = a / d when a is known to be a multiple of odd d
+ * @param q - quotient with room for n limbs, may alias a
+ */
+void divideExactByLimb(Limb* q, const Limb* a, std::size_t n, Limb d);
+/**
+ * @brief significantLength - length of the array without high zero limbs
+ */
+inline std::size_t significantLength(const Limb* a, std::size_t n) {
+    while (n > 0 && a[n - 1] == 0) {
+        --n;
+    }
+    return n;
+}
+
+} // namespace detail
+} // namespace apmath
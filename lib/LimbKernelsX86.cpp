@@ -0,0 +1,184 @@
+#include "LimbKernelsX86.hpp"
+
+#if APMATH_X86_KERNELS
+
+#include <immintrin.h>
+
+#include <limits>
+
+namespace apmath {
+namespace detail {
+
+namespace {
+
+// Scalar loops finish the limbs which don't fill a whole vector
+inline Limb addTail(Limb* r, const Limb* a, const Limb* b, size_t n, Limb carry) {
+    for (size_t i = 0; i < n; ++i) {
+        Limb sum = a[i] + carry;
+        carry = sum < carry;
+        Limb limbSum = sum + b[i];
+        carry += limbSum < sum;
+        r[i] = limbSum;
+    }
+    return carry;
+}
+
+inline Limb subtractTail(Limb* r, const Limb* a, const Limb* b, size_t n, Limb borrow) {
+    for (size_t i = 0; i < n; ++i) {
+        Limb lhs = a[i];
+        Limb diff = lhs - b[i];
+        Limb nextBorrow = diff > lhs;
+        r[i] = diff - borrow;
+        borrow = nextBorrow + (diff < borrow);
+    }
+    return borrow;
+}
+
+inline int compareTail(const Limb* a, const Limb* b, size_t n) {
+    for (size_t i = n; i-- > 0; ) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// Carry-lookahead over the lanes of one vector.
+// Returns the mask of lanes which receive a carry, the carry out of the top lane replaces carry.
+inline unsigned carryLanes(unsigned generate, unsigned propagate, unsigned& carry, unsigned lanes) {
+    unsigned sum = ((generate << 1) | carry) + propagate;
+    carry = sum >> lanes;
+    return (sum ^ propagate) & ((1u << lanes) - 1);
+}
+
+// The highest lane set in a nonzero mask
+inline unsigned topLane(unsigned mask) {
+    return 31 - static_cast<unsigned>(__builtin_clz(mask));
+}
+
+__attribute__((target("avx2")))
+inline unsigned laneMask(__m256i lanes) {
+    return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(lanes)));
+}
+
+// Lanes of the mask as all-ones lanes, that is -1
+__attribute__((target("avx2")))
+inline __m256i maskLanes(unsigned mask) {
+    const __m256i laneBits = _mm256_setr_epi64x(1, 2, 4, 8);
+    return _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(mask), laneBits), laneBits);
+}
+
+// AVX2 has only signed comparison, unsigned a < b is the signed one with flipped sign bits
+__attribute__((target("avx2")))
+inline __m256i lessUnsigned(__m256i a, __m256i b) {
+    const __m256i signBit = _mm256_set1_epi64x(std::numeric_limits<long long>::min());
+    return _mm256_cmpgt_epi64(_mm256_xor_si256(b, signBit), _mm256_xor_si256(a, signBit));
+}
+
+} // namespace
+
+__attribute__((target("avx2")))
+Limb addLimbsAvx2(Limb* r, const Limb* a, const Limb* b, size_t n) {
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    unsigned carry = 0;
+    size_t i = 0;
+    for ( ; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i sum = _mm256_add_epi64(x, y);
+        unsigned generate = laneMask(lessUnsigned(sum, x));
+        unsigned propagate = laneMask(_mm256_cmpeq_epi64(sum, ones));
+        sum = _mm256_sub_epi64(sum, maskLanes(carryLanes(generate, propagate, carry, 4)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), sum);
+    }
+    return addTail(r + i, a + i, b + i, n - i, carry);
+}
+
+__attribute__((target("avx2")))
+Limb subtractLimbsAvx2(Limb* r, const Limb* a, const Limb* b, size_t n) {
+    const __m256i zero = _mm256_setzero_si256();
+    unsigned borrow = 0;
+    size_t i = 0;
+    for ( ; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i diff = _mm256_sub_epi64(x, y);
+        unsigned generate = laneMask(lessUnsigned(x, y));
+        unsigned propagate = laneMask(_mm256_cmpeq_epi64(diff, zero));
+        diff = _mm256_add_epi64(diff, maskLanes(carryLanes(generate, propagate, borrow, 4)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), diff);
+    }
+    return subtractTail(r + i, a + i, b + i, n - i, borrow);
+}
+
+__attribute__((target("avx2")))
+int compareLimbsAvx2(const Limb* a, const Limb* b, size_t n) {
+    size_t i = n;
+    for ( ; i >= 4; i -= 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i - 4));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i - 4));
+        unsigned different = ~laneMask(_mm256_cmpeq_epi64(x, y)) & 0xF;
+        if (different != 0) {
+            size_t j = i - 4 + topLane(different);
+            return a[j] < b[j] ? -1 : 1;
+        }
+    }
+    return compareTail(a, b, i);
+}
+
+__attribute__((target("avx512f")))
+Limb addLimbsAvx512(Limb* r, const Limb* a, const Limb* b, size_t n) {
+    const __m512i ones = _mm512_set1_epi64(-1);
+    unsigned carry = 0;
+    size_t i = 0;
+    for ( ; i + 8 <= n; i += 8) {
+        __m512i x = _mm512_loadu_si512(a + i);
+        __m512i y = _mm512_loadu_si512(b + i);
+        __m512i sum = _mm512_add_epi64(x, y);
+        unsigned generate = _mm512_cmplt_epu64_mask(sum, x);
+        unsigned propagate = _mm512_cmpeq_epu64_mask(sum, ones);
+        __mmask8 carries = static_cast<__mmask8>(carryLanes(generate, propagate, carry, 8));
+        sum = _mm512_mask_sub_epi64(sum, carries, sum, ones);
+        _mm512_storeu_si512(r + i, sum);
+    }
+    return addTail(r + i, a + i, b + i, n - i, carry);
+}
+
+__attribute__((target("avx512f")))
+Limb subtractLimbsAvx512(Limb* r, const Limb* a, const Limb* b, size_t n) {
+    const __m512i ones = _mm512_set1_epi64(-1);
+    const __m512i zero = _mm512_setzero_si512();
+    unsigned borrow = 0;
+    size_t i = 0;
+    for ( ; i + 8 <= n; i += 8) {
+        __m512i x = _mm512_loadu_si512(a + i);
+        __m512i y = _mm512_loadu_si512(b + i);
+        __m512i diff = _mm512_sub_epi64(x, y);
+        unsigned generate = _mm512_cmplt_epu64_mask(x, y);
+        unsigned propagate = _mm512_cmpeq_epu64_mask(diff, zero);
+        __mmask8 borrows = static_cast<__mmask8>(carryLanes(generate, propagate, borrow, 8));
+        diff = _mm512_mask_add_epi64(diff, borrows, diff, ones);
+        _mm512_storeu_si512(r + i, diff);
+    }
+    return subtractTail(r + i, a + i, b + i, n - i, borrow);
+}
+
+__attribute__((target("avx512f")))
+int compareLimbsAvx512(const Limb* a, const Limb* b, size_t n) {
+    size_t i = n;
+    for ( ; i >= 8; i -= 8) {
+        __m512i x = _mm512_loadu_si512(a + i - 8);
+        __m512i y = _mm512_loadu_si512(b + i - 8);
+        unsigned different = _mm512_cmpneq_epu64_mask(x, y);
+        if (different != 0) {
+            size_t j = i - 8 + topLane(different);
+            return a[j] < b[j] ? -1 : 1;
+        }
+    }
+    return compareTail(a, b, i);
+}
+
+} // namespace detail
+} // namespace apmath
+
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+
+#include "BigInteger.hpp"
+
+#if defined(__x86_64__) && APMATH_LIMB_BITS == 64
+#define APMATH_X86_KERNELS 1
+#else
+#define APMATH_X86_KERNELS 0
+#endif
+
+/**
+ * Vectorized kernels for x86-64 with 64-bit limbs.
+ * They are compiled for AVX2 and AVX-512 regardless of the build flags,
+ * so they may be called only after the CPU is checked to support the instruction set.
+ *
+ * Carries between lanes are resolved with carry-lookahead on lane masks:
+ * a lane generates a carry if its sum wraps around and propagates an incoming one if its sum is all ones.
+ * Adding the propagate mask to the shifted generate mask ripples every carry through its run of
+ * propagating lanes in a single scalar addition.
+ */
+#if APMATH_X86_KERNELS
+namespace apmath {
+namespace detail {
+
+/**
+ * @brief addLimbsAvx2, addLimbsAvx512 - compute r = a + b for n limbs each
+ * @param r - result with room for n limbs, may alias a or b
+ * @return carry out of the top limb
+ */
+Limb addLimbsAvx2(Limb* r, const Limb* a, const Limb* b, std::size_t n);
+Limb addLimbsAvx512(Limb* r, const Limb* a, const Limb* b, std::size_t n);
+/**
+ * @brief subtractLimbsAvx2, subtractLimbsAvx512 - compute r = a - b for n limbs each
+ * @param r - result with room for n limbs, may alias a or b
+ * @return borrow out of the top limb
+ */
+Limb subtractLimbsAvx2(Limb* r, const Limb* a, const Limb* b, std::size_t n);
+Limb subtractLimbsAvx512(Limb* r, const Limb* a, const Limb* b, std::size_t n);
+/**
+ * @brief compareLimbsAvx2, compareLimbsAvx512 - compare n limbs each from the top
+ * @return negative, zero or positive value like compareLimbs
+ */
+int compareLimbsAvx2(const Limb* a, const Limb* b, std::size_t n);
+int compareLimbsAvx512(const Limb* a, const Limb* b, std::size_t n);
+
+} // namespace detail
+} // namespace apmath
+#endif
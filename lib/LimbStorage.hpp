@@ -0,0 +1,307 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+#include "Instrumentation.hpp"
+
+#ifndef APMATH_LIMB_BITS
+#define APMATH_LIMB_BITS 64
+#endif
+
+#ifndef APMATH_SHARED_LIMBS
+#define APMATH_SHARED_LIMBS 0
+#endif
+
+namespace apmath {
+
+/**
+ * @brief Limb - machine word holding a part of the binary magnitude.
+ * Limb width is chosen at configure time with BIG_NUMBER_LIMB_BITS.
+ */
+#if APMATH_LIMB_BITS == 64
+using Limb = std::uint64_t;
+#elif APMATH_LIMB_BITS == 32
+using Limb = std::uint32_t;
+#else
+#error "APMATH_LIMB_BITS must be 32 or 64"
+#endif
+
+/**
+ * @brief SharedLimbs - copies of long numbers share their limbs until one of them is changed,
+ * chosen at configure time with BIG_NUMBER_SHARED_LIMBS
+ */
+constexpr bool SharedLimbs = APMATH_SHARED_LIMBS != 0;
+
+namespace detail {
+
+/**
+ * @brief LimbStorage - limb array with inline room for word-sized values.
+ *
+ * Up to InlineCapacity limbs are kept inside the object, so small numbers never touch the heap.
+ * Longer arrays move to a buffer which grows geometrically and is kept when the array shrinks.
+ * New limbs are zero-initialized, the same way std::vector::resize does it.
+ *
+ * Buffers come from a polymorphic memory resource. Copies and moves take the resource of the source,
+ * assignment keeps the resource of the destination.
+ *
+ * With SharedLimbs copies share an allocated buffer, which counts its owners atomically, so copying a long number
+ * costs O(1). Assignment shares the buffer only if the destination has no buffer of its own to copy the limbs into.
+ * The first write through a copy whose buffer has other owners copies the limbs (copy-on-write):
+ * the non-const data(), operator[] and back(), and calls which append limbs. Shrinking doesn't copy,
+ * the size belongs to each owner. Copies may be used in different threads like copies of std::shared_ptr.
+ * Without SharedLimbs copies copy the limbs and writes don't check the owner count.
+ * Pointers from the non-const data() stay valid until the storage is copied, resized, or destroyed.
+ */
+class LimbStorage {
+public:
+    /**
+     * @brief InlineCapacity - number of limbs stored without allocation, two 64-bit words
+     */
+    static constexpr std::size_t InlineCapacity = 128 / APMATH_LIMB_BITS;
+
+    LimbStorage() noexcept
+        : LimbStorage(std::pmr::get_default_resource())
+    {}
+
+    explicit LimbStorage(std::pmr::memory_resource* resource) noexcept
+        : mSize(0),
+          mCapacity(InlineCapacity),
+          mResource(resource),
+          mBuffer()
+    {}
+
+    LimbStorage(const LimbStorage& other)
+        : LimbStorage(other, other.mResource)
+    {}
+
+    LimbStorage(const LimbStorage& other, std::pmr::memory_resource* resource)
+        : LimbStorage(resource)
+    {
+        if (canShare(other)) {
+            share(other);
+        }
+        else {
+            assign(other.data(), other.mSize);
+        }
+    }
+
+    // Both inline limbs and the heap pointer are relocated by copying the buffer
+    LimbStorage(LimbStorage&& other) noexcept
+        : mSize(other.mSize),
+          mCapacity(other.mCapacity),
+          mResource(other.mResource),
+          mBuffer(other.mBuffer)
+    {
+        other.mSize = 0;
+        other.mCapacity = InlineCapacity;
+    }
+
+    // A buffer owned by this storage alone which fits the limbs is reused, so outputs assigned
+    // in a loop keep their limbs and don't copy them out of a shared buffer on the next write
+    LimbStorage& operator=(const LimbStorage& other) {
+        if (this != &other) {
+            if (canShare(other) && !ownsRoomFor(other.mSize)) {
+                release();
+                share(other);
+            }
+            else {
+                assign(other.data(), other.mSize);
+            }
+        }
+        return *this;
+    }
+
+    // The buffer is stolen only if it can be released by this storage's resource
+    LimbStorage& operator=(LimbStorage&& other) {
+        if (*mResource == *other.mResource) {
+            LimbStorage moved(std::move(other));
+            swap(moved);
+        }
+        else {
+            assign(other.data(), other.mSize);
+        }
+        return *this;
+    }
+
+    ~LimbStorage() {
+        release();
+    }
+
+    std::size_t size() const { return mSize; }
+    bool empty() const { return mSize == 0; }
+    std::size_t capacity() const { return mCapacity; }
+    std::pmr::memory_resource* resource() const { return mResource; }
+
+    Limb* data() {
+        unshare();
+        return isInline() ? mBuffer.inlineLimbs : mBuffer.heap;
+    }
+    const Limb* data() const { return isInline() ? mBuffer.inlineLimbs : mBuffer.heap; }
+
+    Limb& operator[](std::size_t i) { return data()[i]; }
+    const Limb& operator[](std::size_t i) const { return data()[i]; }
+
+    Limb& back() { return data()[mSize - 1]; }
+    const Limb& back() const { return data()[mSize - 1]; }
+
+    /**
+     * @brief resize - changes the number of limbs, new limbs are zero
+     */
+    void resize(std::size_t size) {
+        if (size > mCapacity) {
+            grow(std::max(size, 2 * mCapacity));
+        }
+        if (size > mSize) {
+            std::fill(data() + mSize, data() + size, Limb(0));
+        }
+        mSize = size;
+    }
+
+    /**
+     * @brief reserve - makes room for at least capacity limbs without changing the size
+     */
+    void reserve(std::size_t capacity) {
+        if (capacity > mCapacity) {
+            grow(capacity);
+        }
+    }
+
+    void push_back(Limb limb) {
+        if (mSize == mCapacity) {
+            grow(2 * mCapacity);
+        }
+        data()[mSize++] = limb;
+    }
+
+    void pop_back() { --mSize; }
+
+    void clear() { mSize = 0; }
+
+    /**
+     * @brief assign - replaces the contents with a copy of n limbs, limbs must not alias the storage
+     */
+    void assign(const Limb* limbs, std::size_t n) {
+        // Limbs of a shared buffer would be overwritten anyway, so they aren't copied out of it
+        if (isShared()) {
+            release();
+            mCapacity = InlineCapacity;
+        }
+        if (n > mCapacity) {
+            mSize = 0;
+            grow(n);
+        }
+        if (n > 0) {
+            std::memcpy(data(), limbs, n * sizeof(Limb));
+        }
+        mSize = n;
+    }
+
+    void swap(LimbStorage& other) noexcept {
+        std::swap(mSize, other.mSize);
+        std::swap(mCapacity, other.mCapacity);
+        std::swap(mResource, other.mResource);
+        std::swap(mBuffer, other.mBuffer);
+    }
+
+    friend bool operator==(const LimbStorage& lhs, const LimbStorage& rhs) {
+        return lhs.mSize == rhs.mSize && std::equal(lhs.data(), lhs.data() + lhs.mSize, rhs.data());
+    }
+    friend bool operator!=(const LimbStorage& lhs, const LimbStorage& rhs) { return !(lhs == rhs); }
+
+    /**
+     * @brief isShared - true if the limbs are in a buffer owned by other copies too
+     */
+    bool isShared() const {
+        return SharedLimbs && !isInline() && header()->owners.load(std::memory_order_acquire) != 1;
+    }
+
+private:
+    // Owner count in front of the limbs of an allocated buffer
+    struct Header {
+        explicit Header(std::size_t count)
+            : owners(count)
+        {}
+
+        std::atomic<std::size_t> owners;
+    };
+
+    union Buffer {
+        Limb inlineLimbs[InlineCapacity];
+        Limb* heap;
+    };
+
+    std::size_t mSize;
+    std::size_t mCapacity;
+    std::pmr::memory_resource* mResource;
+    Buffer mBuffer;
+
+    bool isInline() const { return mCapacity == InlineCapacity; }
+
+    Header* header() const { return reinterpret_cast<Header*>(mBuffer.heap) - 1; }
+
+    static std::size_t allocationSize(std::size_t capacity) { return sizeof(Header) + capacity * sizeof(Limb); }
+
+    // Short arrays are copied inline, the buffer is shared only if this storage's resource can release it
+    bool canShare(const LimbStorage& other) const {
+        return SharedLimbs && other.mSize > InlineCapacity && *mResource == *other.mResource;
+    }
+
+    bool ownsRoomFor(std::size_t size) const {
+        return !isInline() && mCapacity >= size && !isShared();
+    }
+
+    // Becomes one more owner of the buffer of other, the current buffer must be released
+    void share(const LimbStorage& other) {
+        other.header()->owners.fetch_add(1, std::memory_order_relaxed);
+        mSize = other.mSize;
+        mCapacity = other.mCapacity;
+        mBuffer = other.mBuffer;
+    }
+
+    void unshare() {
+        if (isShared()) {
+            copyShared();
+        }
+    }
+
+    // Kept out of line, so the check on every write stays small
+    __attribute__((noinline)) void copyShared() {
+        recordCopyOnWrite();
+        grow(mCapacity);
+    }
+
+    // Moves the limbs to a new buffer of the given capacity owned by this storage alone, capacity > InlineCapacity
+    void grow(std::size_t capacity) {
+        recordAllocation(allocationSize(capacity), mSize > 0 && capacity > mCapacity);
+        Header* header = new (mResource->allocate(allocationSize(capacity), alignof(Header))) Header(1);
+        Limb* heap = reinterpret_cast<Limb*>(header + 1);
+        if (mSize > 0) {
+            std::memcpy(heap, isInline() ? mBuffer.inlineLimbs : mBuffer.heap, mSize * sizeof(Limb));
+        }
+        release();
+        mBuffer.heap = heap;
+        mCapacity = capacity;
+    }
+
+    // The last owner frees the buffer, a sole owner doesn't need the atomic decrement
+    void release() {
+        if (!isInline()) {
+            Header* header = this->header();
+            if (!SharedLimbs || header->owners.load(std::memory_order_acquire) == 1 ||
+                header->owners.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                header->~Header();
+                mResource->deallocate(header, allocationSize(mCapacity), alignof(Header));
+            }
+        }
+    }
+};
+
+} // namespace detail
+} // namespace apmath
@@ -0,0 +1,318 @@
+#include "ModContext.hpp"
+#include "Division.hpp"
+#include "LimbAccess.hpp"
+#include "LimbKernels.hpp"
+#include "Multiplication.hpp"
+#include "NumberTheory.hpp"
+#include "Tuning.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+using apmath::BigInteger;
+using apmath::Limb;
+using namespace apmath::detail;
+
+// -m^-1 mod B for odd m by Newton iteration x' = x * (2 - m * x),
+// m is its own inverse modulo 8 and every step doubles the correct low bits
+Limb negatedInverse(Limb m) {
+    Limb x = m;
+    for (unsigned bits = 3; bits < LimbBits; bits *= 2) {
+        x *= 2 - m * x;
+    }
+    return 0 - x;
+}
+
+// Sliding windows of this many exponent bits multiply by one of 2^(bits-1) odd powers of the base.
+// Longer windows save multiplications on long exponents and cost more to precompute on short ones.
+unsigned windowBits(std::size_t exponentBits) {
+    if (exponentBits > 671) {
+        return 6;
+    }
+    if (exponentBits > 239) {
+        return 5;
+    }
+    if (exponentBits > 79) {
+        return 4;
+    }
+    if (exponentBits > 23) {
+        return 3;
+    }
+    return exponentBits > 1 ? 2 : 1;
+}
+
+// r = a^2 with 2n limbs: products a[i] * a[j] for i < j are computed once and doubled, then squares are added.
+// About half the multiplications of the schoolbook product.
+void squareBasecase(Limb* r, const Limb* a, std::size_t n) {
+    std::fill(r, r + 2 * n, Limb(0));
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+        r[i + n] = addMultiplyByLimb(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+    }
+    shiftLeftLimbs(r, r, 2 * n, 1);
+    Limb carry = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        DoubleLimb square = static_cast<DoubleLimb>(a[i]) * a[i];
+        DoubleLimb low = static_cast<DoubleLimb>(r[2 * i]) + static_cast<Limb>(square) + carry;
+        DoubleLimb high = static_cast<DoubleLimb>(r[2 * i + 1]) + static_cast<Limb>(square >> LimbBits) +
+                          static_cast<Limb>(low >> LimbBits);
+        r[2 * i] = static_cast<Limb>(low);
+        r[2 * i + 1] = static_cast<Limb>(high);
+        carry = static_cast<Limb>(high >> LimbBits);
+    }
+}
+
+bool exponentBit(const LimbStorage& exponent, std::size_t i) {
+    return (exponent[i / LimbBits] >> (i % LimbBits) & 1) != 0;
+}
+
+BigInteger fromLimbs(const Limb* limbs, std::size_t n) {
+    BigInteger result;
+    LimbAccess::limbs(result).assign(limbs, n);
+    LimbAccess::setNegative(result, false);
+    return result;
+}
+}
+
+namespace apmath {
+
+ModContext::ModContext(const BigInteger& modulus)
+    : mModulus(modulus),
+      mMontgomery(false),
+      mMontgomeryInverse(0)
+{
+    if (modulus <= 0) {
+        throw std::domain_error("ModContext modulus must be positive");
+    }
+    const LimbStorage& limbs = LimbAccess::limbs(modulus);
+    mLimbs.assign(limbs.data(), limbs.data() + limbs.size());
+    std::size_t n = mLimbs.size();
+    if (n > 1) {
+        mBarrett = std::make_shared<const Reciprocal>(mLimbs.data(), n);
+    }
+
+    mMontgomery = (mLimbs[0] & 1) != 0;
+    mOne.resize(n);
+    if (mMontgomery) {
+        mMontgomeryInverse = negatedInverse(mLimbs[0]);
+        std::vector<Limb> power(2 * n + 1);
+        power[2 * n] = 1;
+        mRSquared.resize(n);
+        remainder(mRSquared.data(), power.data(), power.size());
+        power[2 * n] = 0;
+        power[n] = 1;
+        remainder(mOne.data(), power.data(), n + 1);
+    }
+    else {
+        remainder(mOne.data(), std::vector<Limb>(1, 1).data(), 1);
+    }
+}
+
+BigInteger ModContext::reduce(const BigInteger& a) const {
+    std::vector<Limb> result = reduced(a);
+    return fromLimbs(result.data(), result.size());
+}
+
+// A single product reduced by the Barrett reciprocal costs less than conversions to Montgomery form and back
+BigInteger ModContext::mulmod(const BigInteger& a, const BigInteger& b) const {
+    const LimbStorage& al = LimbAccess::limbs(a);
+    const LimbStorage& bl = LimbAccess::limbs(b);
+    if (al.size() > mLimbs.size() || bl.size() > mLimbs.size()) {
+        return mulmod(reduce(a), reduce(b));
+    }
+    if (al.empty() || bl.empty()) {
+        return BigInteger();
+    }
+    std::vector<Limb> product(std::max(al.size() + bl.size(), mLimbs.size()));
+    multiplyLimbs(product.data(), al.data(), al.size(), bl.data(), bl.size());
+    remainder(product.data(), product.data(), product.size());
+    bool negative = LimbAccess::isNegative(a) != LimbAccess::isNegative(b);
+    if (negative && significantLength(product.data(), mLimbs.size()) > 0) {
+        subtractLimbs(product.data(), mLimbs.data(), mLimbs.size(), product.data(), mLimbs.size());
+    }
+    return fromLimbs(product.data(), mLimbs.size());
+}
+
+BigInteger ModContext::powmod(const BigInteger& base, const BigInteger& exponent) const {
+    return fromResidue(pow(toResidue(base), exponent));
+}
+
+// extendedGcd gives a * x + m * y = gcd(a, m), for gcd 1 the coefficient x reduced modulo m is the inverse
+BigInteger ModContext::invmod(const BigInteger& a) const {
+    ExtendedGcd bezout = extendedGcd(reduce(a), mModulus);
+    if (bezout.gcd != 1) {
+        throw std::domain_error("ModContext value is not invertible");
+    }
+    return reduce(bezout.x);
+}
+
+ModContext::Residue ModContext::toResidue(const BigInteger& a) const {
+    std::vector<Limb> result = reduced(a);
+    if (mMontgomery) {
+        std::vector<Limb> scratch(scratchSize());
+        multiplyInto(result.data(), result.data(), mRSquared.data(), scratch.data());
+    }
+    return Residue(std::move(result));
+}
+
+BigInteger ModContext::fromResidue(const Residue& a) const {
+    std::size_t n = mLimbs.size();
+    if (!mMontgomery) {
+        return fromLimbs(a.mLimbs.data(), n);
+    }
+    std::vector<Limb> t(2 * n);
+    std::copy(a.mLimbs.begin(), a.mLimbs.end(), t.begin());
+    std::vector<Limb> result(n);
+    montgomeryReduce(result.data(), t.data());
+    return fromLimbs(result.data(), n);
+}
+
+ModContext::Residue ModContext::add(const Residue& a, const Residue& b) const {
+    std::size_t n = mLimbs.size();
+    std::vector<Limb> result(n);
+    Limb carry = addLimbs(result.data(), a.mLimbs.data(), n, b.mLimbs.data(), n);
+    if (carry != 0 || compareLimbs(result.data(), significantLength(result.data(), n), mLimbs.data(), n) >= 0) {
+        subtractLimbs(result.data(), result.data(), n, mLimbs.data(), n);
+    }
+    return Residue(std::move(result));
+}
+
+ModContext::Residue ModContext::subtract(const Residue& a, const Residue& b) const {
+    std::size_t n = mLimbs.size();
+    std::vector<Limb> result(n);
+    if (subtractLimbs(result.data(), a.mLimbs.data(), n, b.mLimbs.data(), n) != 0) {
+        addLimbs(result.data(), result.data(), n, mLimbs.data(), n);
+    }
+    return Residue(std::move(result));
+}
+
+ModContext::Residue ModContext::multiply(const Residue& a, const Residue& b) const {
+    std::vector<Limb> result(mLimbs.size());
+    std::vector<Limb> scratch(scratchSize());
+    multiplyInto(result.data(), a.mLimbs.data(), b.mLimbs.data(), scratch.data());
+    return Residue(std::move(result));
+}
+
+ModContext::Residue ModContext::square(const Residue& a) const {
+    return multiply(a, a);
+}
+
+// Left-to-right sliding window: zero bits square the result, a window of up to k bits ending
+// with a one squares it once per bit and multiplies by the precomputed odd power of the window.
+ModContext::Residue ModContext::pow(const Residue& a, const BigInteger& exponent) const {
+    if (LimbAccess::isNegative(exponent)) {
+        return pow(toResidue(invmod(fromResidue(a))), -exponent);
+    }
+    const LimbStorage& e = LimbAccess::limbs(exponent);
+    if (e.empty()) {
+        return Residue(mOne);
+    }
+    std::size_t n = mLimbs.size();
+    std::size_t bits = e.size() * LimbBits - countLeadingZeroBits(e.back());
+    unsigned k = windowBits(bits);
+
+    std::vector<Limb> scratch(scratchSize());
+    // odd[i] = a^(2i + 1)
+    std::vector<Limb> odd(n << (k - 1));
+    std::copy(a.mLimbs.begin(), a.mLimbs.end(), odd.begin());
+    if (k > 1) {
+        std::vector<Limb> squared(n);
+        multiplyInto(squared.data(), a.mLimbs.data(), a.mLimbs.data(), scratch.data());
+        for (std::size_t i = 1; i < (std::size_t(1) << (k - 1)); ++i) {
+            multiplyInto(&odd[i * n], &odd[(i - 1) * n], squared.data(), scratch.data());
+        }
+    }
+
+    std::vector<Limb> result(mOne);
+    bool started = false;
+    std::size_t i = bits;
+    while (i > 0) {
+        --i;
+        if (!exponentBit(e, i)) {
+            multiplyInto(result.data(), result.data(), result.data(), scratch.data());
+            continue;
+        }
+        std::size_t low = i + 1 >= k ? i + 1 - k : 0;
+        while (!exponentBit(e, low)) {
+            ++low;
+        }
+        std::size_t window = 0;
+        for (std::size_t j = i + 1; j-- > low; ) {
+            window = 2 * window + exponentBit(e, j);
+        }
+        const Limb* power = &odd[(window >> 1) * n];
+        if (started) {
+            for (std::size_t j = low; j <= i; ++j) {
+                multiplyInto(result.data(), result.data(), result.data(), scratch.data());
+            }
+            multiplyInto(result.data(), result.data(), power, scratch.data());
+        }
+        else {
+            std::copy(power, power + n, result.begin());
+            started = true;
+        }
+        i = low;
+    }
+    return Residue(std::move(result));
+}
+
+std::vector<Limb> ModContext::reduced(const BigInteger& a) const {
+    std::size_t n = mLimbs.size();
+    const LimbStorage& limbs = LimbAccess::limbs(a);
+    std::vector<Limb> result(std::max(n, limbs.size()));
+    std::copy(limbs.data(), limbs.data() + limbs.size(), result.begin());
+    remainder(result.data(), result.data(), result.size());
+    result.resize(n);
+    if (LimbAccess::isNegative(a) && significantLength(result.data(), n) > 0) {
+        subtractLimbs(result.data(), mLimbs.data(), n, result.data(), n);
+    }
+    return result;
+}
+
+void ModContext::remainder(Limb* r, const Limb* a, std::size_t an) const {
+    std::size_t n = mLimbs.size();
+    an = significantLength(a, an);
+    if (an < n) {
+        std::copy(a, a + an, r);
+        std::fill(r + an, r + n, Limb(0));
+    }
+    else if (n == 1) {
+        r[0] = LimbDivisor(mLimbs[0]).remainder(a, an);
+    }
+    else {
+        std::vector<Limb> quotient(an - n + 1);
+        mBarrett->divide(quotient.data(), r, a, an);
+    }
+}
+
+void ModContext::multiplyInto(Limb* r, const Limb* a, const Limb* b, Limb* scratch) const {
+    std::size_t n = mLimbs.size();
+    if (a == b && n < multiplicationThresholds().karatsuba) {
+        squareBasecase(scratch, a, n);
+    }
+    else {
+        multiplyLimbs(scratch, a, n, b, n);
+    }
+    if (mMontgomery) {
+        montgomeryReduce(r, scratch);
+    }
+    else {
+        remainder(r, scratch, 2 * n);
+    }
+}
+
+// Row i adds the multiple of m which zeroes limb i, so after n rows t is divisible by R.
+// The zeroed limb keeps the row's carry, which belongs n limbs higher, and all carries are added at once.
+// t < m * R gives a result below 2m, one subtraction brings it into [0, m).
+void ModContext::montgomeryReduce(Limb* r, Limb* t) const {
+    std::size_t n = mLimbs.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        t[i] = addMultiplyByLimb(t + i, mLimbs.data(), n, t[i] * mMontgomeryInverse);
+    }
+    Limb carry = addLimbs(r, t + n, n, t, n);
+    if (carry != 0 || compareLimbs(r, significantLength(r, n), mLimbs.data(), n) >= 0) {
+        subtractLimbs(r, r, n, mLimbs.data(), n);
+    }
+}
+
+} // namespace apmath
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "BigInteger.hpp"
+
+namespace apmath {
+
+namespace detail {
+class Reciprocal;
+} // namespace detail
+
+/**
+ * @brief ModContext - arithmetic modulo a fixed positive modulus.
+ *
+ * Constants of the modulus are computed once by the constructor: the Barrett reciprocal
+ * reduces arbitrary numbers and products, and for odd moduli -m^-1 mod B and R^2 mod m
+ * of Montgomery multiplication, where R = B^n for the n limbs of the modulus.
+ * Chained operations should stay in Residue form, which for odd moduli is the Montgomery form:
+ * multiplication reduces with n multiply-add rows and no division at all.
+ * A context is immutable, so threads may share it.
+ */
+class ModContext {
+public:
+    /**
+     * @brief Residue - number modulo the context's modulus in the context's own form:
+     * a * R mod m for odd moduli, the plain remainder for even ones.
+     * Residues are only meaningful to the context which created them.
+     */
+    class Residue {
+    public:
+        friend bool operator==(const Residue& lhs, const Residue& rhs) { return lhs.mLimbs == rhs.mLimbs; }
+        friend bool operator!=(const Residue& lhs, const Residue& rhs) { return !(lhs == rhs); }
+
+    private:
+        friend class ModContext;
+
+        explicit Residue(std::vector<Limb> limbs)
+            : mLimbs(std::move(limbs))
+        {}
+
+        /**
+         * @brief mLimbs - value less than the modulus in exactly as many limbs as the modulus has
+         */
+        std::vector<Limb> mLimbs;
+    };
+
+    /**
+     * @brief ModContext constructor
+     * @throw std::domain_error if the modulus isn't positive
+     */
+    explicit ModContext(const BigInteger& modulus);
+
+    const BigInteger& modulus() const { return mModulus; }
+    /**
+     * @brief isMontgomery - true when residues are in Montgomery form, that is for odd moduli
+     */
+    bool isMontgomery() const { return mMontgomery; }
+
+    /**
+     * @brief reduce - a mod m in [0, m), also for negative a
+     */
+    BigInteger reduce(const BigInteger& a) const;
+    /**
+     * @brief mulmod - a * b mod m
+     */
+    BigInteger mulmod(const BigInteger& a, const BigInteger& b) const;
+    /**
+     * @brief powmod - base^exponent mod m by sliding-window exponentiation in residue form,
+     * a negative exponent raises the inverse of base
+     * @throw std::domain_error if the exponent is negative and base has no inverse
+     */
+    BigInteger powmod(const BigInteger& base, const BigInteger& exponent) const;
+    /**
+     * @brief invmod - x in [0, m) with a * x mod m = 1, by the extended Euclidean algorithm
+     * @throw std::domain_error if a and m aren't coprime
+     */
+    BigInteger invmod(const BigInteger& a) const;
+
+    /**
+     * @brief toResidue - converts a number of any size and sign into residue form
+     */
+    Residue toResidue(const BigInteger& a) const;
+    /**
+     * @brief fromResidue - the number in [0, m) the residue stands for
+     */
+    BigInteger fromResidue(const Residue& a) const;
+
+    Residue add(const Residue& a, const Residue& b) const;
+    Residue subtract(const Residue& a, const Residue& b) const;
+    Residue multiply(const Residue& a, const Residue& b) const;
+    Residue square(const Residue& a) const;
+    /**
+     * @brief pow - a^exponent, a negative exponent raises the inverse of a
+     * @throw std::domain_error if the exponent is negative and a has no inverse
+     */
+    Residue pow(const Residue& a, const BigInteger& exponent) const;
+
+private:
+    BigInteger mModulus;
+    /**
+     * @brief mLimbs - limbs of the modulus, n of them
+     */
+    std::vector<Limb> mLimbs;
+    bool mMontgomery;
+    /**
+     * @brief mBarrett - reciprocal floor((B^2n - 1) / m) of a modulus longer than one limb
+     */
+    std::shared_ptr<const detail::Reciprocal> mBarrett;
+    /**
+     * @brief mMontgomeryInverse - -m^-1 mod B, each reduction row makes one limb zero with it
+     */
+    Limb mMontgomeryInverse;
+    /**
+     * @brief mRSquared - R^2 mod m, Montgomery multiplication by it converts into Montgomery form
+     */
+    std::vector<Limb> mRSquared;
+    /**
+     * @brief mOne - residue of one
+     */
+    std::vector<Limb> mOne;
+
+    /**
+     * @brief scratchSize - limbs of room multiplyInto needs for its intermediate values
+     */
+    std::size_t scratchSize() const { return 2 * mLimbs.size(); }
+    /**
+     * @brief reduced - limbs of a mod m in [0, m), n of them
+     */
+    std::vector<Limb> reduced(const BigInteger& a) const;
+    /**
+     * @brief remainder - computes r = a mod m for any length of a, r has n limbs and may alias a
+     */
+    void remainder(Limb* r, const Limb* a, std::size_t an) const;
+    /**
+     * @brief multiplyInto - computes the residue product r = a * b, r may alias a or b
+     * @param scratch - room for scratchSize() limbs
+     */
+    void multiplyInto(Limb* r, const Limb* a, const Limb* b, Limb* scratch) const;
+    /**
+     * @brief montgomeryReduce - computes r = t / R mod m for t < m * R
+     * @param t - 2n limbs, destroyed
+     */
+    void montgomeryReduce(Limb* r, Limb* t) const;
+};
+
+} // namespace apmath
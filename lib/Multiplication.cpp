@@ -0,0 +1,281 @@
+#include "Multiplication.hpp"
+#include "LimbKernels.hpp"
+#include "NumberTheoreticTransform.hpp"
+#include "ThreadPool.hpp"
+#include "Tuning.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace {
+using apmath::Limb;
+using apmath::MultiplicationThresholds;
+using namespace apmath::detail;
+
+// Measured on x86-64 with 64-bit limbs, big-number-tune finds the values for other hosts
+constexpr MultiplicationThresholds DefaultThresholds = {32, 128, 8192};
+
+// The least thresholds which still let every algorithm split operands into smaller parts
+constexpr size_t MinKaratsubaThreshold = 4;
+constexpr size_t MinToom3Threshold = 8;
+constexpr size_t MinNttThreshold = 1;
+
+// Toom-3 computes its five products concurrently from this length of the shorter operand
+constexpr size_t ParallelToom3Threshold = 768;
+
+std::atomic<size_t> karatsubaThreshold(DefaultThresholds.karatsuba);
+std::atomic<size_t> toom3Threshold(DefaultThresholds.toom3);
+std::atomic<size_t> nttThreshold(DefaultThresholds.ntt);
+
+// Classical O(an * bn) multiplication, one row per limb of b.
+void multiplySchoolbook(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn) {
+    r[an] = multiplyByLimb(r, a, an, b[0], 0);
+    for (size_t j = 1; j < bn; ++j) {
+        r[an + j] = addMultiplyByLimb(r + j, a, an, b[j]);
+    }
+}
+
+// Adds a into r, propagating carry through the whole of r.
+void addInto(Limb* r, size_t rn, const Limb* a, size_t an) {
+    an = significantLength(a, an);
+    if (an > 0) {
+        addLimbs(r, r, rn, a, an);
+    }
+}
+
+void multiplyRecursive(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn,
+                       const MultiplicationThresholds& thresholds);
+
+// Multiplication of a long a by a short b: a is cut into bn-limb pieces,
+// so every partial product is balanced.
+void multiplyUnbalanced(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn,
+                        const MultiplicationThresholds& thresholds) {
+    std::fill(r, r + an + bn, Limb(0));
+    std::vector<Limb> partial(2 * bn);
+    for (size_t offset = 0; offset < an; offset += bn) {
+        size_t pieceLength = std::min(bn, an - offset);
+        multiplyRecursive(partial.data(), a + offset, pieceLength, b, bn, thresholds);
+        addInto(r + offset, an + bn - offset, partial.data(), pieceLength + bn);
+    }
+}
+
+// Karatsuba: a * b = z2 * B^2h + ((a0 + a1)(b0 + b1) - z0 - z2) * B^h + z0,
+// where z0 = a0 * b0 and z2 = a1 * b1.
+void multiplyKaratsuba(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn,
+                       const MultiplicationThresholds& thresholds) {
+    size_t half = (an + 1) / 2;
+    const Limb* a0 = a;
+    const Limb* a1 = a + half;
+    const Limb* b0 = b;
+    const Limb* b1 = b + half;
+    size_t a1n = an - half;
+    size_t b1n = bn - half;
+
+    multiplyRecursive(r, a0, half, b0, half, thresholds);
+    multiplyRecursive(r + 2 * half, a1, a1n, b1, b1n, thresholds);
+
+    std::vector<Limb> sums(2 * (half + 1));
+    Limb* aSum = sums.data();
+    Limb* bSum = aSum + half + 1;
+    aSum[half] = addLimbs(aSum, a0, half, a1, a1n);
+    bSum[half] = addLimbs(bSum, b0, half, b1, b1n);
+
+    std::vector<Limb> middle(2 * (half + 1));
+    multiplyRecursive(middle.data(), aSum, half + 1, bSum, half + 1, thresholds);
+    subtractLimbs(middle.data(), middle.data(), middle.size(), r, 2 * half);
+    subtractLimbs(middle.data(), middle.data(), middle.size(), r + 2 * half, a1n + b1n);
+
+    addInto(r + half, an + bn - half, middle.data(), middle.size());
+}
+
+// Signed intermediate value of Toom-3 evaluation and interpolation
+struct SignedLimbs {
+    std::vector<Limb> magnitude;
+    bool negative;
+};
+
+SignedLimbs makeSigned(const Limb* a, size_t n) {
+    n = significantLength(a, n);
+    return SignedLimbs{std::vector<Limb>(a, a + n), false};
+}
+
+std::vector<Limb> addMagnitudes(const std::vector<Limb>& a, const std::vector<Limb>& b) {
+    const std::vector<Limb>& longer = a.size() >= b.size() ? a : b;
+    const std::vector<Limb>& shorter = a.size() >= b.size() ? b : a;
+    std::vector<Limb> sum(longer.size() + 1);
+    sum[longer.size()] = addLimbs(sum.data(), longer.data(), longer.size(), shorter.data(), shorter.size());
+    sum.resize(significantLength(sum.data(), sum.size()));
+    return sum;
+}
+
+std::vector<Limb> subtractMagnitudes(const std::vector<Limb>& greater, const std::vector<Limb>& less) {
+    std::vector<Limb> difference(greater.size());
+    subtractLimbs(difference.data(), greater.data(), greater.size(), less.data(), less.size());
+    difference.resize(significantLength(difference.data(), difference.size()));
+    return difference;
+}
+
+// a + b, or a - b when subtract is set
+SignedLimbs addSigned(const SignedLimbs& a, const SignedLimbs& b, bool subtract) {
+    bool bNegative = b.negative != subtract;
+    SignedLimbs result;
+    if (a.negative == bNegative) {
+        result = SignedLimbs{addMagnitudes(a.magnitude, b.magnitude), a.negative};
+    }
+    else if (compareLimbs(a.magnitude.data(), a.magnitude.size(), b.magnitude.data(), b.magnitude.size()) >= 0) {
+        result = SignedLimbs{subtractMagnitudes(a.magnitude, b.magnitude), a.negative};
+    }
+    else {
+        result = SignedLimbs{subtractMagnitudes(b.magnitude, a.magnitude), bNegative};
+    }
+    result.negative = result.negative && !result.magnitude.empty();
+    return result;
+}
+
+SignedLimbs doubled(SignedLimbs a) {
+    Limb out = shiftLeftLimbs(a.magnitude.data(), a.magnitude.data(), a.magnitude.size(), 1);
+    if (out != 0) {
+        a.magnitude.push_back(out);
+    }
+    return a;
+}
+
+SignedLimbs halved(SignedLimbs a) {
+    shiftRightLimbs(a.magnitude.data(), a.magnitude.data(), a.magnitude.size(), 1);
+    a.magnitude.resize(significantLength(a.magnitude.data(), a.magnitude.size()));
+    return a;
+}
+
+SignedLimbs dividedBy3(SignedLimbs a) {
+    divideExactByLimb(a.magnitude.data(), a.magnitude.data(), a.magnitude.size(), 3);
+    a.magnitude.resize(significantLength(a.magnitude.data(), a.magnitude.size()));
+    return a;
+}
+
+SignedLimbs multiplySigned(const SignedLimbs& a, const SignedLimbs& b, const MultiplicationThresholds& thresholds) {
+    if (a.magnitude.empty() || b.magnitude.empty()) {
+        return SignedLimbs{std::vector<Limb>(), false};
+    }
+    std::vector<Limb> product(a.magnitude.size() + b.magnitude.size());
+    multiplyRecursive(product.data(), a.magnitude.data(), a.magnitude.size(),
+                      b.magnitude.data(), b.magnitude.size(), thresholds);
+    product.resize(significantLength(product.data(), product.size()));
+    return SignedLimbs{product, a.negative != b.negative};
+}
+
+// Values of x0 + x1 * t + x2 * t^2 at the points 1, -1 and -2
+struct Toom3Evaluation {
+    SignedLimbs atOne;
+    SignedLimbs atMinusOne;
+    SignedLimbs atMinusTwo;
+};
+
+Toom3Evaluation evaluateToom3(const SignedLimbs& x0, const SignedLimbs& x1, const SignedLimbs& x2) {
+    SignedLimbs evenSum = addSigned(x0, x2, false);
+    Toom3Evaluation evaluation;
+    evaluation.atOne = addSigned(evenSum, x1, false);
+    evaluation.atMinusOne = addSigned(evenSum, x1, true);
+    evaluation.atMinusTwo = addSigned(doubled(addSigned(evaluation.atMinusOne, x2, false)), x0, true);
+    return evaluation;
+}
+
+// Toom-3 with the evaluation points 0, 1, -1, -2 and infinity and Bodrato's interpolation sequence:
+// five products of one third of the size instead of nine.
+void multiplyToom3(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn,
+                   const MultiplicationThresholds& thresholds) {
+    size_t third = (an + 2) / 3;
+    SignedLimbs a0 = makeSigned(a, third);
+    SignedLimbs a1 = makeSigned(a + third, third);
+    SignedLimbs a2 = makeSigned(a + 2 * third, an - 2 * third);
+    SignedLimbs b0 = makeSigned(b, third);
+    SignedLimbs b1 = makeSigned(b + third, third);
+    SignedLimbs b2 = makeSigned(b + 2 * third, bn - 2 * third);
+
+    Toom3Evaluation aValues = evaluateToom3(a0, a1, a2);
+    Toom3Evaluation bValues = evaluateToom3(b0, b1, b2);
+
+    // r(0) and r(infinity) are written straight into their disjoint places of the result,
+    // so all five products are independent
+    std::fill(r, r + an + bn, Limb(0));
+    SignedLimbs atOne;
+    SignedLimbs atMinusOne;
+    SignedLimbs atMinusTwo;
+    parallelInvoke(bn >= ParallelToom3Threshold,
+                   [&]() { multiplyRecursive(r, a, third, b, third, thresholds); },
+                   [&]() {
+                       multiplyRecursive(r + 4 * third, a + 2 * third, an - 2 * third,
+                                         b + 2 * third, bn - 2 * third, thresholds);
+                   },
+                   [&]() { atOne = multiplySigned(aValues.atOne, bValues.atOne, thresholds); },
+                   [&]() { atMinusOne = multiplySigned(aValues.atMinusOne, bValues.atMinusOne, thresholds); },
+                   [&]() { atMinusTwo = multiplySigned(aValues.atMinusTwo, bValues.atMinusTwo, thresholds); });
+    SignedLimbs atZero = makeSigned(r, 2 * third);
+    SignedLimbs atInfinity = makeSigned(r + 4 * third, an + bn - 4 * third);
+
+    SignedLimbs r3 = dividedBy3(addSigned(atMinusTwo, atOne, true));
+    SignedLimbs r1 = halved(addSigned(atOne, atMinusOne, true));
+    SignedLimbs r2 = addSigned(atMinusOne, atZero, true);
+    r3 = addSigned(halved(addSigned(r2, r3, true)), doubled(atInfinity), false);
+    r2 = addSigned(addSigned(r2, r1, false), atInfinity, true);
+    r1 = addSigned(r1, r3, true);
+
+    addInto(r + third, an + bn - third, r1.magnitude.data(), r1.magnitude.size());
+    addInto(r + 2 * third, an + bn - 2 * third, r2.magnitude.data(), r2.magnitude.size());
+    addInto(r + 3 * third, an + bn - 3 * third, r3.magnitude.data(), r3.magnitude.size());
+}
+
+void multiplyRecursive(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn,
+                       const MultiplicationThresholds& thresholds) {
+    if (an < bn) {
+        std::swap(a, b);
+        std::swap(an, bn);
+    }
+    if (bn < thresholds.karatsuba) {
+        multiplySchoolbook(r, a, an, b, bn);
+    }
+    else if (bn >= thresholds.ntt) {
+        multiplyNtt(r, a, an, b, bn);
+    }
+    else if (2 * bn <= an + 1) {
+        multiplyUnbalanced(r, a, an, b, bn, thresholds);
+    }
+    else if (bn >= thresholds.toom3 && bn > 2 * ((an + 2) / 3)) {
+        multiplyToom3(r, a, an, b, bn, thresholds);
+    }
+    else {
+        multiplyKaratsuba(r, a, an, b, bn, thresholds);
+    }
+}
+}
+
+namespace apmath {
+
+MultiplicationThresholds defaultMultiplicationThresholds() {
+    return DefaultThresholds;
+}
+
+MultiplicationThresholds multiplicationThresholds() {
+    return MultiplicationThresholds{karatsubaThreshold.load(std::memory_order_relaxed),
+                                    toom3Threshold.load(std::memory_order_relaxed),
+                                    nttThreshold.load(std::memory_order_relaxed)};
+}
+
+void setMultiplicationThresholds(const MultiplicationThresholds& thresholds) {
+    karatsubaThreshold.store(std::max(thresholds.karatsuba, MinKaratsubaThreshold), std::memory_order_relaxed);
+    toom3Threshold.store(std::max(thresholds.toom3, MinToom3Threshold), std::memory_order_relaxed);
+    nttThreshold.store(std::max(thresholds.ntt, MinNttThreshold), std::memory_order_relaxed);
+}
+
+namespace detail {
+
+void multiplyLimbs(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn) {
+    if (an == 0 || bn == 0) {
+        std::fill(r, r + an + bn, Limb(0));
+        return;
+    }
+    multiplyRecursive(r, a, an, b, bn, multiplicationThresholds());
+}
+
+} // namespace detail
+} // namespace apmath
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+#include "BigInteger.hpp"
+
+namespace apmath {
+namespace detail {
+
+/**
+ * @brief multiplyLimbs - computes r = a * b
+ * @param r - result with room for an + bn limbs, must not alias a or b
+ * @param a, an - first operand, may have high zero limbs
+ * @param b, bn - second operand, may have high zero limbs
+ */
+void multiplyLimbs(Limb* r, const Limb* a, std::size_t an, const Limb* b, std::size_t bn);
+
+} // namespace detail
+} // namespace apmath
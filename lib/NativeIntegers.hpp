@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+namespace apmath {
+namespace detail {
+
+/**
+ * @brief EnableIfIntegral - enables overloads taking native integers
+ */
+template <typename T>
+using EnableIfIntegral = typename std::enable_if<std::is_integral<T>::value, int>::type;
+/**
+ * @brief NativeType - widest native integer with the signedness of T
+ */
+template <typename T>
+using NativeType = typename std::conditional<std::is_signed<T>::value, std::int64_t, std::uint64_t>::type;
+
+inline bool isNegative(std::int64_t value) { return value < 0; }
+inline bool isNegative(std::uint64_t) { return false; }
+
+/**
+ * @brief magnitudeOf - absolute value, also of the least 64-bit integer
+ */
+inline std::uint64_t magnitudeOf(std::int64_t value) {
+    return value < 0 ? 0 - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+}
+inline std::uint64_t magnitudeOf(std::uint64_t value) { return value; }
+
+} // namespace detail
+} // namespace apmath
@@ -0,0 +1,295 @@
+#include "NumberTheoreticTransform.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace {
+using apmath::Limb;
+using std::uint64_t;
+__extension__ typedef unsigned __int128 Uint128;
+
+// Arithmetic modulo a prime p < 2^62 in Montgomery form with R = 2^64.
+// Transformed values stay in the normal form, only the constants they are multiplied by
+// (roots of unity, CRT coefficients) are kept in the Montgomery form.
+class Modulus {
+public:
+    Modulus(uint64_t prime, uint64_t generator)
+        : mPrime(prime),
+          mGenerator(generator),
+          mNegInverse(negInverse(prime)),
+          mR2(static_cast<uint64_t>((static_cast<Uint128>(rModP(prime)) << 64) % prime))
+    {}
+
+    uint64_t prime() const { return mPrime; }
+    uint64_t generator() const { return mGenerator; }
+
+    uint64_t add(uint64_t a, uint64_t b) const {
+        uint64_t sum = a + b;
+        return sum >= mPrime ? sum - mPrime : sum;
+    }
+    uint64_t sub(uint64_t a, uint64_t b) const {
+        return a >= b ? a - b : a + mPrime - b;
+    }
+    // a * b / R mod p
+    uint64_t mul(uint64_t a, uint64_t b) const {
+        Uint128 product = static_cast<Uint128>(a) * b;
+        uint64_t m = static_cast<uint64_t>(product) * mNegInverse;
+        uint64_t t = static_cast<uint64_t>((product + static_cast<Uint128>(m) * mPrime) >> 64);
+        return t >= mPrime ? t - mPrime : t;
+    }
+    uint64_t toMontgomery(uint64_t a) const {
+        return mul(a, mR2);
+    }
+    uint64_t reduce(uint64_t a) const {
+        return a % mPrime;
+    }
+    // Plain exponentiation, used only while preparing constants
+    uint64_t power(uint64_t base, uint64_t exponent) const {
+        uint64_t result = toMontgomery(1);
+        uint64_t factor = toMontgomery(base);
+        for ( ; exponent > 0; exponent >>= 1) {
+            if (exponent & 1) {
+                result = mul(result, factor);
+            }
+            factor = mul(factor, factor);
+        }
+        return mul(result, 1);
+    }
+    uint64_t inverse(uint64_t a) const {
+        return power(a, mPrime - 2);
+    }
+
+private:
+    uint64_t mPrime;
+    uint64_t mGenerator;
+    uint64_t mNegInverse;
+    uint64_t mR2;
+
+    static uint64_t negInverse(uint64_t prime) {
+        uint64_t inverse = prime;
+        for (int i = 0; i < 5; ++i) {
+            inverse *= 2 - prime * inverse;
+        }
+        return 0 - inverse;
+    }
+    static uint64_t rModP(uint64_t prime) {
+        return static_cast<uint64_t>((static_cast<Uint128>(1) << 64) % prime);
+    }
+};
+
+// Primes c * 2^k + 1 with k >= 55, their product exceeds 2^183, so convolutions
+// of 64-bit words up to 2^55 words long are restored exactly.
+const Modulus Moduli[3] = {
+    Modulus(4179340454199820289ULL, 3),
+    Modulus(2485986994308513793ULL, 5),
+    Modulus(1945555039024054273ULL, 5)
+};
+
+// roots[h + j] = w_2h^j in the Montgomery form, where w_2h is a primitive (2h)-th root of unity,
+// so every butterfly level reads its twiddles sequentially.
+std::vector<uint64_t> rootTable(const Modulus& modulus, size_t size, bool inverse) {
+    std::vector<uint64_t> roots(std::max<size_t>(size, 2));
+    for (size_t half = 1; half < size; half <<= 1) {
+        uint64_t root = modulus.power(modulus.generator(), (modulus.prime() - 1) / (2 * half));
+        if (inverse) {
+            root = modulus.inverse(root);
+        }
+        uint64_t step = modulus.toMontgomery(root);
+        roots[half] = modulus.toMontgomery(1);
+        for (size_t j = 1; j < half; ++j) {
+            roots[half + j] = modulus.mul(roots[half + j - 1], step);
+        }
+    }
+    return roots;
+}
+
+// Transforms of at least this many words split their butterflies among threads,
+// the transforms of the three primes always run concurrently
+constexpr size_t ParallelTransformWords = size_t(1) << 15;
+constexpr size_t ParallelButterflies = size_t(1) << 12;
+
+void forwardButterflies(const Modulus& modulus, uint64_t* lo, uint64_t* hi, const uint64_t* twiddles,
+                        size_t begin, size_t end) {
+    for (size_t j = begin; j < end; ++j) {
+        uint64_t u = lo[j];
+        uint64_t v = hi[j];
+        lo[j] = modulus.add(u, v);
+        hi[j] = modulus.mul(modulus.sub(u, v), twiddles[j]);
+    }
+}
+
+void inverseButterflies(const Modulus& modulus, uint64_t* lo, uint64_t* hi, const uint64_t* twiddles,
+                        size_t begin, size_t end) {
+    for (size_t j = begin; j < end; ++j) {
+        uint64_t u = lo[j];
+        uint64_t v = modulus.mul(hi[j], twiddles[j]);
+        lo[j] = modulus.add(u, v);
+        hi[j] = modulus.sub(u, v);
+    }
+}
+
+// Gentleman-Sande decimation in frequency: natural order in, bit-reversed order out.
+// Long transforms do the top level and then both halves independently.
+void forwardTransform(const Modulus& modulus, uint64_t* x, size_t size, const std::vector<uint64_t>& roots) {
+    if (size >= ParallelTransformWords) {
+        size_t half = size / 2;
+        apmath::detail::parallelFor(0, half, ParallelButterflies, [&](size_t begin, size_t end) {
+            forwardButterflies(modulus, x, x + half, roots.data() + half, begin, end);
+        });
+        apmath::detail::parallelInvoke(true,
+                                       [&]() { forwardTransform(modulus, x, half, roots); },
+                                       [&]() { forwardTransform(modulus, x + half, half, roots); });
+        return;
+    }
+    for (size_t length = size; length >= 2; length >>= 1) {
+        size_t half = length / 2;
+        const uint64_t* twiddles = roots.data() + half;
+        for (size_t start = 0; start < size; start += length) {
+            forwardButterflies(modulus, x + start, x + start + half, twiddles, 0, half);
+        }
+    }
+}
+
+// Cooley-Tukey decimation in time: bit-reversed order in, natural order out.
+// Long transforms do both halves independently and then the top level.
+void inverseTransform(const Modulus& modulus, uint64_t* x, size_t size, const std::vector<uint64_t>& roots) {
+    if (size >= ParallelTransformWords) {
+        size_t half = size / 2;
+        apmath::detail::parallelInvoke(true,
+                                       [&]() { inverseTransform(modulus, x, half, roots); },
+                                       [&]() { inverseTransform(modulus, x + half, half, roots); });
+        apmath::detail::parallelFor(0, half, ParallelButterflies, [&](size_t begin, size_t end) {
+            inverseButterflies(modulus, x, x + half, roots.data() + half, begin, end);
+        });
+        return;
+    }
+    for (size_t length = 2; length <= size; length <<= 1) {
+        size_t half = length / 2;
+        const uint64_t* twiddles = roots.data() + half;
+        for (size_t start = 0; start < size; start += length) {
+            inverseButterflies(modulus, x + start, x + start + half, twiddles, 0, half);
+        }
+    }
+}
+
+// Limbs are packed into 64-bit words, so both limb widths share the same transform.
+std::vector<uint64_t> packWords(const Limb* a, size_t n) {
+#if APMATH_LIMB_BITS == 64
+    return std::vector<uint64_t>(a, a + n);
+#else
+    std::vector<uint64_t> words((n + 1) / 2);
+    for (size_t i = 0; i < n; ++i) {
+        words[i / 2] |= static_cast<uint64_t>(a[i]) << (32 * (i % 2));
+    }
+    return words;
+#endif
+}
+
+// Cyclic convolution of a and b modulo one prime, the result replaces a
+void convolve(const Modulus& modulus, const std::vector<uint64_t>& a, const std::vector<uint64_t>& b,
+              bool square, std::vector<uint64_t>& result, size_t size) {
+    std::vector<uint64_t> roots = rootTable(modulus, size, false);
+    auto transform = [&](const std::vector<uint64_t>& words, std::vector<uint64_t>& values) {
+        values.assign(size, 0);
+        for (size_t i = 0; i < words.size(); ++i) {
+            values[i] = modulus.reduce(words[i]);
+        }
+        forwardTransform(modulus, values.data(), size, roots);
+    };
+
+    if (square) {
+        transform(a, result);
+        for (size_t i = 0; i < size; ++i) {
+            result[i] = modulus.mul(result[i], result[i]);
+        }
+    }
+    else {
+        std::vector<uint64_t> other;
+        apmath::detail::parallelInvoke(true,
+                                       [&]() { transform(a, result); },
+                                       [&]() { transform(b, other); });
+        for (size_t i = 0; i < size; ++i) {
+            result[i] = modulus.mul(result[i], other[i]);
+        }
+    }
+
+    roots = rootTable(modulus, size, true);
+    inverseTransform(modulus, result.data(), size, roots);
+    // Pointwise products carry an extra 1/R and the inverse transform an extra size:
+    // multiplication by R / size in the Montgomery form fixes both
+    uint64_t scale = modulus.toMontgomery(
+        modulus.mul(modulus.toMontgomery(modulus.toMontgomery(1)), modulus.inverse(size % modulus.prime())));
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = modulus.mul(result[i], scale);
+    }
+}
+}
+
+namespace apmath {
+namespace detail {
+
+void multiplyNtt(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn) {
+    bool square = a == b && an == bn;
+    std::vector<uint64_t> aWords = packWords(a, an);
+    std::vector<uint64_t> bWords = square ? std::vector<uint64_t>() : packWords(b, bn);
+    size_t productWords = aWords.size() + (square ? aWords.size() : bWords.size());
+    size_t size = 1;
+    while (size < productWords) {
+        size <<= 1;
+    }
+
+    std::vector<uint64_t> residues[3];
+    parallelInvoke(true,
+                   [&]() { convolve(Moduli[0], aWords, bWords, square, residues[0], size); },
+                   [&]() { convolve(Moduli[1], aWords, bWords, square, residues[1], size); },
+                   [&]() { convolve(Moduli[2], aWords, bWords, square, residues[2], size); });
+
+    // Garner's mixed-radix CRT: x = t0 + t1 * p0 + t2 * p0 * p1
+    const Modulus& m0 = Moduli[0];
+    const Modulus& m1 = Moduli[1];
+    const Modulus& m2 = Moduli[2];
+    uint64_t p0 = m0.prime();
+    uint64_t p1 = m1.prime();
+    uint64_t inverseP0ModP1 = m1.toMontgomery(m1.inverse(p0 % p1));
+    uint64_t p0ModP2 = m2.toMontgomery(p0 % m2.prime());
+    uint64_t inverseP0P1ModP2 = m2.toMontgomery(m2.inverse(m2.mul(m2.toMontgomery(p0 % m2.prime()),
+                                                                   p1 % m2.prime())));
+    Uint128 p0p1 = static_cast<Uint128>(p0) * p1;
+    uint64_t p0p1Low = static_cast<uint64_t>(p0p1);
+    uint64_t p0p1High = static_cast<uint64_t>(p0p1 >> 64);
+
+    std::vector<uint64_t> words(productWords);
+    // Running 192-bit accumulator: the current word and a carry into the next two words
+    uint64_t carry0 = 0;
+    uint64_t carry1 = 0;
+    for (size_t k = 0; k < productWords; ++k) {
+        uint64_t t0 = residues[0][k];
+        uint64_t t1 = m1.mul(m1.sub(residues[1][k], t0 % p1), inverseP0ModP1);
+        uint64_t t2 = m2.sub(residues[2][k], t0 % m2.prime());
+        t2 = m2.sub(t2, m2.mul(t1, p0ModP2));
+        t2 = m2.mul(t2, inverseP0P1ModP2);
+
+        // value = t0 + t1 * p0 + t2 * p0p1, at most 3 words
+        Uint128 low = static_cast<Uint128>(t1) * p0 + t0;
+        Uint128 middle = static_cast<Uint128>(t2) * p0p1Low;
+        Uint128 high = static_cast<Uint128>(t2) * p0p1High;
+        Uint128 word0 = static_cast<Uint128>(static_cast<uint64_t>(low)) + static_cast<uint64_t>(middle) + carry0;
+        Uint128 word1 = (low >> 64) + (middle >> 64) + static_cast<uint64_t>(high) + carry1 + (word0 >> 64);
+        words[k] = static_cast<uint64_t>(word0);
+        carry0 = static_cast<uint64_t>(word1);
+        carry1 = static_cast<uint64_t>(high >> 64) + static_cast<uint64_t>(word1 >> 64);
+    }
+
+#if APMATH_LIMB_BITS == 64
+    std::copy(words.begin(), words.begin() + static_cast<std::ptrdiff_t>(an + bn), r);
+#else
+    for (size_t i = 0; i < an + bn; ++i) {
+        r[i] = static_cast<Limb>(words[i / 2] >> (32 * (i % 2)));
+    }
+#endif
+}
+
+} // namespace detail
+} // namespace apmath
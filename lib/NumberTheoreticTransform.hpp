@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+
+#include "BigInteger.hpp"
+
+namespace apmath {
+namespace detail {
+
+/**
+ * @brief multiplyNtt - computes r = a * b by number-theoretic transforms
+ * modulo three primes, the exact product is restored by the Chinese remainder theorem
+ * @param r - result with room for an + bn limbs, must not alias a or b
+ * @param a, an - first operand, an > 0
+ * @param b, bn - second operand, bn > 0
+ */
+void multiplyNtt(Limb* r, const Limb* a, std::size_t an, const Limb* b, std::size_t bn);
+
+} // namespace detail
+} // namespace apmath
@@ -0,0 +1,392 @@
+#include "NumberTheory.hpp"
+#include "LimbAccess.hpp"
+#include "LimbKernels.hpp"
+#include "ModContext.hpp"
+
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+using apmath::BigInteger;
+using apmath::Limb;
+using apmath::ModContext;
+using namespace apmath::detail;
+
+// Leading bits of the operands a Lehmer step works on. The cofactors stay below 2^LehmerBits,
+// so sums of digits and cofactors fit int64_t.
+constexpr unsigned LehmerBits = 60;
+// Primes below this bound are found by trial division
+constexpr unsigned TrialDivisionBound = 1000;
+
+BigInteger absoluteValue(const BigInteger& a) {
+    return a < 0 ? -a : a;
+}
+
+// 64 bits of the magnitude of x starting at bit shift
+std::uint64_t bitsFrom(const BigInteger& x, std::size_t shift) {
+    const LimbStorage& limbs = LimbAccess::limbs(x);
+    std::size_t index = shift / LimbBits;
+    unsigned offset = static_cast<unsigned>(shift % LimbBits);
+    std::uint64_t result = 0;
+    unsigned filled = 0;
+    while (filled < 64 && index < limbs.size()) {
+        std::uint64_t part = static_cast<std::uint64_t>(limbs[index] >> offset);
+        result |= part << filled;
+        filled += LimbBits - offset;
+        offset = 0;
+        ++index;
+    }
+    return result;
+}
+
+std::uint64_t isqrtWord(std::uint64_t n) {
+    std::uint64_t root = static_cast<std::uint64_t>(std::sqrt(static_cast<double>(n)));
+    // The rounded estimate may miss the root by one in either direction
+    while (root > 0 && root > n / root) {
+        --root;
+    }
+    while (root + 1 <= n / (root + 1)) {
+        ++root;
+    }
+    return root;
+}
+
+// a' = A * a + B * b, b' = C * a + D * b
+struct LehmerMatrix {
+    std::int64_t a;
+    std::int64_t b;
+    std::int64_t c;
+    std::int64_t d;
+};
+
+// Knuth's Algorithm L (TAOCP 4.5.2): runs the Euclidean algorithm on the leading bits x and y of the operands
+// while both bounds of the quotient agree, so the cofactors describe the same steps on the full numbers.
+// B is zero when not even the first quotient is certain.
+LehmerMatrix lehmerMatrix(std::int64_t x, std::int64_t y) {
+    LehmerMatrix m{1, 0, 0, 1};
+    while (y + m.c != 0 && y + m.d != 0) {
+        std::int64_t quotient = (x + m.a) / (y + m.c);
+        if (quotient != (x + m.b) / (y + m.d)) {
+            break;
+        }
+        std::int64_t next = m.a - quotient * m.c;
+        m.a = m.c;
+        m.c = next;
+        next = m.b - quotient * m.d;
+        m.b = m.d;
+        m.d = next;
+        next = x - quotient * y;
+        x = y;
+        y = next;
+    }
+    return m;
+}
+
+void applyMatrix(BigInteger& a, BigInteger& b, const LehmerMatrix& m) {
+    BigInteger nextA = a * m.a + b * m.b;
+    BigInteger nextB = a * m.c + b * m.d;
+    a = std::move(nextA);
+    b = std::move(nextB);
+}
+
+// Euclidean algorithm on nonnegative a and b, leaves the gcd in a and zero in b.
+// Cofactors are updated like the numbers, so starting from u0 = 1 and u1 = 0 they end with a = u0 * a0 (mod b0).
+// Without cofactors the algorithm finishes with a binary gcd once the numbers fit 64 bits.
+void euclid(BigInteger& a, BigInteger& b, BigInteger* u0, BigInteger* u1) {
+    if (a < b) {
+        std::swap(a, b);
+        if (u0) {
+            std::swap(*u0, *u1);
+        }
+    }
+    while (b != 0) {
+        std::size_t bits = a.bitLength();
+        if (bits <= 64 && !u0) {
+            a = std::gcd(bitsFrom(a, 0), bitsFrom(b, 0));
+            b = 0;
+            return;
+        }
+        LehmerMatrix m{1, 0, 0, 1};
+        if (bits > 64) {
+            std::size_t shift = bits - LehmerBits;
+            m = lehmerMatrix(static_cast<std::int64_t>(bitsFrom(a, shift)), static_cast<std::int64_t>(bitsFrom(b, shift)));
+        }
+        if (m.b == 0) {
+            std::pair<BigInteger, BigInteger> division = divmod(a, b);
+            a = std::move(b);
+            b = std::move(division.second);
+            if (u0) {
+                BigInteger next = *u0 - division.first * *u1;
+                *u0 = std::move(*u1);
+                *u1 = std::move(next);
+            }
+        } else {
+            applyMatrix(a, b, m);
+            if (u0) {
+                applyMatrix(*u0, *u1, m);
+            }
+        }
+    }
+}
+
+struct TrialDivisor {
+    LimbDivisor product;
+    std::vector<Limb> primes;
+};
+
+// Odd primes below TrialDivisionBound grouped into products which fit a limb,
+// one remainder of n tests a whole group
+const std::vector<TrialDivisor>& trialDivisors() {
+    static const std::vector<TrialDivisor> divisors = [] {
+        std::vector<bool> composite(TrialDivisionBound);
+        std::vector<TrialDivisor> result;
+        Limb product = 1;
+        std::vector<Limb> primes;
+        for (unsigned p = 3; p < TrialDivisionBound; p += 2) {
+            if (composite[p]) {
+                continue;
+            }
+            for (unsigned multiple = p * p; multiple < TrialDivisionBound; multiple += 2 * p) {
+                composite[multiple] = true;
+            }
+            if (product > static_cast<Limb>(~Limb(0)) / p) {
+                result.push_back({LimbDivisor(product), std::move(primes)});
+                product = 1;
+                primes.clear();
+            }
+            product *= p;
+            primes.push_back(p);
+        }
+        result.push_back({LimbDivisor(product), std::move(primes)});
+        return result;
+    }();
+    return divisors;
+}
+
+// n - 1 = d * 2^s with odd d
+bool isStrongProbablePrime(const ModContext& context, const BigInteger& base, const BigInteger& d, std::size_t s) {
+    ModContext::Residue one = context.toResidue(1);
+    ModContext::Residue minusOne = context.toResidue(-1);
+    ModContext::Residue x = context.pow(context.toResidue(base), d);
+    if (x == one || x == minusOne) {
+        return true;
+    }
+    for (std::size_t i = 1; i < s; ++i) {
+        x = context.square(x);
+        if (x == minusOne) {
+            return true;
+        }
+        if (x == one) {
+            return false;
+        }
+    }
+    return false;
+}
+
+// Strong Lucas test with Selfridge's parameters: the first D of 5, -7, 9, -11, ... with (D/n) = -1,
+// P = 1 and Q = (1 - D) / 4. n is odd, not a perfect square and has no small factors.
+bool isStrongLucasProbablePrime(const ModContext& context, const BigInteger& n) {
+    std::int64_t discriminant = 5;
+    while (true) {
+        int symbol = apmath::jacobiSymbol(discriminant, n);
+        if (symbol == -1) {
+            break;
+        }
+        if (symbol == 0) {
+            return false;
+        }
+        discriminant = discriminant > 0 ? -(discriminant + 2) : 2 - discriminant;
+    }
+    BigInteger d = n + 1;
+    std::size_t s = d.countTrailingZeroBits();
+    d >>= s;
+
+    // U and V of the sequence with P = 1 from index 1 doubling along the bits of d,
+    // odd steps are U' = (U + V) / 2 and V' = (D * U + V) / 2
+    ModContext::Residue q = context.toResidue((1 - discriminant) / 4);
+    ModContext::Residue dResidue = context.toResidue(discriminant);
+    ModContext::Residue half = context.toResidue((n + 1) >> 1);
+    ModContext::Residue u = context.toResidue(1);
+    ModContext::Residue v = u;
+    ModContext::Residue qk = q;
+    for (std::size_t bit = d.bitLength() - 1; bit-- > 0; ) {
+        u = context.multiply(u, v);
+        v = context.subtract(context.square(v), context.add(qk, qk));
+        qk = context.square(qk);
+        if (d.testBit(bit)) {
+            ModContext::Residue nextU = context.multiply(context.add(u, v), half);
+            v = context.multiply(context.add(context.multiply(dResidue, u), v), half);
+            u = std::move(nextU);
+            qk = context.multiply(qk, q);
+        }
+    }
+    ModContext::Residue zero = context.toResidue(0);
+    if (u == zero || v == zero) {
+        return true;
+    }
+    for (std::size_t i = 1; i < s; ++i) {
+        v = context.subtract(context.square(v), context.add(qk, qk));
+        qk = context.square(qk);
+        if (v == zero) {
+            return true;
+        }
+    }
+    return false;
+}
+} // namespace
+
+namespace apmath {
+
+BigInteger gcd(const BigInteger& a, const BigInteger& b) {
+    BigInteger x = absoluteValue(a);
+    BigInteger y = absoluteValue(b);
+    euclid(x, y, nullptr, nullptr);
+    return x;
+}
+
+BigInteger lcm(const BigInteger& a, const BigInteger& b) {
+    if (a == 0 || b == 0) {
+        return BigInteger(0);
+    }
+    return absoluteValue(a) / gcd(a, b) * absoluteValue(b);
+}
+
+ExtendedGcd extendedGcd(const BigInteger& a, const BigInteger& b) {
+    BigInteger x = absoluteValue(a);
+    BigInteger y = absoluteValue(b);
+    BigInteger u0 = 1;
+    BigInteger u1 = 0;
+    euclid(x, y, &u0, &u1);
+    ExtendedGcd result{std::move(x), std::move(u0), BigInteger(0)};
+    if (a < 0) {
+        result.x = -result.x;
+    }
+    if (b != 0) {
+        result.y = (result.gcd - a * result.x) / b;
+    }
+    return result;
+}
+
+BigInteger isqrt(const BigInteger& n) {
+    if (n < 0) {
+        throw std::domain_error("isqrt of a negative number");
+    }
+    std::size_t bits = n.bitLength();
+    if (bits <= 64) {
+        return BigInteger(isqrtWord(bitsFrom(n, 0)));
+    }
+    // The root of the high half of the bits gives half of the root's bits, rounded up it's an upper bound,
+    // and Newton steps from above converge to the root without overshooting
+    std::size_t k = bits / 4;
+    BigInteger root = (isqrt(n >> (2 * k)) + 1) << k;
+    while (true) {
+        BigInteger next = (root + n / root) >> 1;
+        if (next >= root) {
+            return root;
+        }
+        root = std::move(next);
+    }
+}
+
+BigInteger pow(const BigInteger& base, std::uint64_t exponent) {
+    if (exponent == 0) {
+        return BigInteger(1);
+    }
+    BigInteger result = base;
+    for (unsigned bit = 63 - static_cast<unsigned>(__builtin_clzll(exponent)); bit-- > 0; ) {
+        result *= result;
+        if ((exponent >> bit) & 1) {
+            result *= base;
+        }
+    }
+    return result;
+}
+
+int jacobiSymbol(const BigInteger& a, const BigInteger& n) {
+    if (n <= 0 || !n.testBit(0)) {
+        throw std::domain_error("jacobiSymbol modulus must be positive and odd");
+    }
+    BigInteger x = a % n;
+    if (x < 0) {
+        x += n;
+    }
+    BigInteger m = n;
+    int result = 1;
+    while (x != 0) {
+        std::size_t zeros = x.countTrailingZeroBits();
+        x >>= zeros;
+        unsigned mod8 = static_cast<unsigned>(bitsFrom(m, 0) & 7);
+        // (2/m) = -1 for m = 3 or 5 (mod 8)
+        if (zeros % 2 == 1 && (mod8 == 3 || mod8 == 5)) {
+            result = -result;
+        }
+        // Quadratic reciprocity changes the sign when both numbers are 3 (mod 4)
+        if ((bitsFrom(x, 0) & 3) == 3 && (mod8 & 3) == 3) {
+            result = -result;
+        }
+        std::swap(x, m);
+        x %= m;
+    }
+    return m == 1 ? result : 0;
+}
+
+bool isProbablePrime(const BigInteger& n, unsigned rounds) {
+    if (n < 2) {
+        return false;
+    }
+    if (!n.testBit(0)) {
+        return n == 2;
+    }
+    const LimbStorage& limbs = LimbAccess::limbs(n);
+    for (const TrialDivisor& divisor : trialDivisors()) {
+        Limb remainder = divisor.product.remainder(limbs.data(), limbs.size());
+        for (Limb prime : divisor.primes) {
+            if (remainder % prime == 0) {
+                return n == prime;
+            }
+        }
+    }
+    if (n < TrialDivisionBound * TrialDivisionBound) {
+        return true;
+    }
+
+    BigInteger d = n - 1;
+    std::size_t s = d.countTrailingZeroBits();
+    d >>= s;
+    ModContext context(n);
+    if (!isStrongProbablePrime(context, BigInteger(2), d, s)) {
+        return false;
+    }
+    // Lucas sequences have no discriminant with (D/n) = -1 for squares
+    BigInteger root = isqrt(n);
+    if (root * root == n) {
+        return false;
+    }
+    if (!isStrongLucasProbablePrime(context, n)) {
+        return false;
+    }
+
+    // Bases are uniform in [2, n - 2], seeded by n so the result is reproducible
+    std::mt19937_64 generator(n.hash());
+    BigInteger range = n - 3;
+    std::size_t words = n.bitLength() / 64 + 1;
+    for (unsigned round = 0; round < rounds; ++round) {
+        BigInteger base = 0;
+        for (std::size_t i = 0; i < words; ++i) {
+            base <<= 64;
+            base += generator();
+        }
+        base %= range;
+        base += 2;
+        if (!isStrongProbablePrime(context, base, d, s)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace apmath
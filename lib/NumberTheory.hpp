@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+
+#include "BigInteger.hpp"
+
+/**
+ * Number-theoretic functions of BigInteger. Long operands take the asymptotically fast paths:
+ * gcd runs Lehmer's algorithm, which replaces dozens of division steps with one pass of single-word cofactors,
+ * isqrt doubles its precision by Newton steps which use the reciprocal division, pow squares
+ * with Karatsuba, Toom-3 and number-theoretic transforms, and primality tests multiply in Montgomery form.
+ */
+namespace apmath {
+
+/**
+ * @brief ExtendedGcd - gcd and the coefficients of Bezout's identity a * x + b * y = gcd
+ */
+struct ExtendedGcd {
+    BigInteger gcd;
+    BigInteger x;
+    BigInteger y;
+};
+
+/**
+ * @brief gcd - greatest common divisor of the absolute values, gcd(0, 0) is zero
+ */
+BigInteger gcd(const BigInteger& a, const BigInteger& b);
+/**
+ * @brief lcm - least common multiple of the absolute values, zero if either number is zero
+ */
+BigInteger lcm(const BigInteger& a, const BigInteger& b);
+/**
+ * @brief extendedGcd - gcd(a, b) with x and y such that a * x + b * y = gcd(a, b)
+ */
+ExtendedGcd extendedGcd(const BigInteger& a, const BigInteger& b);
+/**
+ * @brief isqrt - integer square root, the greatest x with x * x <= n
+ * @throw std::domain_error if n is negative
+ */
+BigInteger isqrt(const BigInteger& n);
+/**
+ * @brief pow - base^exponent by repeated squaring, pow(0, 0) is one
+ */
+BigInteger pow(const BigInteger& base, std::uint64_t exponent);
+/**
+ * @brief jacobiSymbol - Jacobi symbol (a/n), -1, 0 or 1
+ * @throw std::domain_error if n isn't positive and odd
+ */
+int jacobiSymbol(const BigInteger& a, const BigInteger& n);
+/**
+ * @brief isProbablePrime - Baillie-PSW test: trial division, a strong Fermat test to base 2
+ * and a strong Lucas test with Selfridge's parameters. No composite passing it is known,
+ * and it's exact for n < 2^64.
+ * @param rounds - additional Miller-Rabin rounds with pseudorandom bases
+ */
+bool isProbablePrime(const BigInteger& n, unsigned rounds = 0);
+
+} // namespace apmath
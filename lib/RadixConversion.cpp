@@ -0,0 +1,348 @@
+#include "RadixConversion.hpp"
+#include "Division.hpp"
+#include "LimbKernels.hpp"
+#include "Multiplication.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+using apmath::Limb;
+using namespace apmath::detail;
+
+// Decimal digits are converted in chunks: the largest power of ten fitting into a limb.
+#if APMATH_LIMB_BITS == 64
+constexpr size_t ChunkDigits = 19;
+constexpr Limb ChunkBase = 10000000000000000000ULL;
+#else
+constexpr size_t ChunkDigits = 9;
+constexpr Limb ChunkBase = 1000000000UL;
+#endif
+
+// Numbers up to these sizes are converted by the quadratic chunk-by-chunk algorithm.
+constexpr size_t ParseThresholdChunks = 64;
+constexpr size_t PrintThresholdLimbs = 48;
+// Halves of numbers from these sizes are converted concurrently
+constexpr size_t ParallelParseChunks = 4096;
+constexpr size_t ParallelPrintLimbs = 4096;
+// DecimalParser converts blocks of ChunkBase^(2^BlockLevel), so joining 2^j blocks takes the cached power BlockLevel + j
+constexpr size_t BlockLevel = 12;
+constexpr size_t BlockDigits = ChunkDigits << BlockLevel;
+
+// Powers ChunkBase^(2^k) shared by all conversions. Divide-and-conquer splits
+// numbers at these powers, so each of them and its reciprocal is computed only once per process.
+// Long multiplications fork to the thread pool, and a thread waiting there may run another conversion,
+// so powers and reciprocals are computed outside the lock and only published under it.
+class PowerCache {
+public:
+    const std::vector<Limb>& power(size_t k) {
+        while (true) {
+            const std::vector<Limb>* last;
+            size_t count;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (mPowers.empty()) {
+                    mPowers.push_back(Entry{std::vector<Limb>(1, ChunkBase), nullptr});
+                }
+                if (mPowers.size() > k) {
+                    return mPowers[k].power;
+                }
+                last = &mPowers.back().power;
+                count = mPowers.size();
+            }
+            std::vector<Limb> square(2 * last->size());
+            multiplyLimbs(square.data(), last->data(), last->size(), last->data(), last->size());
+            square.resize(significantLength(square.data(), square.size()));
+            std::lock_guard<std::mutex> lock(mMutex);
+            // Another thread may have published the same power meanwhile
+            if (mPowers.size() == count) {
+                mPowers.push_back(Entry{std::move(square), nullptr});
+            }
+        }
+    }
+
+    const Reciprocal& reciprocal(size_t k) {
+        const std::vector<Limb>& divisor = power(k);
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mPowers[k].reciprocal) {
+                return *mPowers[k].reciprocal;
+            }
+        }
+        std::unique_ptr<Reciprocal> computed(new Reciprocal(divisor.data(), divisor.size()));
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mPowers[k].reciprocal) {
+            mPowers[k].reciprocal = std::move(computed);
+        }
+        return *mPowers[k].reciprocal;
+    }
+
+private:
+    struct Entry {
+        std::vector<Limb> power;
+        std::unique_ptr<Reciprocal> reciprocal;
+    };
+
+    // deque never relocates elements on push_back, so returned references stay valid
+    std::mutex mMutex;
+    std::deque<Entry> mPowers;
+};
+
+PowerCache& powerCache() {
+    static PowerCache cache;
+    return cache;
+}
+
+Limb parseChunk(const char* digits, size_t count) {
+    Limb chunk = 0;
+    for (size_t i = 0; i < count; ++i) {
+        chunk = chunk * 10 + static_cast<Limb>(digits[i] - '0');
+    }
+    return chunk;
+}
+
+// value = value * ChunkBase + chunk, chunk by chunk
+size_t parseBasecase(Limb* r, const char* digits, size_t count) {
+    size_t headDigits = count % ChunkDigits;
+    if (headDigits == 0) {
+        headDigits = ChunkDigits;
+    }
+    size_t length = 0;
+    Limb head = parseChunk(digits, headDigits);
+    if (head != 0) {
+        r[length++] = head;
+    }
+    for (size_t position = headDigits; position < count; position += ChunkDigits) {
+        Limb carry = multiplyByLimb(r, r, length, ChunkBase, parseChunk(digits + position, ChunkDigits));
+        if (carry != 0) {
+            r[length++] = carry;
+        }
+    }
+    return length;
+}
+
+// Writes the basecase number into exactly width characters, the lowest chunk last.
+void printBasecase(char* out, size_t width, const Limb* a, size_t n) {
+    std::vector<Limb> quotient(a, a + n);
+    size_t position = width;
+    while (n > 0 && position > 0) {
+        Limb chunk = divideByLimb(quotient.data(), quotient.data(), n, ChunkBase);
+        n = significantLength(quotient.data(), n);
+        for (size_t i = 0; i < ChunkDigits && position > 0; ++i) {
+            out[--position] = static_cast<char>('0' + chunk % 10);
+            chunk /= 10;
+        }
+    }
+    std::fill(out, out + position, '0');
+}
+
+void writeZeros(const std::function<void(const char*, size_t)>& write, size_t pieceDigits, size_t count) {
+    std::string zeros(std::min(count, pieceDigits), '0');
+    for (size_t written = 0; written < count; written += zeros.size()) {
+        write(zeros.data(), std::min(zeros.size(), count - written));
+    }
+}
+
+// Blocks of [begin, end) as one number: high * 10^(BlockDigits * low blocks) + low,
+// where the low part has the largest power of two of blocks less than their count
+std::vector<Limb> joinBlocks(std::vector<std::vector<Limb>>& blocks, size_t begin, size_t end) {
+    if (end - begin == 1) {
+        return std::move(blocks[begin]);
+    }
+    size_t j = 0;
+    while ((size_t(2) << j) < end - begin) {
+        ++j;
+    }
+    std::vector<Limb> high;
+    std::vector<Limb> low;
+    parallelInvoke(true,
+                   [&]() { high = joinBlocks(blocks, begin, end - (size_t(1) << j)); },
+                   [&]() { low = joinBlocks(blocks, end - (size_t(1) << j), end); });
+
+    const std::vector<Limb>& power = powerCache().power(BlockLevel + j);
+    std::vector<Limb> result(high.size() + power.size() + 1);
+    multiplyLimbs(result.data(), high.data(), high.size(), power.data(), power.size());
+    if (!low.empty()) {
+        // low < power, so the sum fits into the product's length plus one limb
+        addLimbs(result.data(), result.data(), result.size(), low.data(), low.size());
+    }
+    result.resize(significantLength(result.data(), result.size()));
+    return result;
+}
+}
+
+namespace apmath {
+namespace detail {
+
+size_t decimalDigitsLimbs(size_t count) {
+    // ChunkBase fits into a limb, so every chunk needs at most one limb
+    return (count + ChunkDigits - 1) / ChunkDigits;
+}
+
+size_t decimalDigitsBound(size_t n) {
+    // log10(2) < 0.30103
+    return n * LimbBits * 30103 / 100000 + 1;
+}
+
+// Divide and conquer: digits = high * ChunkBase^(2^k) + low, where low has ChunkDigits * 2^k digits.
+// Costs O(M(n) log n) with the cached powers instead of O(n^2) for the basecase.
+size_t parseDecimalDigits(Limb* r, const char* digits, size_t count) {
+    size_t chunks = decimalDigitsLimbs(count);
+    if (chunks <= ParseThresholdChunks) {
+        return parseBasecase(r, digits, count);
+    }
+    size_t k = 0;
+    while ((size_t(2) << k) < chunks) {
+        ++k;
+    }
+    size_t lowDigits = ChunkDigits << k;
+    size_t highDigits = count - lowDigits;
+
+    std::vector<Limb> high(decimalDigitsLimbs(highDigits));
+    std::vector<Limb> low(decimalDigitsLimbs(lowDigits));
+    size_t highLength = 0;
+    size_t lowLength = 0;
+    parallelInvoke(chunks >= ParallelParseChunks,
+                   [&]() { highLength = parseDecimalDigits(high.data(), digits, highDigits); },
+                   [&]() { lowLength = parseDecimalDigits(low.data(), digits + highDigits, lowDigits); });
+
+    const std::vector<Limb>& power = powerCache().power(k);
+    size_t length = highLength + power.size();
+    multiplyLimbs(r, high.data(), highLength, power.data(), power.size());
+    if (lowLength > 0) {
+        // low < power, so it is never longer than the product
+        Limb carry = addLimbs(r, r, length, low.data(), lowLength);
+        if (carry != 0) {
+            r[length++] = carry;
+        }
+    }
+    return significantLength(r, length);
+}
+
+// Divide and conquer: a = q * ChunkBase^(2^k) + r with the power about a half of a,
+// q and r are printed independently into adjacent parts of the output.
+void printDecimalDigits(char* out, size_t width, const Limb* a, size_t n) {
+    n = significantLength(a, n);
+    if (n <= PrintThresholdLimbs) {
+        printBasecase(out, width, a, n);
+        return;
+    }
+    size_t k = 0;
+    while (2 * powerCache().power(k + 1).size() <= n && (ChunkDigits << (k + 1)) < width) {
+        ++k;
+    }
+    const std::vector<Limb>& power = powerCache().power(k);
+    size_t lowWidth = ChunkDigits << k;
+    if (power.size() > n || lowWidth >= width) {
+        printBasecase(out, width, a, n);
+        return;
+    }
+
+    std::vector<Limb> quotient(n - power.size() + 1);
+    std::vector<Limb> remainder(power.size());
+    powerCache().reciprocal(k).divide(quotient.data(), remainder.data(), a, n);
+    parallelInvoke(n >= ParallelPrintLimbs,
+                   [&]() { printDecimalDigits(out, width - lowWidth, quotient.data(), quotient.size()); },
+                   [&]() { printDecimalDigits(out + width - lowWidth, lowWidth, remainder.data(), remainder.size()); });
+}
+
+// Like printDecimalDigits, with leaves of pieceDigits written out as soon as they're printed.
+// Digits above the magnitude's own bound are zeros and are written without any conversion.
+void writeDecimalDigits(const std::function<void(const char*, size_t)>& write, size_t pieceDigits,
+                        size_t width, const Limb* a, size_t n) {
+    n = significantLength(a, n);
+    if (width <= pieceDigits) {
+        std::string digits(width, '0');
+        printDecimalDigits(&digits[0], width, a, n);
+        write(digits.data(), width);
+        return;
+    }
+    size_t valueWidth = n == 0 ? 0 : decimalDigitsBound(n);
+    if (valueWidth < width) {
+        writeZeros(write, pieceDigits, width - valueWidth);
+        if (valueWidth > 0) {
+            writeDecimalDigits(write, pieceDigits, valueWidth, a, n);
+        }
+        return;
+    }
+    size_t k = 0;
+    while ((ChunkDigits << (k + 1)) < width) {
+        ++k;
+    }
+    size_t lowWidth = ChunkDigits << k;
+    const std::vector<Limb>& power = powerCache().power(k);
+    if (power.size() > n) {
+        // a < power, so the high digits are zeros
+        writeZeros(write, pieceDigits, width - lowWidth);
+        writeDecimalDigits(write, pieceDigits, lowWidth, a, n);
+        return;
+    }
+    std::vector<Limb> quotient(n - power.size() + 1);
+    std::vector<Limb> remainder(power.size());
+    powerCache().reciprocal(k).divide(quotient.data(), remainder.data(), a, n);
+    writeDecimalDigits(write, pieceDigits, width - lowWidth, quotient.data(), quotient.size());
+    quotient = std::vector<Limb>();
+    writeDecimalDigits(write, pieceDigits, lowWidth, remainder.data(), remainder.size());
+}
+
+void DecimalParser::append(const char* digits, size_t count) {
+    while (count > 0) {
+        if (mPending.empty() && count >= BlockDigits) {
+            std::vector<Limb> block(decimalDigitsLimbs(BlockDigits));
+            block.resize(parseDecimalDigits(block.data(), digits, BlockDigits));
+            mBlocks.push_back(std::move(block));
+            digits += BlockDigits;
+            count -= BlockDigits;
+            continue;
+        }
+        size_t taken = std::min(count, BlockDigits - mPending.size());
+        mPending.append(digits, taken);
+        digits += taken;
+        count -= taken;
+        if (mPending.size() == BlockDigits) {
+            std::vector<Limb> block(decimalDigitsLimbs(BlockDigits));
+            block.resize(parseDecimalDigits(block.data(), mPending.data(), BlockDigits));
+            mBlocks.push_back(std::move(block));
+            mPending.clear();
+        }
+    }
+}
+
+// Complete blocks are joined, then shifted by the digits of the incomplete block, which are added
+void DecimalParser::finish(LimbStorage& r) {
+    std::vector<Limb> tail(decimalDigitsLimbs(std::max<size_t>(mPending.size(), 1)));
+    size_t tailLength = mPending.empty() ? 0 : parseDecimalDigits(tail.data(), mPending.data(), mPending.size());
+    if (mBlocks.empty()) {
+        r.assign(tail.data(), tailLength);
+        mPending.clear();
+        return;
+    }
+    std::vector<Limb> blocks = joinBlocks(mBlocks, 0, mBlocks.size());
+    mBlocks.clear();
+    if (mPending.empty()) {
+        r.assign(blocks.data(), blocks.size());
+        return;
+    }
+    std::string scaleDigits(mPending.size() + 1, '0');
+    scaleDigits[0] = '1';
+    std::vector<Limb> scale(decimalDigitsLimbs(scaleDigits.size()));
+    size_t scaleLength = parseDecimalDigits(scale.data(), scaleDigits.data(), scaleDigits.size());
+    mPending.clear();
+
+    r.resize(blocks.size() + scaleLength + 1);
+    multiplyLimbs(r.data(), blocks.data(), blocks.size(), scale.data(), scaleLength);
+    r[blocks.size() + scaleLength] = 0;
+    if (tailLength > 0) {
+        addLimbs(r.data(), r.data(), r.size(), tail.data(), tailLength);
+    }
+    r.resize(significantLength(r.data(), r.size()));
+}
+
+} // namespace detail
+} // namespace apmath
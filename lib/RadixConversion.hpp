@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "BigInteger.hpp"
+
+namespace apmath {
+namespace detail {
+
+/**
+ * @brief decimalDigitsLimbs - upper bound of the limb count of a number with count decimal digits
+ */
+std::size_t decimalDigitsLimbs(std::size_t count);
+/**
+ * @brief decimalDigitsBound - upper bound of the decimal digit count of a number with n limbs
+ */
+std::size_t decimalDigitsBound(std::size_t n);
+/**
+ * @brief parseDecimalDigits - converts validated decimal digits to limbs
+ * @param r - result with room for decimalDigitsLimbs(count) limbs
+ * @param digits, count - decimal digits, the most significant first
+ * @return length of the result without high zero limbs
+ */
+std::size_t parseDecimalDigits(Limb* r, const char* digits, std::size_t count);
+/**
+ * @brief printDecimalDigits - converts limbs to exactly width decimal digits padded with zeros
+ * @param out - room for width characters
+ * @param a, n - magnitude less than 10^width
+ */
+void printDecimalDigits(char* out, std::size_t width, const Limb* a, std::size_t n);
+/**
+ * @brief writeDecimalDigits - converts limbs to exactly width decimal digits padded with zeros like
+ * printDecimalDigits, but passes them to write in pieces of at most pieceDigits characters,
+ * the most significant first, so the digits never have to be kept whole
+ * @param a, n - magnitude less than 10^width
+ */
+void writeDecimalDigits(const std::function<void(const char*, std::size_t)>& write, std::size_t pieceDigits,
+                        std::size_t width, const Limb* a, std::size_t n);
+
+/**
+ * @brief DecimalParser - converts validated decimal digits which arrive in pieces, like from a stream.
+ * Every block of digits is converted to limbs as soon as it's complete, so the digits are never kept whole,
+ * and finish() joins the blocks in a balanced tree at the cached powers of ten.
+ */
+class DecimalParser {
+public:
+    /**
+     * @brief append - adds digits, the most significant first
+     */
+    void append(const char* digits, std::size_t count);
+    /**
+     * @brief finish - stores the number of all appended digits, at least one, without high zero limbs
+     */
+    void finish(LimbStorage& r);
+
+private:
+    /**
+     * @brief mPending - digits of the incomplete last block
+     */
+    std::string mPending;
+    /**
+     * @brief mBlocks - limbs of the complete blocks, the most significant first
+     */
+    std::vector<std::vector<Limb>> mBlocks;
+};
+
+} // namespace detail
+} // namespace apmath
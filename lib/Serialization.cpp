@@ -0,0 +1,289 @@
+#include "Serialization.hpp"
+#include "LimbAccess.hpp"
+#include "LimbKernels.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+using apmath::BigInteger;
+using apmath::Limb;
+using namespace apmath::detail;
+
+constexpr std::uint32_t FormatVersion = 1;
+constexpr char SnapshotMagic[4] = {'A', 'P', 'M', 'B'};
+// Magic, version and record count
+constexpr std::size_t SnapshotHeaderSize = 16;
+constexpr std::size_t WordBytes = 8;
+constexpr std::size_t LimbsPerWord = 64 / LimbBits;
+
+// Byte loops are portable, compilers turn them into single loads and stores
+void storeWord(std::uint8_t* p, std::uint64_t word, std::size_t bytes = WordBytes) {
+    for (std::size_t i = 0; i < bytes; ++i) {
+        p[i] = static_cast<std::uint8_t>(word >> (8 * i));
+    }
+}
+
+std::uint64_t loadWord(const std::uint8_t* p, std::size_t bytes = WordBytes) {
+    std::uint64_t word = 0;
+    for (std::size_t i = 0; i < bytes; ++i) {
+        word |= static_cast<std::uint64_t>(p[i]) << (8 * i);
+    }
+    return word;
+}
+
+std::uint64_t wordOf(const Limb* limbs, std::size_t n, std::size_t i) {
+    std::uint64_t word = 0;
+    for (std::size_t j = 0; j < LimbsPerWord && i * LimbsPerWord + j < n; ++j) {
+        word |= static_cast<std::uint64_t>(limbs[i * LimbsPerWord + j]) << (LimbBits * j);
+    }
+    return word;
+}
+
+[[noreturn]] void malformed(const char* reason) {
+    throw std::runtime_error(std::string("BigInteger serialization error: ") + reason);
+}
+
+void serializeWords(const Limb* limbs, std::size_t n, bool negative, std::vector<std::uint8_t>& out) {
+    std::size_t words = (n + LimbsPerWord - 1) / LimbsPerWord;
+    std::size_t offset = out.size();
+    out.resize(offset + WordBytes * (words + 1));
+    std::uint8_t* p = out.data() + offset;
+    storeWord(p, static_cast<std::uint64_t>(words) << 1 | (negative ? 1 : 0));
+    for (std::size_t i = 0; i < words; ++i) {
+        storeWord(p + WordBytes * (i + 1), wordOf(limbs, n, i));
+    }
+}
+
+void serializeVarint(const Limb* limbs, std::size_t n, bool negative, std::vector<std::uint8_t>& out) {
+    std::size_t bytes = n == 0 ? 0 : ((n - 1) * LimbBits + LimbBits - countLeadingZeroBits(limbs[n - 1]) + 7) / 8;
+    std::uint64_t header = static_cast<std::uint64_t>(bytes) << 1 | (negative ? 1 : 0);
+    do {
+        out.push_back(static_cast<std::uint8_t>((header & 0x7F) | (header > 0x7F ? 0x80 : 0)));
+        header >>= 7;
+    } while (header != 0);
+    for (std::size_t i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<std::uint8_t>(limbs[i / sizeof(Limb)] >> (8 * (i % sizeof(Limb)))));
+    }
+}
+
+std::size_t deserializeWords(const std::uint8_t* data, std::size_t size, BigInteger& value) {
+    if (size < WordBytes) {
+        malformed("truncated record");
+    }
+    std::uint64_t header = loadWord(data);
+    std::uint64_t words = header >> 1;
+    bool negative = (header & 1) != 0;
+    if (words > (size - WordBytes) / WordBytes) {
+        malformed("truncated record");
+    }
+    const std::uint8_t* p = data + WordBytes;
+    if (words == 0 ? negative : loadWord(p + WordBytes * (words - 1)) == 0) {
+        malformed("non-canonical record");
+    }
+    LimbStorage& limbs = LimbAccess::limbs(value);
+    limbs.resize(static_cast<std::size_t>(words) * LimbsPerWord);
+    for (std::size_t i = 0; i < limbs.size(); ++i) {
+        limbs[i] = static_cast<Limb>(loadWord(p + WordBytes * (i / LimbsPerWord)) >> (LimbBits * (i % LimbsPerWord)));
+    }
+    LimbAccess::setNegative(value, negative);
+    return WordBytes * static_cast<std::size_t>(words + 1);
+}
+
+std::size_t deserializeVarint(const std::uint8_t* data, std::size_t size, BigInteger& value) {
+    std::uint64_t header = 0;
+    std::size_t length = 0;
+    for (unsigned shift = 0;; shift += 7) {
+        if (length == size) {
+            malformed("truncated record");
+        }
+        if (shift >= 64 || shift == 63 && data[length] > 1) {
+            malformed("varint header is too long");
+        }
+        std::uint8_t byte = data[length++];
+        header |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            break;
+        }
+    }
+    std::uint64_t bytes = header >> 1;
+    bool negative = (header & 1) != 0;
+    if (bytes > size - length) {
+        malformed("truncated record");
+    }
+    const std::uint8_t* p = data + length;
+    if (bytes == 0 ? negative : p[bytes - 1] == 0) {
+        malformed("non-canonical record");
+    }
+    LimbStorage& limbs = LimbAccess::limbs(value);
+    limbs.resize((static_cast<std::size_t>(bytes) + sizeof(Limb) - 1) / sizeof(Limb));
+    for (std::size_t i = 0; i < limbs.size(); ++i) {
+        limbs[i] = 0;
+    }
+    for (std::size_t i = 0; i < bytes; ++i) {
+        limbs[i / sizeof(Limb)] |= static_cast<Limb>(p[i]) << (8 * (i % sizeof(Limb)));
+    }
+    LimbAccess::setNegative(value, negative);
+    return length + static_cast<std::size_t>(bytes);
+}
+}
+
+namespace apmath {
+
+void serialize(const BigInteger& value, std::vector<std::uint8_t>& out, Encoding encoding) {
+    const LimbStorage& limbs = LimbAccess::limbs(value);
+    bool negative = LimbAccess::isNegative(value);
+    if (encoding == Encoding::Words) {
+        serializeWords(limbs.data(), limbs.size(), negative, out);
+    } else {
+        serializeVarint(limbs.data(), limbs.size(), negative, out);
+    }
+}
+
+std::size_t deserialize(const std::uint8_t* data, std::size_t size, BigInteger& value, Encoding encoding) {
+    if (encoding == Encoding::Words) {
+        return deserializeWords(data, size, value);
+    }
+    return deserializeVarint(data, size, value);
+}
+
+BigInteger BigIntegerView::toBigInteger(std::pmr::memory_resource* resource) const {
+    BigInteger result(resource);
+    LimbAccess::limbs(result).assign(mLimbs, mSize);
+    LimbAccess::setNegative(result, mNegative);
+    return result;
+}
+
+SnapshotWriter::SnapshotWriter(const std::string& path)
+    : mFile(path, std::ios::binary | std::ios::trunc),
+      mCount(0)
+{
+    if (!mFile) {
+        throw std::runtime_error("BigInteger snapshot error: can't create " + path);
+    }
+    std::uint8_t header[SnapshotHeaderSize] = {};
+    std::copy(SnapshotMagic, SnapshotMagic + sizeof(SnapshotMagic), header);
+    storeWord(header + sizeof(SnapshotMagic), FormatVersion, sizeof(FormatVersion));
+    mFile.write(reinterpret_cast<const char*>(header), sizeof(header));
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    try {
+        close();
+    }
+    catch (...) {
+    }
+}
+
+void SnapshotWriter::write(const BigInteger& value) {
+    mBuffer.clear();
+    serialize(value, mBuffer, Encoding::Words);
+    mFile.write(reinterpret_cast<const char*>(mBuffer.data()), static_cast<std::streamsize>(mBuffer.size()));
+    ++mCount;
+}
+
+void SnapshotWriter::close() {
+    if (!mFile.is_open()) {
+        return;
+    }
+    std::uint8_t count[WordBytes];
+    storeWord(count, mCount);
+    mFile.seekp(static_cast<std::streamoff>(SnapshotHeaderSize - WordBytes));
+    mFile.write(reinterpret_cast<const char*>(count), sizeof(count));
+    mFile.close();
+    if (!mFile) {
+        throw std::runtime_error("BigInteger snapshot error: write failed");
+    }
+}
+
+SnapshotFile::SnapshotFile(const std::string& path)
+    : mData(nullptr),
+      mSize(0),
+      mCount(0)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    throw std::runtime_error("BigInteger snapshot error: mapping needs a little-endian host");
+#endif
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("BigInteger snapshot error: can't open " + path);
+    }
+    struct stat status;
+    if (::fstat(fd, &status) != 0 || static_cast<std::size_t>(status.st_size) < SnapshotHeaderSize) {
+        ::close(fd);
+        throw std::runtime_error("BigInteger snapshot error: " + path + " isn't a snapshot");
+    }
+    mSize = static_cast<std::size_t>(status.st_size);
+    void* data = ::mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("BigInteger snapshot error: can't map " + path);
+    }
+    mData = static_cast<const std::uint8_t*>(data);
+    // Records are read in order, the kernel may read ahead
+    ::madvise(data, mSize, MADV_SEQUENTIAL);
+
+    if (!std::equal(SnapshotMagic, SnapshotMagic + sizeof(SnapshotMagic), mData) ||
+        loadWord(mData + sizeof(SnapshotMagic), sizeof(FormatVersion)) != FormatVersion) {
+        ::munmap(data, mSize);
+        throw std::runtime_error("BigInteger snapshot error: " + path + " isn't a snapshot of version 1");
+    }
+    mCount = static_cast<std::size_t>(loadWord(mData + SnapshotHeaderSize - WordBytes));
+}
+
+SnapshotFile::~SnapshotFile() {
+    ::munmap(const_cast<std::uint8_t*>(mData), mSize);
+}
+
+SnapshotFile::Iterator SnapshotFile::begin() const {
+    return Iterator(this, 0, SnapshotHeaderSize);
+}
+
+SnapshotFile::Iterator SnapshotFile::end() const {
+    return Iterator(this, mCount, mSize);
+}
+
+std::size_t SnapshotFile::recordAt(std::size_t offset, bool& negative) const {
+    if (mSize - offset < WordBytes) {
+        malformed("truncated snapshot");
+    }
+    std::uint64_t header = loadWord(mData + offset);
+    std::uint64_t words = header >> 1;
+    negative = (header & 1) != 0;
+    if (words > (mSize - offset - WordBytes) / WordBytes) {
+        malformed("truncated snapshot");
+    }
+    if (words == 0 ? negative : loadWord(mData + offset + WordBytes * words) == 0) {
+        malformed("non-canonical record");
+    }
+    return static_cast<std::size_t>(words);
+}
+
+SnapshotFile::Iterator::Iterator(const SnapshotFile* file, std::size_t index, std::size_t offset)
+    : mFile(file),
+      mIndex(index),
+      mOffset(offset)
+{}
+
+BigIntegerView SnapshotFile::Iterator::operator*() const {
+    bool negative = false;
+    std::size_t words = mFile->recordAt(mOffset, negative);
+    // The mapping is page-aligned and records are whole words, so the words are aligned limbs
+    const Limb* limbs = reinterpret_cast<const Limb*>(mFile->mData + mOffset + WordBytes);
+    return BigIntegerView(limbs, significantLength(limbs, words * LimbsPerWord), negative);
+}
+
+SnapshotFile::Iterator& SnapshotFile::Iterator::operator++() {
+    bool negative = false;
+    std::size_t words = mFile->recordAt(mOffset, negative);
+    mOffset += WordBytes * (words + 1);
+    ++mIndex;
+    return *this;
+}
+
+} // namespace apmath
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "BigInteger.hpp"
+
+/**
+ * Binary serialization of BigInteger, format version 1. All numbers are little-endian regardless of the host
+ * and of the limb width, so data written with 32-bit limbs reads back with 64-bit ones and vice versa.
+ *
+ * Encoding::Words - a 64-bit header (word count << 1 | sign) and the magnitude in 64-bit words.
+ * Records are multiples of 8 bytes, so in an aligned buffer or a mapped file the words are the limbs themselves.
+ * Encoding::Varint - a LEB128 header (byte count << 1 | sign) and the magnitude in bytes,
+ * a balance like 12345 takes three bytes.
+ *
+ * A snapshot file is a header (the magic "APMB", the 32-bit version and the 64-bit record count)
+ * followed by records in the Words encoding, SnapshotFile maps it and reads numbers in place.
+ */
+namespace apmath {
+
+/**
+ * @brief Encoding - record layout of serialize and deserialize
+ */
+enum class Encoding {
+    Words,
+    Varint
+};
+
+/**
+ * @brief serialize - appends the record of value to out
+ */
+void serialize(const BigInteger& value, std::vector<std::uint8_t>& out, Encoding encoding = Encoding::Words);
+/**
+ * @brief deserialize - reads one record from the beginning of [data, data + size)
+ * @return number of bytes the record takes
+ * @throw std::runtime_error if the record is truncated or malformed
+ */
+std::size_t deserialize(const std::uint8_t* data, std::size_t size, BigInteger& value,
+                        Encoding encoding = Encoding::Words);
+
+/**
+ * @brief BigIntegerView - read-only number stored elsewhere, like a record of a mapped snapshot.
+ * The view doesn't own its limbs, they must outlive it.
+ */
+class BigIntegerView {
+public:
+    BigIntegerView(const Limb* limbs, std::size_t size, bool negative)
+        : mLimbs(limbs),
+          mSize(size),
+          mNegative(negative)
+    {}
+
+    /**
+     * @brief limbs - little-endian magnitude without high zero limbs
+     */
+    const Limb* limbs() const { return mLimbs; }
+    std::size_t size() const { return mSize; }
+    bool isNegative() const { return mNegative; }
+
+    /**
+     * @brief toBigInteger - copies the limbs into a number, no digits are parsed
+     * @param resource - memory resource of the limbs, it must outlive the number
+     */
+    BigInteger toBigInteger(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+private:
+    const Limb* mLimbs;
+    std::size_t mSize;
+    bool mNegative;
+};
+
+/**
+ * @brief SnapshotWriter - writes numbers into a snapshot file one by one,
+ * the record count in the header is written by close()
+ */
+class SnapshotWriter {
+public:
+    /**
+     * @throw std::runtime_error if the file can't be created
+     */
+    explicit SnapshotWriter(const std::string& path);
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+    // Closes the file, errors of the last writes are lost, close() reports them
+    ~SnapshotWriter();
+
+    void write(const BigInteger& value);
+    /**
+     * @brief close - completes the header and closes the file
+     * @throw std::runtime_error if writing failed
+     */
+    void close();
+
+private:
+    std::ofstream mFile;
+    std::uint64_t mCount;
+    std::vector<std::uint8_t> mBuffer;
+};
+
+/**
+ * @brief SnapshotFile - snapshot file mapped into memory. Numbers are views of the mapped words,
+ * so loading costs no parsing and no copying until a view is converted to BigInteger.
+ * Records are checked while they're iterated. Views are valid as long as the file object lives.
+ * Only little-endian hosts map the words as limbs, big-endian ones throw from the constructor.
+ */
+class SnapshotFile {
+public:
+    /**
+     * @brief Iterator - forward iterator over the records
+     * @throw std::runtime_error from operator* and operator++ if a record is malformed
+         * or runs past the end of the file
+     */
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = BigIntegerView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const BigIntegerView*;
+        using reference = BigIntegerView;
+
+        BigIntegerView operator*() const;
+        Iterator& operator++();
+        Iterator operator++(int) {
+            Iterator result(*this);
+            ++*this;
+            return result;
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) { return lhs.mIndex == rhs.mIndex; }
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) { return !(lhs == rhs); }
+
+    private:
+        friend class SnapshotFile;
+
+        Iterator(const SnapshotFile* file, std::size_t index, std::size_t offset);
+
+        const SnapshotFile* mFile;
+        std::size_t mIndex;
+        /**
+         * @brief mOffset - byte offset of the current record's header
+         */
+        std::size_t mOffset;
+    };
+
+    /**
+     * @throw std::runtime_error if the file can't be mapped or isn't a snapshot of a known version
+     */
+    explicit SnapshotFile(const std::string& path);
+    SnapshotFile(const SnapshotFile&) = delete;
+    SnapshotFile& operator=(const SnapshotFile&) = delete;
+    ~SnapshotFile();
+
+    /**
+     * @brief size - number of records written to the file
+     */
+    std::size_t size() const { return mCount; }
+
+    Iterator begin() const;
+    Iterator end() const;
+
+private:
+    const std::uint8_t* mData;
+    std::size_t mSize;
+    std::size_t mCount;
+
+    /**
+     * @brief recordAt - checks the record at offset and returns its word count
+     */
+    std::size_t recordAt(std::size_t offset, bool& negative) const;
+};
+
+} // namespace apmath
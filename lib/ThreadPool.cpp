@@ -0,0 +1,195 @@
+#include "ThreadPool.hpp"
+#include "Tuning.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+using apmath::detail::ThreadPool;
+
+// Pool and queue of the calling thread if it's a worker
+thread_local ThreadPool* workerPool = nullptr;
+thread_local size_t workerQueue = 0;
+
+size_t hardwareThreads() {
+    return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+// The shared pool is created by the first parallel operation and replaced when the thread count changes.
+// Pools are owned only by threads outside them, so a pool is never destroyed by its own worker.
+struct SharedPool {
+    std::mutex mutex;
+    size_t threads = hardwareThreads();
+    std::shared_ptr<ThreadPool> pool;
+};
+
+SharedPool& sharedPool() {
+    static SharedPool shared;
+    return shared;
+}
+}
+
+namespace apmath {
+
+size_t threadCount() {
+    SharedPool& shared = sharedPool();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    return shared.threads;
+}
+
+void setThreadCount(size_t count) {
+    SharedPool& shared = sharedPool();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    shared.threads = count == 0 ? hardwareThreads() : count;
+    shared.pool.reset();
+}
+
+namespace detail {
+
+void Task::run() {
+    try {
+        mInvoke(mCallable);
+    }
+    catch (...) {
+        mError = std::current_exception();
+    }
+    mDone.store(true, std::memory_order_release);
+}
+
+void Task::rethrow() {
+    if (mError) {
+        std::rethrow_exception(mError);
+    }
+}
+
+// The calling thread takes part in every operation, so the pool starts one thread less
+ThreadPool::ThreadPool(size_t workers) {
+    for (size_t i = 0; i <= workers; ++i) {
+        mQueues.emplace_back(new Queue());
+    }
+    for (size_t i = 0; i < workers; ++i) {
+        mThreads.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+        mStopping = true;
+    }
+    mWakeUp.notify_all();
+    for (std::thread& thread : mThreads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::fork(Task& task) {
+    Queue& queue = *mQueues[localQueue()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(&task);
+    }
+    mQueued.fetch_add(1, std::memory_order_release);
+    {
+        // A worker checks mQueued under this mutex before it sleeps, so the wake-up is never lost
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+    }
+    mWakeUp.notify_one();
+}
+
+void ThreadPool::join(Task& task) {
+    size_t queue = localQueue();
+    if (remove(queue, &task)) {
+        task.run();
+    }
+    while (!task.done()) {
+        if (Task* other = take(queue)) {
+            other->run();
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    task.rethrow();
+}
+
+// Threads outside the pool share the last queue
+size_t ThreadPool::localQueue() const {
+    return workerPool == this ? workerQueue : mQueues.size() - 1;
+}
+
+// Forks and joins are nested, so the task is usually the newest one of the queue
+bool ThreadPool::remove(size_t queue, Task* task) {
+    Queue& local = *mQueues[queue];
+    std::lock_guard<std::mutex> lock(local.mutex);
+    for (auto it = local.tasks.rbegin(); it != local.tasks.rend(); ++it) {
+        if (*it == task) {
+            local.tasks.erase(std::next(it).base());
+            mQueued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+// The newest task of the own queue keeps its data in cache, the oldest task of another queue
+// is the largest part of the work left there
+Task* ThreadPool::take(size_t queue) {
+    if (mQueued.load(std::memory_order_acquire) == 0) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < mQueues.size(); ++i) {
+        Queue& victim = *mQueues[(queue + i) % mQueues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) {
+            continue;
+        }
+        Task* task;
+        if (i == 0) {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+        }
+        else {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+        }
+        mQueued.fetch_sub(1, std::memory_order_relaxed);
+        return task;
+    }
+    return nullptr;
+}
+
+void ThreadPool::work(size_t queue) {
+    workerPool = this;
+    workerQueue = queue;
+    while (true) {
+        if (Task* task = take(queue)) {
+            task->run();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mSleepMutex);
+        mWakeUp.wait(lock, [this]() { return mStopping || mQueued.load(std::memory_order_acquire) > 0; });
+        if (mStopping) {
+            return;
+        }
+    }
+}
+
+std::shared_ptr<ThreadPool> currentPool() {
+    if (workerPool != nullptr) {
+        // Workers don't own their pool, the thread which started the operation does
+        return std::shared_ptr<ThreadPool>(std::shared_ptr<ThreadPool>(), workerPool);
+    }
+    SharedPool& shared = sharedPool();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    if (shared.threads <= 1) {
+        return nullptr;
+    }
+    if (!shared.pool) {
+        shared.pool = std::make_shared<ThreadPool>(shared.threads - 1);
+    }
+    return shared.pool;
+}
+
+} // namespace detail
+} // namespace apmath
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Fork-join parallelism for long operations.
+ * Every worker owns a queue of tasks: it takes the newest task from its own queue
+ * and steals the oldest one from other queues when its queue is empty.
+ * Threads outside the pool share one more queue. A thread waiting for a forked task
+ * runs other tasks meanwhile, so nested forks never block the pool.
+ */
+namespace apmath {
+namespace detail {
+
+/**
+ * @brief Task - callable forked to the pool, lives on the stack of the thread which forked it
+ */
+class Task {
+public:
+    template <typename F>
+    explicit Task(F& callable)
+        : mCallable(&callable),
+          mInvoke([](void* f) { (*static_cast<F*>(f))(); })
+    {}
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    void run();
+    bool done() const { return mDone.load(std::memory_order_acquire); }
+    // Rethrows the exception the callable exited with
+    void rethrow();
+
+private:
+    void* mCallable;
+    void (*mInvoke)(void*);
+    std::exception_ptr mError;
+    std::atomic<bool> mDone{false};
+};
+
+/**
+ * @brief ThreadPool - work-stealing pool of worker threads
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(std::size_t workers);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief fork - queues the task to the queue of the calling thread
+     */
+    void fork(Task& task);
+    /**
+     * @brief join - waits until the forked task is finished, runs it in the calling thread
+     * if no one has taken it yet and other queued tasks while it runs elsewhere
+     * @throw the exception the task exited with
+     */
+    void join(Task& task);
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task*> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> mQueues;
+    std::vector<std::thread> mThreads;
+    std::atomic<std::size_t> mQueued{0};
+    std::mutex mSleepMutex;
+    std::condition_variable mWakeUp;
+    bool mStopping = false;
+
+    std::size_t localQueue() const;
+    bool remove(std::size_t queue, Task* task);
+    Task* take(std::size_t queue);
+    void work(std::size_t queue);
+};
+
+/**
+ * @brief currentPool - pool for the calling thread, null when operations run serially.
+ * Workers get their own pool, other threads the shared one of threadCount() threads.
+ */
+std::shared_ptr<ThreadPool> currentPool();
+
+/**
+ * @brief parallelInvoke - calls every function, concurrently when parallel is set
+ * and the pool has threads, returns when all of them are finished
+ * @throw the first exception thrown by the functions
+ */
+template <typename F>
+void parallelInvoke(bool, F&& f) {
+    f();
+}
+
+template <typename F, typename... Rest>
+void parallelInvoke(bool parallel, F&& f, Rest&&... rest) {
+    std::shared_ptr<ThreadPool> pool = parallel ? currentPool() : nullptr;
+    auto others = [&]() { parallelInvoke(parallel, std::forward<Rest>(rest)...); };
+    if (!pool) {
+        f();
+        others();
+        return;
+    }
+    Task task(others);
+    pool->fork(task);
+    try {
+        f();
+    }
+    catch (...) {
+        // The task refers to this frame, it has to finish before the stack unwinds
+        try {
+            pool->join(task);
+        }
+        catch (...) {
+        }
+        throw;
+    }
+    pool->join(task);
+}
+
+/**
+ * @brief parallelFor - calls body(first, last) for adjacent ranges covering [begin, end),
+ * ranges are halved while they are longer than grain
+ */
+template <typename Body>
+void parallelFor(std::size_t begin, std::size_t end, std::size_t grain, const Body& body) {
+    if (end - begin <= grain) {
+        body(begin, end);
+        return;
+    }
+    std::size_t middle = begin + (end - begin) / 2;
+    parallelInvoke(true,
+                   [&]() { parallelFor(begin, middle, grain, body); },
+                   [&]() { parallelFor(middle, end, grain, body); });
+}
+
+} // namespace detail
+} // namespace apmath
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+
+namespace apmath {
+
+/**
+ * @brief MultiplicationThresholds - lengths of the shorter operand in limbs
+ * from which multiplication switches to the next algorithm:
+ * schoolbook -> Karatsuba -> Toom-3 -> number-theoretic transform.
+ * Run big-number-tune to find the best values for the host.
+ */
+struct MultiplicationThresholds {
+    std::size_t karatsuba;
+    std::size_t toom3;
+    std::size_t ntt;
+};
+
+/**
+ * @brief defaultMultiplicationThresholds - thresholds the library starts with
+ */
+MultiplicationThresholds defaultMultiplicationThresholds();
+/**
+ * @brief multiplicationThresholds - thresholds currently in use
+ */
+MultiplicationThresholds multiplicationThresholds();
+/**
+ * @brief setMultiplicationThresholds - replaces thresholds for all threads,
+ * too small values are raised to the least ones the algorithms work with
+ */
+void setMultiplicationThresholds(const MultiplicationThresholds& thresholds);
+
+/**
+ * @brief SimdLevel - instruction set of the addition, subtraction and comparison kernels.
+ * Vector kernels are built for x86-64 with 64-bit limbs and chosen by the host CPU at runtime.
+ */
+enum class SimdLevel {
+    Scalar,
+    Avx2,
+    Avx512
+};
+
+/**
+ * @brief simdLevel - kernels currently in use, the best ones the CPU supports by default
+ */
+SimdLevel simdLevel();
+/**
+ * @brief setSimdLevel - switches kernels for all threads
+ * @return false if the build or the CPU doesn't support the level, kernels are not changed then
+ */
+bool setSimdLevel(SimdLevel level);
+
+/**
+ * @brief threadCount - threads a single long operation may use, the calling one included.
+ * Long multiplications, decimal conversions and batch reductions split their work among them.
+ * Every hardware thread is used by default.
+ */
+std::size_t threadCount();
+/**
+ * @brief setThreadCount - changes the thread count for all following operations,
+ * 1 runs everything in the calling thread, 0 restores the default
+ */
+void setThreadCount(std::size_t count);
+
+} // namespace apmath
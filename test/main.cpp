@@ -2,9 +2,64 @@
 #include <QDebug>
 #include <QtTest/QtTest>
 
+#include <atomic>
+#include <filesystem>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <memory_resource>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Accumulator.hpp"
+#include "Batch.hpp"
 #include "BigInteger.hpp"
+#include "Decimal.hpp"
+#include "Expression.hpp"
+#include "FixedBigInteger.hpp"
+#include "FixedInteger.hpp"
+#include "Instrumentation.hpp"
+#include "ModContext.hpp"
+#include "NumberTheory.hpp"
+#include "Serialization.hpp"
+#include "Tuning.hpp"
 
 using namespace apmath;
+using namespace apmath::literals;
+
+// Memory resource which counts live allocations of the upstream resource
+class CountingResource: public std::pmr::memory_resource
+{
+public:
+    int allocations() const { return mAllocations.load(); }
+    int deallocations() const { return mDeallocations.load(); }
+
+private:
+    // Copies written in several threads allocate concurrently
+    std::atomic<int> mAllocations{0};
+    std::atomic<int> mDeallocations{0};
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++mAllocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        ++mDeallocations;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// The compare() test slot hides the free function inside the test class
+template <typename T>
+int threeWayCompare(const BigInteger& lhs, const T& rhs) {
+    return compare(lhs, rhs);
+}
 
 class TestBigInteger: public QObject
 {
@@ -285,6 +340,969 @@ private slots:
         QCOMPARE(BigInteger("-000").toString(), std::string("0"));
     }
 
+    void longConversion() {
+        std::string longNumber;
+        for (int i = 0; i < 500; ++i) {
+            longNumber += OneToZero;
+        }
+        QCOMPARE(BigInteger(longNumber).toString(), longNumber);
+        QCOMPARE(BigInteger("-" + longNumber).toString(), "-" + longNumber);
+
+        std::string longNines(20000, '9');
+        std::string longPowerOfTen = "1" + std::string(20000, '0');
+        QCOMPARE(BigInteger(longNines) + BigInteger("1"), BigInteger(longPowerOfTen));
+        QCOMPARE((BigInteger(longPowerOfTen) - BigInteger("1")).toString(), longNines);
+    }
+
+    void multiply() {
+        BigInteger oneToZero(OneToZero);
+        BigInteger square("152415787532388367504953515625666819450083828733760097552251181223112635269100012193273126047859425087639153757049236500533455762536198787501905199875019052100");
+        QCOMPARE(oneToZero * oneToZero, square);
+        QCOMPARE(-oneToZero * oneToZero, -square);
+        QCOMPARE(-oneToZero * -oneToZero, square);
+        QCOMPARE(oneToZero * BigInteger("0"), BigInteger("0"));
+        QCOMPARE(BigInteger("-0") * -oneToZero, BigInteger("0"));
+
+        BigInteger product(oneToZero);
+        product *= product;
+        QCOMPARE(product, square);
+
+        // (10^n - 1)^2 = 10^2n - 2 * 10^n + 1 with every multiplication algorithm
+        std::string longNines(20000, '9');
+        BigInteger powerOfTen("1" + std::string(20000, '0'));
+        BigInteger expected = powerOfTen * powerOfTen - powerOfTen - powerOfTen + BigInteger("1");
+        const MultiplicationThresholds defaults = defaultMultiplicationThresholds();
+        const std::size_t never = static_cast<std::size_t>(-1);
+        const MultiplicationThresholds algorithms[] = {
+            {never, never, never}, {4, never, never}, {4, 8, never}, {4, 8, 1}, defaults
+        };
+        for (const auto& thresholds: algorithms) {
+            setMultiplicationThresholds(thresholds);
+            QCOMPARE(BigInteger(longNines) * BigInteger(longNines), expected);
+            QCOMPARE(BigInteger(longNines) * oneToZero, powerOfTen * oneToZero - oneToZero);
+        }
+        setMultiplicationThresholds(defaults);
+    }
+
+    void divide() {
+        BigInteger oneToZero(OneToZero);
+        BigInteger square = oneToZero * oneToZero;
+        QCOMPARE(square / oneToZero, oneToZero);
+        QCOMPARE(square % oneToZero, BigInteger("0"));
+        QCOMPARE((square + BigInteger("12345")) % oneToZero, BigInteger("12345"));
+        QCOMPARE(oneToZero / square, BigInteger("0"));
+        QCOMPARE(oneToZero % square, oneToZero);
+
+        QCOMPARE(BigInteger("7") / BigInteger("2"), BigInteger("3"));
+        QCOMPARE(BigInteger("-7") / BigInteger("2"), BigInteger("-3"));
+        QCOMPARE(BigInteger("7") / BigInteger("-2"), BigInteger("-3"));
+        QCOMPARE(BigInteger("-7") / BigInteger("-2"), BigInteger("3"));
+        QCOMPARE(BigInteger("7") % BigInteger("2"), BigInteger("1"));
+        QCOMPARE(BigInteger("-7") % BigInteger("2"), BigInteger("-1"));
+        QCOMPARE(BigInteger("7") % BigInteger("-2"), BigInteger("1"));
+        QCOMPARE(BigInteger("-6") % BigInteger("2"), BigInteger("0"));
+
+        BigInteger self(OneToZero);
+        self /= self;
+        QCOMPARE(self, BigInteger("1"));
+
+        std::pair<BigInteger, BigInteger> result = divmod(BigInteger(ManyNines), BigInteger("-1000000007"));
+        QCOMPARE(result.first * BigInteger("-1000000007") + result.second, BigInteger(ManyNines));
+        QVERIFY(result.second >= BigInteger("0") && result.second < BigInteger("1000000007"));
+
+        QVERIFY_EXCEPTION_THROWN(oneToZero / BigInteger("0"), std::domain_error);
+        QVERIFY_EXCEPTION_THROWN(oneToZero % BigInteger("-0"), std::domain_error);
+
+        // Long operands go through the Newton reciprocal
+        std::string dividendDigits;
+        std::string divisorDigits;
+        for (int i = 0; i < 300; ++i) {
+            dividendDigits += OneToZero;
+        }
+        for (int i = 0; i < 60; ++i) {
+            divisorDigits += DoubledOneToZero;
+        }
+        BigInteger dividend(dividendDigits);
+        BigInteger divisor(divisorDigits);
+        result = divmod(dividend, divisor);
+        QCOMPARE(result.first * divisor + result.second, dividend);
+        QVERIFY(result.second >= BigInteger("0") && result.second < divisor);
+
+        BigInteger nines(std::string(30000, '9'));
+        BigInteger powerOfTen("1" + std::string(10000, '0'));
+        QCOMPARE(nines / powerOfTen, BigInteger(std::string(20000, '9')));
+        QCOMPARE(nines % powerOfTen, BigInteger(std::string(10000, '9')));
+    }
+
+    void simdKernels() {
+        SimdLevel initial = simdLevel();
+        QVERIFY(setSimdLevel(SimdLevel::Scalar));
+        QCOMPARE(simdLevel(), SimdLevel::Scalar);
+
+        // 2^(64 * 40) - 1 carries through every lane, the powers of ten differ in various limbs
+        BigInteger allOnes = BigInteger(1);
+        for (int i = 0; i < 40; ++i) {
+            allOnes *= BigInteger(UINT64_MAX) + 1;
+        }
+        allOnes -= 1;
+        BigInteger tensPowers(std::string(SomePowerOfTen) + SomePowerOfTen + SomePowerOfTen + SomePowerOfTen);
+        BigInteger mixed = tensPowers * BigInteger(OneToZero) - allOnes;
+        std::vector<BigInteger> scalarResults {allOnes + 1, allOnes + allOnes, allOnes - tensPowers, tensPowers - allOnes,
+                                               mixed + tensPowers, mixed - allOnes, (allOnes + 1) - 1};
+
+        for (SimdLevel level : {SimdLevel::Avx2, SimdLevel::Avx512}) {
+            if (!setSimdLevel(level)) {
+                continue;
+            }
+            std::vector<BigInteger> results {allOnes + 1, allOnes + allOnes, allOnes - tensPowers, tensPowers - allOnes,
+                                             mixed + tensPowers, mixed - allOnes, (allOnes + 1) - 1};
+            QVERIFY(results == scalarResults);
+            QVERIFY(results.back() == allOnes);
+            QVERIFY(allOnes > allOnes - 1);
+            QVERIFY(mixed - 1 < mixed);
+            QVERIFY(mixed + allOnes > mixed + tensPowers);
+            QVERIFY(!(mixed < mixed));
+        }
+        setSimdLevel(initial);
+    }
+
+    void nativeIntegers() {
+        QCOMPARE(BigInteger(0), BigInteger("0"));
+        QCOMPARE(BigInteger(-1), BigInteger("-1"));
+        QCOMPARE(BigInteger(INT64_MIN).toString(), std::string("-9223372036854775808"));
+        QCOMPARE(BigInteger(UINT64_MAX).toString(), std::string("18446744073709551615"));
+
+        BigInteger counter(-2);
+        QCOMPARE(++counter, BigInteger(-1));
+        QCOMPARE(++counter, BigInteger("0"));
+        QCOMPARE(++counter, BigInteger(1));
+        QCOMPARE(--counter, BigInteger("0"));
+        QCOMPARE(--counter, BigInteger("-1"));
+
+        BigInteger twoWords("340282366920938463463374607431768211455");
+        BigInteger threeWords("340282366920938463463374607431768211456");
+        QCOMPARE(twoWords + 1, threeWords);
+        QCOMPARE(threeWords - 1u, twoWords);
+        QCOMPARE(++BigInteger(twoWords), threeWords);
+        QCOMPARE(--BigInteger(threeWords), twoWords);
+
+        BigInteger oneToZero(OneToZero);
+        QCOMPARE(oneToZero + 10, BigInteger("12345678901234567890123456789012345678901234567890123456789012345678901234567900"));
+        QCOMPARE(10 + oneToZero, oneToZero + 10);
+        QCOMPARE(oneToZero - 90, BigInteger("12345678901234567890123456789012345678901234567890123456789012345678901234567800"));
+        QCOMPARE(90 - oneToZero, -(oneToZero - 90));
+        QCOMPARE(oneToZero * 2, BigInteger(DoubledOneToZero));
+        QCOMPARE(-2 * oneToZero, -BigInteger(DoubledOneToZero));
+        QCOMPARE(oneToZero * 0, BigInteger("0"));
+        QCOMPARE(oneToZero * UINT64_MAX, oneToZero * BigInteger(UINT64_MAX));
+        QCOMPARE(BigInteger(5) - INT64_MIN, BigInteger("9223372036854775813"));
+        QCOMPARE(BigInteger(5) + INT64_MIN, BigInteger("-9223372036854775803"));
+
+        QVERIFY(BigInteger(-7) == -7);
+        QVERIFY(oneToZero > 0);
+        QVERIFY(0 > -oneToZero);
+
+        BigInteger self(OneToZero);
+        self -= self;
+        QCOMPARE(self, BigInteger("0"));
+        self = oneToZero;
+        self += self;
+        QCOMPARE(self, BigInteger(DoubledOneToZero));
+    }
+
+    void memoryResource() {
+        CountingResource counting;
+        {
+            BigInteger counter(0, &counting);
+            for (int i = 0; i < 1000; ++i) {
+                ++counter;
+                counter *= 3;
+            }
+            QCOMPARE(counter.resource(), static_cast<std::pmr::memory_resource*>(&counting));
+            QVERIFY(counting.allocations() > 0);
+
+            BigInteger small(UINT64_MAX, &counting);
+            int allocations = counting.allocations();
+            small += small;
+            QCOMPARE(counting.allocations(), allocations);
+
+            BigInteger copy(counter);
+            QCOMPARE(copy.resource(), counter.resource());
+            BigInteger sum = counter + counter;
+            QCOMPARE(sum.resource(), counter.resource());
+
+            BigInteger outside(counter, std::pmr::get_default_resource());
+            allocations = counting.allocations();
+            outside = counter * counter;
+            QCOMPARE(outside.resource(), std::pmr::get_default_resource());
+            QCOMPARE(outside, copy * copy);
+            QVERIFY(counting.allocations() > allocations);
+        }
+        QCOMPARE(counting.deallocations(), counting.allocations());
+
+        std::pmr::monotonic_buffer_resource arena;
+        BigInteger a(OneToZero, &arena);
+        BigInteger b(ManyNines, &arena);
+        QCOMPARE(a * b / b, BigInteger(OneToZero));
+        QCOMPARE((a + b) % b, BigInteger(OneToZero));
+    }
+
+    void lazySum() {
+        BigInteger oneToZero(OneToZero);
+        BigInteger manyNines(ManyNines);
+        BigInteger one(1);
+        BigInteger minusTen(-10);
+
+        BigInteger sum = lazy(oneToZero) + oneToZero;
+        QCOMPARE(sum, BigInteger(DoubledOneToZero));
+        QCOMPARE(BigInteger(lazy(manyNines) + one), BigInteger(SomePowerOfTen));
+        QCOMPARE(BigInteger(lazy(one) - manyNines - one), -BigInteger(ManyNines));
+        QCOMPARE(BigInteger(lazy(oneToZero) - oneToZero), BigInteger("0"));
+        QCOMPARE(BigInteger(minusTen - lazy(minusTen) + minusTen), BigInteger(-10));
+        QCOMPARE(BigInteger(-(lazy(oneToZero) + oneToZero)), -BigInteger(DoubledOneToZero));
+        QCOMPARE(BigInteger(lazy(manyNines) - (lazy(manyNines) - one)), one);
+
+        BigInteger expected(0);
+        BigInteger terms[20];
+        for (int i = 0; i < 20; ++i) {
+            terms[i] = (i % 3 == 0 ? -manyNines : oneToZero) * (i + 1);
+            expected += terms[i];
+        }
+        BigInteger total = lazy(terms[0]) + terms[1] + terms[2] + terms[3] + terms[4] + terms[5] + terms[6] +
+                           terms[7] + terms[8] + terms[9] + terms[10] + terms[11] + terms[12] + terms[13] +
+                           terms[14] + terms[15] + terms[16] + terms[17] + terms[18] + terms[19];
+        QCOMPARE(total, expected);
+
+        BigInteger target(OneToZero);
+        (lazy(target) + target - manyNines).assignTo(target);
+        QCOMPARE(target, BigInteger(DoubledOneToZero) - manyNines);
+        (lazy(one) - target).assignTo(target);
+        QCOMPARE(target, manyNines - BigInteger(DoubledOneToZero) + 1);
+    }
+
+    void batchOperations() {
+        BigInteger oneToZero(OneToZero);
+        BigInteger manyNines(ManyNines);
+        std::vector<BigInteger> a {1, -5, oneToZero, -manyNines, INT64_MIN, 0, UINT64_MAX};
+        std::vector<BigInteger> b {2, 7, manyNines, -oneToZero, INT64_MIN, 3, UINT64_MAX};
+
+        std::vector<BigInteger> out(a.size());
+        batch::add(a, b, out);
+        for (size_t i = 0; i < a.size(); ++i) {
+            QCOMPARE(out[i], a[i] + b[i]);
+        }
+        batch::subtract(a, b, out);
+        for (size_t i = 0; i < a.size(); ++i) {
+            QCOMPARE(out[i], a[i] - b[i]);
+        }
+        batch::multiply(a, b, out);
+        for (size_t i = 0; i < a.size(); ++i) {
+            QCOMPARE(out[i], a[i] * b[i]);
+        }
+        std::vector<int> order(a.size());
+        batch::compare(a, b, order);
+        QCOMPARE(order, std::vector<int>({-1, -1, -1, -1, 0, -1, 0}));
+
+        std::vector<BigInteger> inPlace = a;
+        batch::subtract(b, inPlace, inPlace);
+        for (size_t i = 0; i < a.size(); ++i) {
+            QCOMPARE(inPlace[i], b[i] - a[i]);
+        }
+        QVERIFY_EXCEPTION_THROWN(batch::add(a, std::vector<BigInteger>(2), out), std::invalid_argument);
+
+        BigInteger expectedSum(0);
+        BigInteger expectedDot(0);
+        for (size_t i = 0; i < a.size(); ++i) {
+            expectedSum += a[i];
+            expectedDot += a[i] * b[i];
+        }
+        QCOMPARE(batch::sum(a), expectedSum);
+        QCOMPARE(batch::dot(a, b), expectedDot);
+        QCOMPARE(batch::sum(std::vector<BigInteger>()), BigInteger("0"));
+        QCOMPARE(batch::sum(batch::Span<const BigInteger>(a.data(), 2)), BigInteger(-4));
+
+        // Outputs keep their limbs, so a batch on outputs of the last one doesn't allocate
+        CountingResource counting;
+        {
+            std::vector<BigInteger> lhs;
+            std::vector<BigInteger> rhs;
+            std::vector<BigInteger> sums;
+            for (int i = 0; i < 1000; ++i) {
+                lhs.emplace_back(manyNines * (i + 1), &counting);
+                rhs.emplace_back(oneToZero * (i + 2), &counting);
+                sums.emplace_back(0, &counting);
+            }
+            batch::add(lhs, rhs, sums);
+            int allocations = counting.allocations();
+            batch::add(lhs, rhs, sums);
+            batch::subtract(lhs, rhs, sums);
+            QCOMPARE(counting.allocations(), allocations);
+            QCOMPARE(sums[999], manyNines * 1000 - oneToZero * 1001);
+        }
+        QCOMPARE(counting.deallocations(), counting.allocations());
+
+        std::vector<BigInteger> column(100000, BigInteger(INT64_MIN));
+        QCOMPARE(batch::sum(column), BigInteger(INT64_MIN) * 100000);
+        QCOMPARE(batch::dot(column, column), BigInteger(INT64_MIN) * INT64_MIN * 100000);
+    }
+
+    void parallelOperations() {
+        std::vector<BigInteger> factors;
+        for (int i = 1; i <= 40000; ++i) {
+            factors.push_back(i % 7 == 0 ? -i : i);
+        }
+
+        setThreadCount(1);
+        QCOMPARE(threadCount(), size_t(1));
+        BigInteger serialProduct = batch::product(factors);
+        BigInteger serialSquare = serialProduct * serialProduct;
+        std::string serialDigits = serialProduct.toString();
+        BigInteger serialSum = batch::sum(factors);
+        BigInteger serialDot = batch::dot(factors, factors);
+
+        setThreadCount(4);
+        QCOMPARE(threadCount(), size_t(4));
+        QCOMPARE(batch::product(factors), serialProduct);
+        QCOMPARE(serialProduct * serialProduct, serialSquare);
+        QCOMPARE(serialProduct.toString(), serialDigits);
+        QCOMPARE(BigInteger(serialDigits), serialProduct);
+        QCOMPARE(batch::sum(factors), serialSum);
+        QCOMPARE(batch::dot(factors, factors), serialDot);
+
+        BigInteger loopProduct(1);
+        for (int i = 1; i <= 200; ++i) {
+            loopProduct *= factors[size_t(i - 1)];
+        }
+        QCOMPARE(batch::product(batch::Span<const BigInteger>(factors.data(), 200)), loopProduct);
+        QCOMPARE(batch::product(std::vector<BigInteger>()), BigInteger(1));
+
+        std::vector<BigInteger> squares(factors.size());
+        batch::multiply(factors, factors, squares);
+        QCOMPARE(batch::sum(squares), serialDot);
+
+        setThreadCount(0);
+        QVERIFY(threadCount() >= 1);
+    }
+
+    void fixedBigInteger() {
+        constexpr auto oneToZero = 12345678901234567890123456789012345678901234567890123456789012345678901234567890_big;
+        constexpr auto manyNines = 999999999999999999999999999999999999999999999999999999999999999999999999999999999_big;
+        static_assert(oneToZero + oneToZero ==
+                      24691357802469135780246913578024691357802469135780246913578024691357802469135780_big, "");
+        static_assert(manyNines - manyNines == 0_big && -manyNines < oneToZero, "");
+        static_assert(FixedBigInteger<128>(0xFFFF'FFFF'FFFF'FFFF_big) * 0xFFFF'FFFF'FFFF'FFFF_big ==
+                      FixedBigInteger<128>("340282366920938463426481119284349108225"), "");
+        static_assert(FixedBigInteger<64>(-7) * 6 + 2 == -40_big, "");
+        static_assert(0xDead'Beef_big == 3735928559_big && 0B1010'0101_big == 165_big && 0x0_big == 0_big, "");
+        static_assert(0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF_big == FixedBigInteger<128>("340282366920938463463374607431768211455"), "");
+
+        QCOMPARE(BigInteger(oneToZero), BigInteger(OneToZero));
+        QCOMPARE(BigInteger(-manyNines), -BigInteger(ManyNines));
+        QCOMPARE(BigInteger(FixedBigInteger<1024>(manyNines) * manyNines), BigInteger(ManyNines) * BigInteger(ManyNines));
+        QCOMPARE(oneToZero.toString(), std::string(OneToZero));
+        QCOMPARE(FixedBigInteger<320>(BigInteger(OneToZero)), oneToZero);
+
+        FixedBigInteger<64> word(UINT64_MAX);
+        QVERIFY_EXCEPTION_THROWN(word += 1, std::overflow_error);
+        QVERIFY_EXCEPTION_THROWN(FixedBigInteger<100>(BigInteger(SomePowerOfTen)), std::overflow_error);
+        QVERIFY_EXCEPTION_THROWN(FixedBigInteger<128>("12a"), std::runtime_error);
+    }
+
+    void fixedInteger() {
+        BigInteger twoTo64 = BigInteger(UINT64_MAX) + 1;
+        BigInteger twoTo256 = twoTo64 * twoTo64 * twoTo64 * twoTo64;
+        BigInteger a = BigInteger(OneToZero) / 1000;
+        BigInteger b = -BigInteger(ManyNines) / 100000;
+        int256 x = a;
+        int256 y = b;
+        QCOMPARE(BigInteger(x + y), a + b);
+        QCOMPARE(BigInteger(x - y), a - b);
+        QCOMPARE(BigInteger(x / y), a / b);
+        QCOMPARE(BigInteger(x % y), a % b);
+        QCOMPARE(BigInteger(x / 1000 * 1000 + x % 1000), a);
+        QCOMPARE(x * y, int256(a * b));
+        QCOMPARE(BigInteger(y >> 64), (b - twoTo64 + 1) / twoTo64);
+        QCOMPARE((x << 64) >> 64, int256(a * twoTo64) >> 64);
+        QVERIFY(y < x && -x < y && x != y);
+        QCOMPARE(x.toString(), a.toString());
+        QCOMPARE(b + x, a + b);
+        QCOMPARE(x + b, a + b);
+        QCOMPARE(x - b, a - b);
+        QCOMPARE(b * x, a * b);
+        QCOMPARE(twoTo256 / x, twoTo256 / a);
+        QCOMPARE(x % BigInteger(1000), a % 1000);
+        QVERIFY(a == x && x == a && b != x && x != b);
+        QVERIFY(x < twoTo256 && b < x && x <= a && a >= x && twoTo256 > x && x > b);
+        QCOMPARE(x + 1, int256(a + 1));
+
+        // The example of the README
+        uint256 hash = BigInteger("115792089237316195423570985008687907853269984665640564039457584007908834671663");
+        hash = hash * 31 + 7;
+        UInt<256, Overflow::Check> checked = hash;
+        QCOMPARE(BigInteger(checked), BigInteger(hash));
+        QVERIFY_EXCEPTION_THROWN(BigInteger(checked * 2), std::overflow_error);
+        BigInteger value = checked / 2;
+        BigInteger sum = value + hash;
+        QCOMPARE(sum, BigInteger(hash) / 2 + BigInteger(hash));
+        uint256 wrapped = checked;
+        QCOMPARE(wrapped, hash);
+
+        uint256 max = uint256(-1);
+        QCOMPARE(BigInteger(max), twoTo256 - 1);
+        QCOMPARE(max + 1, uint256(0));
+        QCOMPARE(BigInteger(uint256(a) * uint256(a)), a * a % twoTo256);
+        QCOMPARE(uint512(a) * uint512(a), uint512(a * a));
+        QCOMPARE(int128(max), int128(-1));
+
+        UInt<256, Overflow::Check> checkedMax(twoTo256 - 1);
+        QVERIFY_EXCEPTION_THROWN(checkedMax + 1, std::overflow_error);
+        QVERIFY_EXCEPTION_THROWN(checkedMax * 2, std::overflow_error);
+        QVERIFY_EXCEPTION_THROWN((UInt<256, Overflow::Check>(twoTo256)), std::overflow_error);
+        QVERIFY_EXCEPTION_THROWN((Int<128, Overflow::Check>(-1) << 127) / -1, std::overflow_error);
+        QVERIFY_EXCEPTION_THROWN(x / 0, std::domain_error);
+    }
+
+    void modularArithmetic() {
+        ModContext rsa(3233);
+        QCOMPARE(rsa.powmod(65, 17), BigInteger(2790));
+        QCOMPARE(rsa.powmod(2790, 2753), BigInteger(65));
+        QCOMPARE(rsa.invmod(17), BigInteger(2092));
+
+        BigInteger mersenne = BigInteger("170141183460469231731687303715884105727");
+        ModContext prime(mersenne);
+        QVERIFY(prime.isMontgomery());
+        QCOMPARE(prime.powmod(BigInteger(OneToZero), mersenne - 1), BigInteger(1));
+        QCOMPARE(prime.mulmod(prime.invmod(BigInteger(OneToZero)), BigInteger(OneToZero)), BigInteger(1));
+        QCOMPARE(prime.powmod(3, -1), prime.invmod(3));
+        QCOMPARE(prime.reduce(-BigInteger(ManyNines)), mersenne - BigInteger(ManyNines) % mersenne);
+
+        ModContext::Residue x = prime.toResidue(BigInteger(OneToZero));
+        ModContext::Residue y = prime.toResidue(BigInteger(ManyNines));
+        QCOMPARE(prime.fromResidue(prime.multiply(x, y)), BigInteger(OneToZero) * BigInteger(ManyNines) % mersenne);
+        QCOMPARE(prime.fromResidue(prime.subtract(prime.add(x, y), y)), BigInteger(OneToZero) % mersenne);
+        QVERIFY(prime.pow(x, 10) == prime.square(prime.multiply(prime.square(prime.square(x)), x)));
+
+        BigInteger power = BigInteger(SomePowerOfTen);
+        ModContext even(power);
+        QVERIFY(!even.isMontgomery());
+        QCOMPARE(even.powmod(7, 4), BigInteger(2401));
+        QCOMPARE(even.powmod(7, power), BigInteger(1));
+        QCOMPARE(even.mulmod(BigInteger(ManyNines), BigInteger(ManyNines)), BigInteger(1));
+
+        QVERIFY_EXCEPTION_THROWN(even.invmod(2), std::domain_error);
+        QVERIFY_EXCEPTION_THROWN(ModContext(0), std::domain_error);
+    }
+
+    void textConversion() {
+        std::string_view text(OneToZero);
+        QCOMPARE(BigInteger(text.substr(0, 10)), BigInteger(1234567890));
+
+        BigInteger value;
+        const char* digits = "-00123abc";
+        std::from_chars_result parsed = from_chars(digits, digits + 9, value);
+        QCOMPARE(value, BigInteger(-123));
+        QVERIFY(parsed.ptr == digits + 6);
+        QVERIFY(from_chars(digits + 6, digits + 9, value).ec == std::errc::invalid_argument);
+        QCOMPARE(value, BigInteger(-123));
+
+        BigInteger manyNines(ManyNines);
+        std::string buffer(manyNines.decimalLengthBound(), ' ');
+        std::to_chars_result printed = to_chars(&buffer[0], &buffer[0] + buffer.size(), -manyNines);
+        QCOMPARE(std::string(buffer.data(), printed.ptr), std::string("-") + ManyNines);
+        QVERIFY(to_chars(&buffer[0], &buffer[0] + 81, -manyNines).ec == std::errc::value_too_large);
+
+        // Long enough to be read and written in blocks
+        std::string longDigits;
+        for (int i = 0; i < 4000; ++i) {
+            longDigits += OneToZero;
+        }
+        std::stringstream stream(" -" + longDigits + " +" + ManyNines + " x");
+        BigInteger first;
+        BigInteger second;
+        stream >> first >> second;
+        QCOMPARE(first, -BigInteger(longDigits));
+        QCOMPARE(second, manyNines);
+        QVERIFY(!(stream >> value));
+        QCOMPARE(value, BigInteger(-123));
+
+        std::ostringstream out;
+        out << first << ' ' << std::setw(5) << std::setfill('_') << BigInteger(12);
+        QCOMPARE(out.str(), "-" + longDigits + " ___12");
+    }
+
+    void bitwiseOperations() {
+        BigInteger manyNines(ManyNines);
+        QCOMPARE(BigInteger(12) & BigInteger(10), BigInteger(8));
+        QCOMPARE(BigInteger(-12) & BigInteger(10), BigInteger(0));
+        QCOMPARE(BigInteger(-12) | BigInteger(10), BigInteger(-2));
+        QCOMPARE(BigInteger(-12) ^ BigInteger(-10), BigInteger(2));
+        QCOMPARE(~manyNines, -manyNines - 1);
+        QCOMPARE(manyNines & -manyNines, BigInteger(1));
+        BigInteger oneToZero(OneToZero);
+        QCOMPARE(-oneToZero & ((BigInteger(1) << 100) - 1), BigInteger("174808325104175149795915134254"));
+        QCOMPARE(-oneToZero | BigInteger(0xFFFF),
+                 BigInteger("-12345678901234567890123456789012345678901234567890123456789012345678901234565121"));
+        QCOMPARE((manyNines | -manyNines), BigInteger(-1));
+        QCOMPARE(manyNines ^ manyNines, BigInteger(0));
+
+        QCOMPARE(BigInteger(1) << 200, BigInteger("1606938044258990275541962092341162602522202993782792835301376"));
+        QCOMPARE((manyNines << 77) >> 77, manyNines);
+        QCOMPARE(BigInteger(-7) >> 1, BigInteger(-4));
+        QCOMPARE(-manyNines >> 1000, BigInteger(-1));
+        QCOMPARE(manyNines >> 1000, BigInteger(0));
+
+        BigInteger power(SomePowerOfTen);
+        QCOMPARE(power.bitLength(), std::size_t(270));
+        QCOMPARE(power.countTrailingZeroBits(), std::size_t(81));
+        QCOMPARE((-power).countTrailingZeroBits(), std::size_t(81));
+        QCOMPARE(BigInteger(255).popcount(), std::size_t(8));
+        QCOMPARE(BigInteger(-255).popcount(), std::size_t(8));
+        QCOMPARE(BigInteger(0).bitLength(), std::size_t(0));
+        QVERIFY(power.testBit(81));
+        QVERIFY(!power.testBit(80));
+        QVERIFY(!(-power).testBit(80));
+        QVERIFY((-power).testBit(82));
+        QVERIFY(!(-power).testBit(83));
+        QVERIFY((-power).testBit(100000));
+        QVERIFY_EXCEPTION_THROWN(BigInteger(0).countTrailingZeroBits(), std::domain_error);
+    }
+
+    void containerKeys() {
+        BigInteger oneToZero(OneToZero);
+        QCOMPARE(threeWayCompare(oneToZero, -oneToZero), 1);
+        QCOMPARE(threeWayCompare(-oneToZero, oneToZero), -1);
+        QCOMPARE(threeWayCompare(oneToZero, BigInteger(DoubledOneToZero)), -1);
+        QCOMPARE(threeWayCompare(-oneToZero, -BigInteger(DoubledOneToZero)), 1);
+        QCOMPARE(threeWayCompare(oneToZero + 1, oneToZero), 1);
+        QCOMPARE(threeWayCompare(oneToZero, BigInteger(OneToZero)), 0);
+        QCOMPARE(threeWayCompare(BigInteger(-5), -5), 0);
+        QCOMPARE(threeWayCompare(BigInteger(-5), 3), -1);
+        QCOMPARE(threeWayCompare(BigInteger(0), -1), 1);
+        QCOMPARE(threeWayCompare(oneToZero, UINT64_MAX), 1);
+        QCOMPARE(threeWayCompare(BigInteger(UINT64_MAX), UINT64_MAX), 0);
+
+        for (const BigInteger& value : {BigInteger(0), BigInteger(-7), BigInteger(INT64_MIN), BigInteger(UINT64_MAX)}) {
+            QCOMPARE(BigIntegerHash()(value), std::hash<BigInteger>()(value));
+            QCOMPARE(BigIntegerHash()(value.toString()), value.hash());
+        }
+        QCOMPARE(BigInteger::hashOf(-7), BigInteger(-7).hash());
+        QCOMPARE(BigInteger::hashOf(INT64_MIN), BigInteger(INT64_MIN).hash());
+        QCOMPARE(BigInteger::hashOf(UINT64_MAX), BigInteger(UINT64_MAX).hash());
+        QVERIFY(oneToZero.hash() != (-oneToZero).hash());
+        QVERIFY(oneToZero.hash() != (oneToZero + 1).hash());
+
+        std::unordered_map<BigInteger, int> ids;
+        std::map<BigInteger, int, BigIntegerLess> ordered;
+        for (int i = 0; i < 100; ++i) {
+            ids[oneToZero * i] = i;
+            ordered[BigInteger(i) - 50] = i;
+        }
+        QCOMPARE(ids.size(), std::size_t(100));
+        QCOMPARE(ids.at(oneToZero * 42), 42);
+        QCOMPARE(ordered.find(-8)->second, 42);
+        QCOMPARE(ordered.find(std::string_view("-0008"))->second, 42);
+        QVERIFY(ordered.find(std::int64_t(50)) == ordered.end());
+        QVERIFY(BigIntegerEqual()(BigInteger(-8), std::string_view("-8")));
+        QVERIFY(BigIntegerEqual()(-8, BigInteger(-8)));
+    }
+
+    void numberTheory() {
+        BigInteger oneToZero(OneToZero);
+        BigInteger manyNines(ManyNines);
+        BigInteger common = BigInteger(SomePowerOfTen) + 7;
+        QCOMPARE(gcd(BigInteger(84), BigInteger(-36)), BigInteger(12));
+        QCOMPARE(gcd(BigInteger(0), BigInteger(-5)), BigInteger(5));
+        QCOMPARE(gcd(BigInteger(0), BigInteger(0)), BigInteger(0));
+        QCOMPARE(gcd(oneToZero * common, manyNines * common), gcd(oneToZero, manyNines) * common);
+        QCOMPARE(gcd(oneToZero, manyNines), BigInteger(9));
+        QCOMPARE(lcm(BigInteger(-4), BigInteger(6)), BigInteger(12));
+        QCOMPARE(lcm(oneToZero, BigInteger(0)), BigInteger(0));
+        QCOMPARE(lcm(oneToZero, manyNines), oneToZero / 9 * manyNines);
+
+        ExtendedGcd bezout = extendedGcd(-oneToZero * common, manyNines * common);
+        QCOMPARE(bezout.gcd, 9 * common);
+        QCOMPARE(-oneToZero * common * bezout.x + manyNines * common * bezout.y, bezout.gcd);
+        bezout = extendedGcd(BigInteger(240), BigInteger(46));
+        QCOMPARE(bezout.gcd, BigInteger(2));
+        QCOMPARE(bezout.x, BigInteger(-9));
+        QCOMPARE(bezout.y, BigInteger(47));
+
+        QCOMPARE(isqrt(BigInteger(0)), BigInteger(0));
+        QCOMPARE(isqrt(BigInteger(UINT64_MAX)), BigInteger(UINT32_MAX));
+        QCOMPARE(isqrt(oneToZero * oneToZero), oneToZero);
+        QCOMPARE(isqrt(oneToZero * oneToZero - 1), oneToZero - 1);
+        QCOMPARE(isqrt(BigInteger(SomePowerOfTen) * 10), pow(BigInteger(10), 41));
+        QVERIFY_EXCEPTION_THROWN(isqrt(BigInteger(-1)), std::domain_error);
+
+        QCOMPARE(pow(BigInteger(10), 81), BigInteger(SomePowerOfTen));
+        QCOMPARE(pow(BigInteger(-3), 5), BigInteger(-243));
+        QCOMPARE(pow(BigInteger(0), 0), BigInteger(1));
+        QCOMPARE(pow(BigInteger(2), 200), BigInteger(1) << 200);
+
+        QCOMPARE(jacobiSymbol(1001, 9907), -1);
+        QCOMPARE(jacobiSymbol(19, 45), 1);
+        QCOMPARE(jacobiSymbol(8, 21), -1);
+        QCOMPARE(jacobiSymbol(-6, 21), 0);
+        QVERIFY_EXCEPTION_THROWN(jacobiSymbol(3, 10), std::domain_error);
+
+        QVERIFY(!isProbablePrime(BigInteger(1)));
+        QVERIFY(isProbablePrime(BigInteger(2)));
+        QVERIFY(isProbablePrime(BigInteger(997)));
+        QVERIFY(!isProbablePrime(BigInteger(-7)));
+        QVERIFY(!isProbablePrime(BigInteger(561)));
+        QVERIFY(isProbablePrime(BigInteger(UINT64_MAX) - 58));
+        // Strong pseudoprimes to base 2 and a strong Lucas pseudoprime
+        QVERIFY(!isProbablePrime(BigInteger(3215031751)));
+        QVERIFY(!isProbablePrime(BigInteger("3825123056546413051")));
+        QVERIFY(!isProbablePrime(BigInteger(5459)));
+        BigInteger mersenne127 = (BigInteger(1) << 127) - 1;
+        BigInteger mersenne521 = (BigInteger(1) << 521) - 1;
+        QVERIFY(isProbablePrime(mersenne127));
+        QVERIFY(isProbablePrime(mersenne521, 8));
+        QVERIFY(!isProbablePrime(mersenne127 * mersenne521));
+        QVERIFY(!isProbablePrime(mersenne521 * mersenne521));
+    }
+
+    void sharedCopies() {
+        CountingResource counting;
+        {
+            BigInteger original(OneToZero, &counting);
+            int allocations = counting.allocations();
+            BigInteger copy(original);
+            std::vector<BigInteger> copies(8, original);
+            // Without SharedLimbs every copy has a buffer of its own
+            allocations += SharedLimbs ? 0 : 9;
+            QCOMPARE(counting.allocations(), allocations);
+            QCOMPARE(copy, original);
+
+            copy += 1;
+            BigInteger negated = -original;
+            QCOMPARE(counting.allocations(), allocations + 1);
+            QCOMPARE(copy - 1, original);
+            QCOMPARE(-negated, original);
+            QCOMPARE(original, BigInteger(OneToZero));
+
+            // Every thread writes through its own copy of the shared limbs
+            std::vector<std::thread> threads;
+            for (std::size_t i = 0; i < copies.size(); ++i) {
+                threads.emplace_back([&copies, i] {
+                    for (int j = 0; j < 100; ++j) {
+                        BigInteger reader(copies[i]);
+                        copies[i] += reader;
+                    }
+                });
+            }
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+            for (const BigInteger& shifted : copies) {
+                QCOMPARE(shifted, original << 100);
+            }
+            QCOMPARE(original, BigInteger(OneToZero));
+
+            original = copies.front();
+            copies.clear();
+            QCOMPARE(original, BigInteger(OneToZero) << 100);
+            original -= 1;
+            QCOMPARE(original + BigInteger(1), BigInteger(OneToZero) << 100);
+        }
+        QCOMPARE(counting.deallocations(), counting.allocations());
+    }
+
+    void multiplyAccumulate() {
+        BigInteger oneToZero(OneToZero);
+        BigInteger manyNines(ManyNines);
+        BigInteger accumulator(5);
+        accumulator.addMultiply(oneToZero, manyNines);
+        QCOMPARE(accumulator, oneToZero * manyNines + 5);
+        accumulator.subtractMultiply(oneToZero, manyNines);
+        QCOMPARE(accumulator, BigInteger(5));
+        accumulator.subtractMultiply(oneToZero, -3);
+        QCOMPARE(accumulator, oneToZero * 3 + 5);
+        accumulator.addMultiply(oneToZero, 3);
+        QCOMPARE(accumulator, oneToZero * 6 + 5);
+
+        BigInteger self = oneToZero;
+        self.addMultiply(self, self);
+        QCOMPARE(self, oneToZero + oneToZero * oneToZero);
+        self = oneToZero;
+        self.subtractMultiply(self, 2);
+        QCOMPARE(self, -oneToZero);
+        QCOMPARE(fma(oneToZero, -manyNines, BigInteger(7)), BigInteger(7) - oneToZero * manyNines);
+
+        CountingResource counting;
+        BigInteger sum(0, &counting);
+        sum.reserve(1024);
+        QVERIFY(sum.capacity() >= 1024);
+        int allocations = counting.allocations();
+        for (int i = 0; i < 100; ++i) {
+            sum.addMultiply(oneToZero, manyNines);
+            sum.subtractMultiply(manyNines, i);
+        }
+        QCOMPARE(counting.allocations(), allocations);
+        QCOMPARE(sum, oneToZero * manyNines * 100 - manyNines * 4950);
+
+        // Products longer than ProductStackLimbs go to the buffer of the thread, not to the resource
+        BigInteger longFactor = (BigInteger(1) << 5000) - 1;
+        QVERIFY(longFactor.bitLength() + oneToZero.bitLength() > 4096);
+        BigInteger longSum(0, &counting);
+        longSum.reserve(20000);
+        BigInteger longProduct = fma(longFactor, longFactor, BigInteger(1));
+        allocations = counting.allocations();
+        for (int i = 0; i < 10; ++i) {
+            longSum.addMultiply(longFactor, oneToZero);
+            longSum.subtractMultiply(longFactor, longFactor);
+        }
+        QCOMPARE(counting.allocations(), allocations);
+        QCOMPARE(longSum, (longFactor * oneToZero - longFactor * longFactor) * 10);
+        QCOMPARE(longProduct, longFactor * longFactor + 1);
+    }
+
+    void instrumentation() {
+        QCOMPARE(std::string(operationName(InstrumentedOperation::Multiply)), std::string("multiply"));
+        QCOMPARE(std::string(operationName(InstrumentedOperation::ToString)), std::string("toString"));
+
+        resetInstrumentation();
+        BigInteger a("123456789012345678901234567890123456789012345678901234567890");
+        BigInteger b = a;
+        b += 1;
+        BigInteger product = a * b;
+        BigInteger quotient = product / a;
+        QVERIFY(quotient > a);
+        QCOMPARE(quotient.toString(), b.toString());
+        InstrumentationSnapshot snapshot = instrumentationSnapshot();
+
+        if (snapshot.enabled) {
+            QVERIFY(snapshot[InstrumentedOperation::Parse].calls >= 1);
+            QVERIFY(snapshot[InstrumentedOperation::Add].calls >= 1);
+            QVERIFY(snapshot[InstrumentedOperation::Multiply].calls >= 1);
+            QVERIFY(snapshot[InstrumentedOperation::Divide].calls >= 1);
+            QVERIFY(snapshot[InstrumentedOperation::Compare].calls >= 1);
+            QCOMPARE(snapshot[InstrumentedOperation::ToString].calls, std::uint64_t(2));
+            // 200 bits are 4 or 7 limbs, both in the bucket of 4 to 7 limbs
+            QCOMPARE(snapshot[InstrumentedOperation::Multiply].lengths[3], std::uint64_t(1));
+            QCOMPARE(snapshot.copiesOnWrite, std::uint64_t(1));
+            QVERIFY(snapshot.allocations >= 3);
+            QVERIFY(snapshot.allocatedBytes > 0);
+        }
+        else {
+            QCOMPARE(snapshot[InstrumentedOperation::Multiply].calls, std::uint64_t(0));
+            QCOMPARE(snapshot.allocations, std::uint64_t(0));
+        }
+
+        std::string json = snapshot.toJson();
+        QVERIFY(json.find("\"operations\": {") != std::string::npos);
+        QVERIFY(json.find("\"divide\": {\"calls\": ") != std::string::npos);
+        QVERIFY(json.find("\"copiesOnWrite\": ") != std::string::npos);
+        QVERIFY(json.find(snapshot.enabled ? "\"enabled\": true" : "\"enabled\": false") == 1);
+
+        resetInstrumentation();
+        QCOMPARE(instrumentationSnapshot()[InstrumentedOperation::Multiply].calls, std::uint64_t(0));
+    }
+
+    void decimal() {
+        QCOMPARE(Decimal("123.4500").toString(), std::string("123.4500"));
+        QCOMPARE(Decimal("123.4500").scale(), std::uint32_t(4));
+        QCOMPARE(Decimal("-0.05").toString(), std::string("-0.05"));
+        QCOMPARE(Decimal("+7").toString(), std::string("7"));
+        QCOMPARE(Decimal("-0.0").toString(), std::string("0.0"));
+        QCOMPARE(Decimal(BigInteger(12345), 2).toString(), std::string("123.45"));
+        QCOMPARE(Decimal(BigInteger(-5), 3).toString(), std::string("-0.005"));
+        for (const char* text : {"", "-", "1.", ".5", "1.2.3", "--1", "+-1", "1e5", "1.-5", "12a"}) {
+            QVERIFY_EXCEPTION_THROWN(Decimal{std::string_view(text)}, std::runtime_error);
+        }
+
+        QCOMPARE((Decimal("1.5") + Decimal("2.25")).toString(), std::string("3.75"));
+        QCOMPARE((Decimal(1) - Decimal("0.001")).toString(), std::string("0.999"));
+        QCOMPARE((Decimal("0.001") - 1).toString(), std::string("-0.999"));
+        QCOMPARE((Decimal("1.5") * Decimal("1.5")).toString(), std::string("2.25"));
+        QCOMPARE((Decimal("-0.1") * Decimal("0.20")).toString(), std::string("-0.020"));
+        QCOMPARE((Decimal("1000.00") * Decimal("0.035")).rescale(2).toString(), std::string("35.00"));
+        QCOMPARE(Decimal("1.5") + 1, Decimal("2.5"));
+        QCOMPARE(-Decimal("1.5"), Decimal("-1.50"));
+        Decimal self("0.5");
+        self += self;
+        self *= self;
+        QCOMPARE(self.toString(), std::string("1.00"));
+
+        // Products of coefficients of up to 64 bits are native, longer ones aren't
+        BigInteger word("18446744073709551615");
+        QCOMPARE((Decimal(word, 3) * Decimal(-word, 2)).coefficient(), -word * word);
+        QCOMPARE((Decimal(word * word, 3) * Decimal(word, 2)).coefficient(), word * word * word);
+        QCOMPARE(Decimal(BigInteger(1) << 200, 10) + Decimal(BigInteger(1), 40),
+                 Decimal((BigInteger(1) << 200) * pow(BigInteger(10), 30) + 1, 40));
+
+        QVERIFY(Decimal("1.50") == Decimal("1.5"));
+        QVERIFY(Decimal("-1.1") < Decimal("-1.01"));
+        QVERIFY(Decimal("0.000") == Decimal(0));
+        QVERIFY(Decimal("-0.001") < Decimal(0));
+        QVERIFY(Decimal("2") > Decimal("1.999999999999999999999999"));
+        QCOMPARE(apmath::compare(Decimal("10"), Decimal("9.99")), 1);
+
+        const char* values[] = {"2.5", "-2.5", "1.5", "2.51", "-2.49", "0.5", "-0.5", "2.0"};
+        const std::pair<Rounding, std::vector<int>> expected[] = {
+            {Rounding::HalfEven, {2, -2, 2, 3, -2, 0, 0, 2}},
+            {Rounding::HalfUp, {3, -3, 2, 3, -2, 1, -1, 2}},
+            {Rounding::HalfDown, {2, -2, 1, 3, -2, 0, 0, 2}},
+            {Rounding::Down, {2, -2, 1, 2, -2, 0, 0, 2}},
+            {Rounding::Up, {3, -3, 2, 3, -3, 1, -1, 2}},
+            {Rounding::Floor, {2, -3, 1, 2, -3, 0, -1, 2}},
+            {Rounding::Ceiling, {3, -2, 2, 3, -2, 1, 0, 2}},
+        };
+        const BigInteger longScale = pow(BigInteger(10), 40);
+        for (const auto& mode : expected) {
+            for (std::size_t i = 0; i < mode.second.size(); ++i) {
+                Decimal value(values[i]);
+                QCOMPARE(value.rescaled(0, mode.first), Decimal(mode.second[i]));
+                // Coefficients longer than 128 bits are divided by cached powers of ten
+                Decimal longValue(value.coefficient() * longScale, value.scale() + 40);
+                QCOMPARE(longValue.rescaled(0, mode.first), Decimal(mode.second[i]));
+            }
+        }
+        QCOMPARE(Decimal("12345678901234567890123.5").rescaled(0).toString(), std::string("12345678901234567890124"));
+        QCOMPARE(Decimal("-12345678901234567890122.5").rescaled(0).toString(), std::string("-12345678901234567890122"));
+        QCOMPARE(Decimal(BigInteger(1), 1000).rescaled(0, Rounding::Up), Decimal(1));
+        QCOMPARE(Decimal(BigInteger(-1), 1000).rescaled(0, Rounding::Ceiling), Decimal(0));
+        QCOMPARE(Decimal(BigInteger(-1), 1000).rescaled(2, Rounding::Floor).toString(), std::string("-0.01"));
+        QCOMPARE(Decimal("1.5").rescaled(3).toString(), std::string("1.500"));
+        QCOMPARE(Decimal("1.5").rescaled(300).rescaled(1), Decimal("1.5"));
+
+        QCOMPARE(Decimal("1.2300").normalize().toString(), std::string("1.23"));
+        QCOMPARE(Decimal("100.000").normalize().toString(), std::string("100"));
+        QCOMPARE(Decimal("0.000").normalize().scale(), std::uint32_t(0));
+        QCOMPARE(Decimal(pow(BigInteger(10), 50), 30).normalize().toString(), std::string("100000000000000000000"));
+        QCOMPARE(Decimal(pow(BigInteger(10), 50) * 3, 70).normalize().toString(), std::string("0.00000000000000000003"));
+
+        QCOMPARE(apmath::divide(Decimal(1), Decimal(3), 4).toString(), std::string("0.3333"));
+        QCOMPARE(apmath::divide(Decimal(2), Decimal(3), 2).toString(), std::string("0.67"));
+        QCOMPARE(apmath::divide(Decimal("-1.00"), Decimal(8), 2).toString(), std::string("-0.12"));
+        QCOMPARE(apmath::divide(Decimal("-1.00"), Decimal(8), 2, Rounding::HalfUp).toString(), std::string("-0.13"));
+        QCOMPARE(apmath::divide(Decimal("100"), Decimal("0.03"), 1).toString(), std::string("3333.3"));
+        QCOMPARE(apmath::divide(Decimal("1.23456"), Decimal("-2"), 1).toString(), std::string("-0.6"));
+        QVERIFY_EXCEPTION_THROWN(apmath::divide(Decimal(1), Decimal("0.00"), 2), std::domain_error);
+
+        std::ostringstream stream;
+        stream << Decimal("-12.340");
+        QCOMPARE(stream.str(), std::string("-12.340"));
+    }
+
+    void accumulator() {
+        Accumulator empty;
+        QCOMPARE(empty.value(), BigInteger(0));
+
+        std::vector<BigInteger> values;
+        BigInteger expected;
+        Accumulator sum;
+        for (int i = 0; i < 300; ++i) {
+            BigInteger value = (BigInteger(1) << (i * 37 % 500)) * (i * 7919 + 1) - i;
+            values.push_back(i % 3 == 0 ? -value : value);
+            sum += values.back();
+            expected += values.back();
+        }
+        QCOMPARE(sum.value(), expected);
+        QCOMPARE(sum.value(), expected);
+        for (const BigInteger& value : values) {
+            sum -= value;
+        }
+        QCOMPARE(sum.value(), BigInteger(0));
+
+        // Negative sums and limbs with all bits set
+        const BigInteger ones = (BigInteger(1) << 256) - 1;
+        sum.clear();
+        for (int i = 0; i < 1000; ++i) {
+            sum -= ones;
+        }
+        QCOMPARE(sum.value(), ones * -1000);
+        sum += ones * 999;
+        BigInteger target = ones * ones;
+        sum.assignTo(target);
+        QCOMPARE(target, -ones);
+
+        sum.clear();
+        sum.reserve(128);
+        sum += std::numeric_limits<std::uint64_t>::max();
+        sum += std::numeric_limits<std::int64_t>::min();
+        sum -= std::numeric_limits<std::int64_t>::min();
+        sum += -5;
+        sum -= 'a';
+        QCOMPARE(sum.value(), BigInteger(std::numeric_limits<std::uint64_t>::max()) - 5 - 'a');
+
+        // Sums of threads are merged
+        std::vector<Accumulator> parts(4);
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < parts.size(); ++t) {
+            threads.emplace_back([&, t]() {
+                for (std::size_t i = t; i < values.size(); i += parts.size()) {
+                    parts[t] += values[i];
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        Accumulator total;
+        total += 1;
+        for (const Accumulator& part : parts) {
+            total.merge(part);
+        }
+        QCOMPARE(total.value(), expected + 1);
+        Accumulator twice = parts[0];
+        twice.merge(twice);
+        QCOMPARE(twice.value(), parts[0].value() * 2);
+    }
+
+    void serialization() {
+        std::vector<BigInteger> values = {BigInteger(0), BigInteger(12345), BigInteger(-1),
+                                          BigInteger(ManyNines), -BigInteger(OneToZero)};
+        std::vector<std::uint8_t> words;
+        std::vector<std::uint8_t> varint;
+        for (const auto& value : values) {
+            serialize(value, words);
+            serialize(value, varint, Encoding::Varint);
+        }
+        // Zero is a header word, 12345 is a header word and one little-endian word
+        QCOMPARE(words[8], std::uint8_t(2));
+        QCOMPARE(words[16], std::uint8_t(0x39));
+        QCOMPARE(words[17], std::uint8_t(0x30));
+        QCOMPARE(varint[1], std::uint8_t(4));  // 12345 takes a header byte and two bytes
+        std::size_t wordsOffset = 0;
+        std::size_t varintOffset = 0;
+        for (const auto& value : values) {
+            BigInteger read;
+            wordsOffset += deserialize(words.data() + wordsOffset, words.size() - wordsOffset, read);
+            QCOMPARE(read, value);
+            varintOffset += deserialize(varint.data() + varintOffset, varint.size() - varintOffset, read,
+                                        Encoding::Varint);
+            QCOMPARE(read, value);
+        }
+        QCOMPARE(wordsOffset, words.size());
+        QCOMPARE(varintOffset, varint.size());
+        BigInteger read;
+        QVERIFY_EXCEPTION_THROWN(deserialize(words.data(), 7, read), std::runtime_error);
+        QVERIFY_EXCEPTION_THROWN(deserialize(varint.data() + 1, 2, read, Encoding::Varint), std::runtime_error);
+
+        std::string path = (std::filesystem::temp_directory_path() / "big-number-test.snapshot").string();
+        {
+            SnapshotWriter writer(path);
+            for (const auto& value : values) {
+                writer.write(value);
+            }
+            writer.close();
+        }
+        {
+            SnapshotFile snapshot(path);
+            QCOMPARE(snapshot.size(), values.size());
+            std::size_t i = 0;
+            for (BigIntegerView view : snapshot) {
+                QCOMPARE(view.isNegative(), values[i] < 0);
+                QCOMPARE(view.toBigInteger(), values[i]);
+                ++i;
+            }
+            QCOMPARE(i, values.size());
+        }
+        std::filesystem::remove(path);
+    }
+
     void implicitConversion() {
         QCOMPARE(BigInteger(ManyNines) +
                  BigInteger(std::string("-") + ManyNinesAndEight),
@@ -0,0 +1,109 @@
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <utility>
+
+#include <BigInteger.hpp>
+#include <Tuning.hpp>
+
+// Finds multiplication thresholds for the host the same way as GMP's tuneup:
+// for every size the next algorithm applied at the top level only (the current one below)
+// is raced against the current algorithm, the threshold is the first size the next one wins.
+
+namespace {
+using apmath::BigInteger;
+using apmath::MultiplicationThresholds;
+
+constexpr std::size_t Never = std::numeric_limits<std::size_t>::max();
+constexpr std::size_t DigitsPerLimb = sizeof(apmath::Limb) == 8 ? 19 : 9;
+// The next algorithm has to win at this many consecutive sizes to set the threshold
+constexpr int ConfirmingSizes = 3;
+
+std::mt19937_64 generator(20190101);
+
+BigInteger randomNumber(std::size_t limbs) {
+    std::string digits(limbs * DigitsPerLimb, '0');
+    for (auto& digit: digits) {
+        digit = static_cast<char>('0' + generator() % 10);
+    }
+    digits[0] = '9';
+    return BigInteger(digits);
+}
+
+// Seconds per multiplication of a and b with the given thresholds
+double measureOnce(const BigInteger& a, const BigInteger& b, const MultiplicationThresholds& thresholds) {
+    using Clock = std::chrono::steady_clock;
+    apmath::setMultiplicationThresholds(thresholds);
+    std::size_t repeats = 0;
+    auto start = Clock::now();
+    std::chrono::duration<double> elapsed(0);
+    do {
+        BigInteger product = a * b;
+        ++repeats;
+        elapsed = Clock::now() - start;
+    } while (elapsed.count() < 0.01);
+    return elapsed.count() / static_cast<double>(repeats);
+}
+
+// The best of several interleaved rounds, so both candidates see the same machine load
+std::pair<double, double> race(std::size_t limbs, const MultiplicationThresholds& current,
+                               const MultiplicationThresholds& next) {
+    BigInteger a = randomNumber(limbs);
+    BigInteger b = randomNumber(limbs);
+    double currentTime = std::numeric_limits<double>::max();
+    double nextTime = std::numeric_limits<double>::max();
+    for (int round = 0; round < 5; ++round) {
+        currentTime = std::min(currentTime, measureOnce(a, b, current));
+        nextTime = std::min(nextTime, measureOnce(a, b, next));
+    }
+    return std::make_pair(currentTime, nextTime);
+}
+
+// Returns fallback when the next algorithm never wins up to the given size
+std::size_t findThreshold(const char* name, std::size_t from, std::size_t to, std::size_t fallback,
+                          const std::function<MultiplicationThresholds(std::size_t)>& next,
+                          const MultiplicationThresholds& current) {
+    std::size_t firstWin = Never;
+    int wins = 0;
+    for (std::size_t limbs = from; limbs <= to; limbs = limbs * 11 / 10 + 1) {
+        std::pair<double, double> times = race(limbs, current, next(limbs));
+        double currentTime = times.first;
+        double nextTime = times.second;
+        std::cout << name << " " << limbs << " limbs: "
+                  << currentTime * 1e6 << " us vs " << nextTime * 1e6 << " us" << std::endl;
+        if (nextTime < currentTime) {
+            if (wins++ == 0) {
+                firstWin = limbs;
+            }
+            if (wins == ConfirmingSizes) {
+                return firstWin;
+            }
+        }
+        else {
+            wins = 0;
+        }
+    }
+    return fallback;
+}
+}
+
+int main() {
+    MultiplicationThresholds found = apmath::defaultMultiplicationThresholds();
+
+    found.karatsuba = findThreshold("karatsuba", 4, 400, found.karatsuba,
+        [](std::size_t limbs) { return MultiplicationThresholds{limbs, Never, Never}; },
+        MultiplicationThresholds{Never, Never, Never});
+    found.toom3 = findThreshold("toom3", found.karatsuba, 2000, found.toom3,
+        [&found](std::size_t limbs) { return MultiplicationThresholds{found.karatsuba, limbs, Never}; },
+        MultiplicationThresholds{found.karatsuba, Never, Never});
+    found.ntt = findThreshold("ntt", found.toom3, 50000, found.ntt,
+        [&found](std::size_t limbs) { return MultiplicationThresholds{found.karatsuba, found.toom3, limbs}; },
+        MultiplicationThresholds{found.karatsuba, found.toom3, Never});
+
+    std::cout << std::endl << "apmath::setMultiplicationThresholds({"
+              << found.karatsuba << ", " << found.toom3 << ", " << found.ntt << "});" << std::endl;
+    return 0;
+}